@@ -34,5 +34,12 @@
 #define ISR_PRIORITY_OS_TICK        99                          /* Define the timer interrupt priority              */
 #define ISR_PRIORITY_GETH_TX        100                         /* Define the Ethernet transmit interrupt priority  */
 #define ISR_PRIORITY_GETH_RX        101                         /* Define the Ethernet receive interrupt priority   */
+#define ISR_PRIORITY_GETH_RX1       102                         /* Ethernet receive interrupt priority, channel 1   */
+#define ISR_PRIORITY_GETH_RX2       103                         /* Ethernet receive interrupt priority, channel 2   */
+#define ISR_PRIORITY_GETH_RX3       104                         /* Ethernet receive interrupt priority, channel 3   */
+#define ISR_PRIORITY_GETH_TX1       105                         /* Ethernet transmit interrupt priority, channel 1  */
+#define ISR_PRIORITY_GETH_TX2       106                         /* Ethernet transmit interrupt priority, channel 2  */
+#define ISR_PRIORITY_GETH_TX3       107                         /* Ethernet transmit interrupt priority, channel 3  */
+#define ISR_PRIORITY_GETH_LINK      108                         /* Ethernet RGMII link status change (GETH SR0)     */
 
 #endif
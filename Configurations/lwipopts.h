@@ -37,19 +37,76 @@
 #define BOARDNAME               "AURIXTC397TFT"     /* Board name, also used as hostname                                    */
 
 #define MEM_ALIGNMENT           4                   /* Set memory alignment to 4 byte (32-bit machine)                      */
-#define MEM_SIZE                (25 * 1024)         /* Size of the Heap                                                     */
+#define IFX_LWIP_MTU            1500                /* IP packet size, up to 9000 for jumbo frames (all peers of the link)  */
+#define MEM_SIZE                ((IFX_LWIP_MTU > 1500) ? (60 * 1024) : (25 * 1024)) /* Size of the Heap, jumbo TCP segments */
 #define LWIP_DHCP               0                   /* Enable DHCP protocol                                                 */
 #define LWIP_NETCONN            0                   /* Disable Netconn API                                                  */
 #define LWIP_SOCKET             0                   /* Disable the Socket API                                               */
 #define SYS_LIGHTWEIGHT_PROT    0                   /* Disable inter-task protection                                        */
 
+#define TCP_MSS                 (IFX_LWIP_MTU - 40) /* Full sized frames, also required for segments of several MSS         */
+#define TCP_SND_BUF             ((IFX_LWIP_MTU > 1500) ? (4 * TCP_MSS) : (8 * TCP_MSS)) /* Send buffer of a TCP connection (< 64 KB) */
+#define MEMP_NUM_TCP_SEG        32                  /* At least TCP_SND_QUEUELEN                                            */
+#define MEMP_NUM_TCP_PCB        128                 /* Diagnostic and logging clients, TIME-WAIT pcbs included              */
+#define MEMP_NUM_TCP_PCB_LISTEN 16                  /* Listening services                                                   */
+#define TCP_PCB_HASH_SIZE       32                  /* Buckets of the active, TIME-WAIT and listening pcbs                  */
+#define TCP_TSO_MAX_SIZE        ((IFX_LWIP_MTU > 1500) ? (2 * TCP_MSS) : (4 * TCP_MSS)) /* Segments tcp_write() builds for a netif with NETIF_FLAG_TSO */
+#define PBUF_POOL_BUFSIZE       1536                /* One standard frame, jumbo frames are received into pbuf chains       */
+#define PBUF_POOL_SIZE          ((IFX_LWIP_MTU > 1500) ? 32 : 16) /* Pool pbufs, enough for the TCP window of jumbo frames     */
+
 
 #define ETH_PAD_SIZE            2                   /* Add 2 bytes before the Ethernet header to ensure payload alignment   */
 
+#define IFX_LWIP_NUM_CHANNELS       4               /* GETH DMA channels: control, multicast, unicast and bulk traffic      */
+#define IFX_LWIP_TX_DESCRIPTORS     128             /* Descriptors in each Tx ring, zero-copy frames need no buffer             */
+#define IFX_LWIP_TX_BUFFERS         16              /* Copy buffers of IFXGETH_MAX_TX_BUFFER_SIZE in each Tx ring (headers of TSO frames) */
+#define IFX_LWIP_RX_DESCRIPTORS     128             /* Descriptors in each Rx ring (a buffer of IFXGETH_MAX_RX_BUFFER_SIZE each) */
+#define IFXGETH_MAX_RX_BUFFER_SIZE  1024            /* Small frames take one Rx descriptor, full sized ones two             */
+
+#define LWIP_SUPPORT_CUSTOM_PBUF    1               /* Custom pbufs are used to pass GETH receive buffers to LwIP           */
+#define IFX_LWIP_RX_ZERO_COPY       1               /* Pass GETH receive buffers to LwIP without copying (0: copy to pool)  */
+#define IFX_LWIP_RX_SPARE_BUFFERS   32              /* Receive buffers used to re-arm descriptors while LwIP holds frames   */
+#define IFX_LWIP_TX_ZERO_COPY       1               /* Point one Tx descriptor at every pbuf segment (0: copy the frame)    */
+#define IFX_LWIP_RX_BUDGET          16              /* Maximum number of frames per channel and Ifx_Lwip_pollReceiveFlags() */
+#define IFX_LWIP_RX_COALESCE_TIME   100             /* Rx interrupt at most 100 us after a frame (GETH Rx watchdog)         */
+#define IFX_LWIP_RX_COALESCE_FRAMES 4               /* ... or after every 4th frame                                         */
+#define IFX_LWIP_RX_COALESCE_ADAPTIVE 1             /* Shorter watchdog while the traffic is sparse                         */
+#define IFX_LWIP_TX_COALESCE_FRAMES 4               /* Tx interrupt for every 4th frame                                     */
+#define IFX_LWIP_TX_QUEUE_LENGTH    8               /* Frames per channel queued while the Tx ring is full                  */
+#define LWIP_CHECKSUM_CTRL_PER_NETIF 1              /* Checksum generation of LwIP is switched per netif (Tx offload)       */
+#define IFX_LWIP_RX_CHECKSUM_OFFLOAD 1              /* Trust the Rx checksum status of the GETH                             */
+#define IFX_LWIP_TX_CHECKSUM_OFFLOAD 1              /* The GETH inserts the checksums of transmitted frames                 */
+#define IFX_LWIP_TX_TSO             1               /* Cut TCP segments of several MSS into frames in the driver            */
+#define IFX_LWIP_VLAN_TAG           0x000A          /* Frames of the default netif are sent on VLAN 10                      */
+#define IFX_LWIP_VLAN_NETIFS        2               /* Further netifs on other VLANs (ifx_netif_vlan_init())                */
+#define IFX_LWIP_MULTICORE          1               /* Rx channels 0..3 are served by CPU1..CPU4, LwIP itself runs on CPU0 */
+#define IFX_LWIP_RX_RING_SIZE       32              /* Frames queued from each Rx CPU to the LwIP CPU (power of 2)         */
+#define IFX_LWIP_DMA_MEMORY         IFX_LWIP_DMA_MEMORY_LMU /* Buffers in the cached LMU (656 KB of 768 KB), the driver maintains the data cache */
+#define IFX_LWIP_PTP                1               /* IEEE 1588 system time, every frame gets its GETH timestamp           */
+#define IFX_LWIP_GPTP               1               /* IEEE 802.1AS slave disciplines the GETH clock                        */
+#define IFX_LWIP_TX_CBS_CLASS_A_SLOPE 20000       /* kbit/s reserved for SR class A (priority 3), credit-based shaper     */
+#define IFX_LWIP_TX_CBS_CLASS_B_SLOPE 10000       /* kbit/s reserved for SR class B (priority 2), credit-based shaper     */
+#define LWIP_UDP_PRIORITY           1               /* udp_set_priority() selects the Tx queue of the datagrams of a pcb    */
+#define LWIP_PBUF_CUSTOM_DATA       u32_t ts_sec; u32_t ts_nsec; u8_t priority; u16_t chksum_checked; /* Rx/Tx timestamp (IFX_LWIP_PTP), Tx priority, Rx checksums verified by the GETH */
+#define LWIP_PBUF_CUSTOM_DATA_INIT(p) do { (p)->ts_sec = 0; (p)->ts_nsec = 0; (p)->priority = 0; (p)->chksum_checked = 0; } while (0)
+#define LWIP_PBUF_CUSTOM_DATA_COPY(dst, src) do { (dst)->ts_sec = (src)->ts_sec; (dst)->ts_nsec = (src)->ts_nsec; (dst)->priority = (src)->priority; (dst)->chksum_checked = (src)->chksum_checked; } while (0)
+#define LWIP_PBUF_CHECKSUM_CHECKED(p, chksumflag) (((p)->chksum_checked & (chksumflag)) != 0) /* LwIP skips the checks the GETH has done (IFX_LWIP_RX_CHECKSUM_OFFLOAD) */
+
 #define __LWIP_DEBUG__                              /* Enable debugging through UART interface                              */
 
 #define LWIP_NETIF_EXT_STATUS_CALLBACK  1           /* Enable an extended callback function for netif                       */
 
+#define ARP_TABLE_SIZE          256                 /* Peers of the gateway role                                            */
+#define ARP_TABLE_HASH_SIZE     64                  /* Buckets of the ARP table index by IP address                         */
+#define LWIP_NETIF_HWADDRHINT   1                   /* Every pcb remembers the ARP entry of its peer                        */
+#define MEMP_NUM_UDP_PCB        256                 /* Per-service and per-stream pcbs, udp_input() finds them by hash      */
+#define UDP_PCB_HASH_SIZE       64                  /* Buckets of the udp_pcbs by port                                      */
+#define SO_REUSE                1                   /* Several pcbs may bind the port of a multicast stream                 */
+#define SO_REUSE_RXTOALL        1                   /* A multicast datagram goes to all pcbs bound to its port              */
+#define SO_REUSE_RXTOALL_SHARED 1                   /* ...as the same read-only pbuf, see pbuf_unshare()                    */
+#define MEMP_NUM_IGMP_GROUP     257                 /* allsystems group plus the multicast streams joined                   */
+#define IGMP_GROUP_HASH_SIZE    64                  /* Buckets of the IGMP groups by group address                          */
+
 #ifdef __LWIP_DEBUG__
 #define LWIP_DEBUG                                  /* Enable LwIP debugging                                                */
 #endif
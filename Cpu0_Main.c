@@ -109,6 +109,7 @@ void core0_main (void)
     {
         Ifx_Lwip_pollTimerFlags();                          /* Poll LwIP timers and trigger protocols execution if required */
         Ifx_Lwip_pollReceiveFlags();                        /* Receive data package through ETH                             */
+        Ifx_Lwip_pollRxWorker();                            /* Rx channels served by this CPU (IFX_LWIP_MULTICORE)         */
     }
 }
 
@@ -27,6 +27,7 @@
 #include "Ifx_Types.h"
 #include "IfxCpu.h"
 #include "IfxScuWdt.h"
+#include "Ifx_Lwip.h"
 
 extern IfxCpu_syncEvent g_cpuSyncEvent;
 
@@ -45,5 +46,6 @@ void core1_main(void)
     
     while(1)
     {
+        Ifx_Lwip_pollRxWorker();
     }
 }
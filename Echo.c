@@ -210,10 +210,17 @@ void echoInit(void)
 
     if (err != ERR_OK) return;
 
-    g_ingroupsPcb = (struct udp_pcb *)memp_malloc(MEMP_UDP_PCB);
+    g_ingroupsPcb = udp_new();
     
     if(g_ingroupsPcb)
     {
+#if LWIP_UDP_PRIORITY
+        udp_set_priority(g_ingroupsPcb, 6);                         /* The replies go out in the control traffic class                                          */
+#endif
+#if SO_REUSE
+        ip_set_option(g_ingroupsPcb, SOF_REUSEADDR);                /* Other consumers of the stream may bind the port too, they share the received pbufs       */
+#endif
+
         #define MULTICAST_UDP_LOCAL_PORT    49155
 
         err = udp_bind(g_ingroupsPcb, IP_ADDR_ANY,MULTICAST_UDP_LOCAL_PORT);
@@ -98,16 +98,86 @@
 
 #define IFXGETH_PHY_RTL8211F_MDIO_EEELCR   0x11
 
+#define IFXGETH_PHY_RTL8211F_MDIO_RGMII_TXDLY 0x11   // page 0xd08
+
+#define IFXGETH_PHY_RTL8211F_MDIO_RGMII_RXDLY 0x15   // page 0xd08
+
+#define IFXGETH_PHY_RTL8211F_PAGE_STANDARD    0x0
+
+#define IFXGETH_PHY_RTL8211F_PAGE_PHYSR       0xa43
+
+#define IFXGETH_PHY_RTL8211F_PAGE_LED         0xd04
+
+#define IFXGETH_PHY_RTL8211F_PAGE_RGMII       0xd08
+
+#define IFXGETH_PHY_RTL8211F_BMCR_RESET       0x8000
+
+#define IFXGETH_PHY_RTL8211F_BMCR_ANEN        0x1000   // auto-negotiation enable
+
+#define IFXGETH_PHY_RTL8211F_BMCR_ANRESTART   0x0200   // restart auto-negotiation
+
+#define IFXGETH_PHY_RTL8211F_ANAR_SELECTOR    0x0001   // IEEE 802.3
+
+#define IFXGETH_PHY_RTL8211F_ANAR_10HD        0x0020
+
+#define IFXGETH_PHY_RTL8211F_ANAR_10FD        0x0040
+
+#define IFXGETH_PHY_RTL8211F_ANAR_100HD       0x0080
+
+#define IFXGETH_PHY_RTL8211F_ANAR_100FD       0x0100
+
+#define IFXGETH_PHY_RTL8211F_ANAR_PAUSE       0x0400
+
+#define IFXGETH_PHY_RTL8211F_GBCR_1000FD      0x0200
+
+#define IFXGETH_PHY_RTL8211F_GBCR_1000HD      0x0100
+
+#define IFXGETH_PHY_RTL8211F_TXDLY_ENABLE     0x0100
+
+#define IFXGETH_PHY_RTL8211F_RXDLY_ENABLE     0x0008
+
+#define IFXGETH_PHY_RTL8211F_PHYSR_LINK       0x0004
+
+#define IFXGETH_PHY_RTL8211F_PHYSR_DUPLEX     0x0008
+
+#define IFXGETH_PHY_RTL8211F_PHYSR_SPEED(x)   (((x) >> 4) & 0x3)   // 0: 10, 1: 100, 2: 1000 Mbit/s
+
 #define IFXGETH_PHY_RTL8211F_WAIT_MDIO_READY() while (GETH_MAC_MDIO_ADDRESS.B.GB) {}
 
 /******************************************************************************/
 /*--------------------------------Enumerations--------------------------------*/
 /******************************************************************************/
 
+/* kind of one MDIO access of a sequence */
+typedef enum
+{
+    IfxGeth_Eth_Phy_Rtl8211f_Access_write,     // write value
+    IfxGeth_Eth_Phy_Rtl8211f_Access_read,      // read, the result is kept in mdioValue
+    IfxGeth_Eth_Phy_Rtl8211f_Access_modify     // read, clear the bits of mask, set the bits of value and write back
+} IfxGeth_Eth_Phy_Rtl8211f_Access;
+
+/* what the MDIO state machine is doing */
+typedef enum
+{
+    IfxGeth_Eth_Phy_Rtl8211f_State_idle,
+    IfxGeth_Eth_Phy_Rtl8211f_State_reset,      // waiting for BMCR.RESET to clear
+    IfxGeth_Eth_Phy_Rtl8211f_State_config,     // configuration after the reset
+    IfxGeth_Eth_Phy_Rtl8211f_State_status      // reading PHYSR
+} IfxGeth_Eth_Phy_Rtl8211f_State;
+
 /******************************************************************************/
 /*-----------------------------Data Structures--------------------------------*/
 /******************************************************************************/
 
+/* one MDIO access of a sequence run by IfxGeth_Eth_Phy_Rtl8211f_process() */
+typedef struct
+{
+    uint8  access;      // IfxGeth_Eth_Phy_Rtl8211f_Access
+    uint8  regaddr;
+    uint16 mask;
+    uint16 value;
+} IfxGeth_Eth_Phy_Rtl8211f_MdioOp;
+
 /******************************************************************************/
 /*------------------------------Global variables------------------------------*/
 /******************************************************************************/
@@ -238,13 +308,59 @@ uint32 IfxGeth_Eth_Phy_Rtl8211f_iPhyInitDone = 0;
 /******************************************************************************/
 /*------------------------Private Variables/Constants-------------------------*/
 /******************************************************************************/
+static IfxGeth_Eth_Phy_Rtl8211f_State        phyState;
+static const IfxGeth_Eth_Phy_Rtl8211f_MdioOp *mdioSequence;       // sequence in progress
+static uint32                                 mdioCount;          // accesses in the sequence
+static uint32                                 mdioIndex;          // next access
+static boolean                                mdioReadPending;    // a read of mdioSequence[mdioIndex] is on its way
+static uint32                                 mdioValue;          // result of the last read
+static boolean                                statusRequested;    // read PHYSR as soon as the MDIO is free
+static uint32                                 phyStatus;          // PHYSR as last read
 #if defined(__GNUC__)
     #pragma section // end bss section
 #endif
 
+/* wait for the end of the reset */
+static const IfxGeth_Eth_Phy_Rtl8211f_MdioOp resetSequence[] = {
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_read,   IFXGETH_PHY_RTL8211F_MDIO_BMCR,        0, 0}
+};
+
+/* RGMII clock delays (the data lines are sampled 2ns after the clock edges), LEDs and
+ * advertisement: 10/100 Mbit/s half and full duplex with pause frames, 1000 Mbit/s full
+ * duplex (the GETH has no half duplex at 1000 Mbit/s), then restart the auto-negotiation */
+static const IfxGeth_Eth_Phy_Rtl8211f_MdioOp configSequence[] = {
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_write,  IFXGETH_PHY_RTL8211F_MDIO_PAGSR,       0, IFXGETH_PHY_RTL8211F_PAGE_RGMII},
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_modify, IFXGETH_PHY_RTL8211F_MDIO_RGMII_TXDLY, IFXGETH_PHY_RTL8211F_TXDLY_ENABLE,
+     IFXGETH_PHY_RTL8211F_TX_DELAY ? IFXGETH_PHY_RTL8211F_TXDLY_ENABLE : 0},
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_modify, IFXGETH_PHY_RTL8211F_MDIO_RGMII_RXDLY, IFXGETH_PHY_RTL8211F_RXDLY_ENABLE,
+     IFXGETH_PHY_RTL8211F_RX_DELAY ? IFXGETH_PHY_RTL8211F_RXDLY_ENABLE : 0},
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_write,  IFXGETH_PHY_RTL8211F_MDIO_PAGSR,       0, IFXGETH_PHY_RTL8211F_PAGE_LED},
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_write,  IFXGETH_PHY_RTL8211F_MDIO_LCR,         0, 0x8170},
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_write,  IFXGETH_PHY_RTL8211F_MDIO_EEELCR,      0, 0x0},      // EEE off for all leds
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_write,  IFXGETH_PHY_RTL8211F_MDIO_PAGSR,       0, IFXGETH_PHY_RTL8211F_PAGE_STANDARD},
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_write,  IFXGETH_PHY_RTL8211F_MDIO_ANAR,        0, IFXGETH_PHY_RTL8211F_ANAR_SELECTOR
+                                                                                       | IFXGETH_PHY_RTL8211F_ANAR_10HD | IFXGETH_PHY_RTL8211F_ANAR_10FD
+                                                                                       | IFXGETH_PHY_RTL8211F_ANAR_100HD | IFXGETH_PHY_RTL8211F_ANAR_100FD
+                                                                                       | IFXGETH_PHY_RTL8211F_ANAR_PAUSE},
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_modify, IFXGETH_PHY_RTL8211F_MDIO_GBCR,        IFXGETH_PHY_RTL8211F_GBCR_1000FD | IFXGETH_PHY_RTL8211F_GBCR_1000HD,
+     IFXGETH_PHY_RTL8211F_ADVERTISE_1000 ? IFXGETH_PHY_RTL8211F_GBCR_1000FD : 0},
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_write,  IFXGETH_PHY_RTL8211F_MDIO_BMCR,        0, IFXGETH_PHY_RTL8211F_BMCR_ANEN | IFXGETH_PHY_RTL8211F_BMCR_ANRESTART}
+};
+
+/* the resolved link state of the PHY, valid as soon as the link is up */
+static const IfxGeth_Eth_Phy_Rtl8211f_MdioOp statusSequence[] = {
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_write,  IFXGETH_PHY_RTL8211F_MDIO_PAGSR,       0, IFXGETH_PHY_RTL8211F_PAGE_PHYSR},
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_read,   IFXGETH_PHY_RTL8211F_MDIO_PHYSR,       0, 0},
+    {IfxGeth_Eth_Phy_Rtl8211f_Access_write,  IFXGETH_PHY_RTL8211F_MDIO_PAGSR,       0, IFXGETH_PHY_RTL8211F_PAGE_STANDARD}
+};
+
 /******************************************************************************/
 /*-------------------------Function Prototypes--------------------------------*/
 /******************************************************************************/
+static void    IfxGeth_Eth_Phy_Rtl8211f_startMdioRead(uint32 regaddr);
+static void    IfxGeth_Eth_Phy_Rtl8211f_startMdioWrite(uint32 regaddr, uint32 data);
+static void    IfxGeth_Eth_Phy_Rtl8211f_startSequence(IfxGeth_Eth_Phy_Rtl8211f_State state, const IfxGeth_Eth_Phy_Rtl8211f_MdioOp *sequence, uint32 count);
+static boolean IfxGeth_Eth_Phy_Rtl8211f_stepSequence(void);
 
 /******************************************************************************/
 /*-------------------------Function Implementations---------------------------*/
@@ -254,36 +370,171 @@ uint32 IfxGeth_Eth_Phy_Rtl8211f_init(void)
 {
     IFXGETH_PHY_RTL8211F_WAIT_MDIO_READY();
 
-    // reset PHY
-    IfxGeth_Eth_Phy_Rtl8211f_write_mdio_reg(0, IFXGETH_PHY_RTL8211F_MDIO_BMCR, 0x8000);   // reset
-    uint32 value;
+    // reset PHY, IfxGeth_Eth_Phy_Rtl8211f_process() waits for the end of the reset and sets it up
+    IfxGeth_Eth_Phy_Rtl8211f_iPhyInitDone = 0;
+    statusRequested                       = FALSE;
+    phyStatus                             = 0;
+    IfxGeth_Eth_Phy_Rtl8211f_startMdioWrite(IFXGETH_PHY_RTL8211F_MDIO_BMCR, IFXGETH_PHY_RTL8211F_BMCR_RESET);
+    IfxGeth_Eth_Phy_Rtl8211f_startSequence(IfxGeth_Eth_Phy_Rtl8211f_State_reset, resetSequence, sizeof(resetSequence) / sizeof(resetSequence[0]));
 
-    do
+    return 1;
+}
+
+
+uint32 IfxGeth_Eth_Phy_Rtl8211f_process(void)
+{
+    if (GETH_MAC_MDIO_ADDRESS.B.GB)
+    {
+        // the last access is still on its way
+        return 0;
+    }
+
+    if ((phyState != IfxGeth_Eth_Phy_Rtl8211f_State_idle) && (IfxGeth_Eth_Phy_Rtl8211f_stepSequence() == FALSE))
+    {
+        return 0;
+    }
+
+    switch (phyState)
+    {
+    case IfxGeth_Eth_Phy_Rtl8211f_State_reset:
+        if (mdioValue & IFXGETH_PHY_RTL8211F_BMCR_RESET)
+        {
+            // still in reset, read BMCR again
+            IfxGeth_Eth_Phy_Rtl8211f_startSequence(IfxGeth_Eth_Phy_Rtl8211f_State_reset, resetSequence, sizeof(resetSequence) / sizeof(resetSequence[0]));
+        }
+        else
+        {
+            IfxGeth_Eth_Phy_Rtl8211f_startSequence(IfxGeth_Eth_Phy_Rtl8211f_State_config, configSequence, sizeof(configSequence) / sizeof(configSequence[0]));
+        }
+
+        return 0;
+
+    case IfxGeth_Eth_Phy_Rtl8211f_State_config:
+        // done, the link comes up when the auto-negotiation has finished
+        IfxGeth_Eth_Phy_Rtl8211f_iPhyInitDone = 1;
+        phyState                              = IfxGeth_Eth_Phy_Rtl8211f_State_idle;
+        statusRequested                       = TRUE;
+        break;
+
+    case IfxGeth_Eth_Phy_Rtl8211f_State_status:
+        phyStatus = mdioValue;
+        phyState  = IfxGeth_Eth_Phy_Rtl8211f_State_idle;
+
+        return 1;
+
+    default:
+        break;
+    }
+
+    if (statusRequested && IfxGeth_Eth_Phy_Rtl8211f_iPhyInitDone)
     {
-        IfxGeth_Eth_Phy_Rtl8211f_read_mdio_reg(0, IFXGETH_PHY_RTL8211F_MDIO_BMCR, &value);
-    } while (value & 0x8000);                                                      // wait for reset to finish
-
-    // setup PHY
-    IfxGeth_Eth_Phy_Rtl8211f_write_mdio_reg(0, IFXGETH_PHY_RTL8211F_MDIO_PAGSR, 0xd08);
-    IfxGeth_Eth_Phy_Rtl8211f_read_mdio_reg(0, 0x11, &value);
-    value |= 0x100; // enable TX-delay
-    IfxGeth_Eth_Phy_Rtl8211f_write_mdio_reg(0, 0x11, value);
-    IfxGeth_Eth_Phy_Rtl8211f_write_mdio_reg(0, IFXGETH_PHY_RTL8211F_MDIO_PAGSR, 0x0);
-    /* Set LEDs */
-    IfxGeth_Eth_Phy_Rtl8211f_write_mdio_reg(0, IFXGETH_PHY_RTL8211F_MDIO_PAGSR, 0xd04);
-    IfxGeth_Eth_Phy_Rtl8211f_write_mdio_reg(0, IFXGETH_PHY_RTL8211F_MDIO_LCR, 0x8170);
-    IfxGeth_Eth_Phy_Rtl8211f_write_mdio_reg(0, IFXGETH_PHY_RTL8211F_MDIO_EEELCR, 0x0);   // EEE off for all leds
-    IfxGeth_Eth_Phy_Rtl8211f_write_mdio_reg(0, IFXGETH_PHY_RTL8211F_MDIO_PAGSR, 0x0);
-
-    IfxGeth_Eth_Phy_Rtl8211f_write_mdio_reg(0, IFXGETH_PHY_RTL8211F_MDIO_BMCR, 0x1200);    // enable auto-negotiation, restart auto-negotiation
-
-    // done
-    IfxGeth_Eth_Phy_Rtl8211f_iPhyInitDone = 1;
+        statusRequested = FALSE;
+        IfxGeth_Eth_Phy_Rtl8211f_startSequence(IfxGeth_Eth_Phy_Rtl8211f_State_status, statusSequence, sizeof(statusSequence) / sizeof(statusSequence[0]));
+    }
+
+    return 0;
+}
+
+
+void IfxGeth_Eth_Phy_Rtl8211f_requestLinkStatus(void)
+{
+    statusRequested = TRUE;
+}
+
+
+uint32 IfxGeth_Eth_Phy_Rtl8211f_getLinkStatus(IfxGeth_LineSpeed *speed, IfxGeth_DuplexMode *duplexMode)
+{
+    if ((phyStatus & IFXGETH_PHY_RTL8211F_PHYSR_LINK) == 0)
+    {
+        return 0;
+    }
+
+    switch (IFXGETH_PHY_RTL8211F_PHYSR_SPEED(phyStatus))
+    {
+    case 0:
+        *speed = IfxGeth_LineSpeed_10Mbps;
+        break;
+    case 1:
+        *speed = IfxGeth_LineSpeed_100Mbps;
+        break;
+    default:
+        *speed = IfxGeth_LineSpeed_1000Mbps;
+        break;
+    }
+
+    *duplexMode = (phyStatus & IFXGETH_PHY_RTL8211F_PHYSR_DUPLEX) ? IfxGeth_DuplexMode_fullDuplex : IfxGeth_DuplexMode_halfDuplex;
 
     return 1;
 }
 
 
+static void IfxGeth_Eth_Phy_Rtl8211f_startMdioRead(uint32 regaddr)
+{
+    // 5bit Physical Layer Adddress, 5bit GMII Regnr, 4bit csrclock divider, Read, Busy
+    GETH_MAC_MDIO_ADDRESS.U = (0 << 21) | (regaddr << 16) | (0 << 8) | (3 << 2) | (1 << 0);
+}
+
+
+static void IfxGeth_Eth_Phy_Rtl8211f_startMdioWrite(uint32 regaddr, uint32 data)
+{
+    GETH_MAC_MDIO_DATA.U    = data;
+    // 5bit Physical Layer Adddress, 5bit GMII Regnr, 4bit csrclock divider, Write, Busy
+    GETH_MAC_MDIO_ADDRESS.U = (0 << 21) | (regaddr << 16) | (0 << 8) | (1 << 2) | (1 << 0);
+}
+
+
+static void IfxGeth_Eth_Phy_Rtl8211f_startSequence(IfxGeth_Eth_Phy_Rtl8211f_State state, const IfxGeth_Eth_Phy_Rtl8211f_MdioOp *sequence, uint32 count)
+{
+    phyState        = state;
+    mdioSequence    = sequence;
+    mdioCount       = count;
+    mdioIndex       = 0;
+    mdioReadPending = FALSE;
+}
+
+
+/* starts the next access of the sequence, the MDIO has to be free. Returns TRUE when
+ * all accesses are done */
+static boolean IfxGeth_Eth_Phy_Rtl8211f_stepSequence(void)
+{
+    const IfxGeth_Eth_Phy_Rtl8211f_MdioOp *op;
+
+    if (mdioReadPending)
+    {
+        op              = &mdioSequence[mdioIndex];
+        mdioValue       = GETH_MAC_MDIO_DATA.U & 0xFFFF;
+        mdioReadPending = FALSE;
+        mdioIndex++;
+
+        if (op->access == IfxGeth_Eth_Phy_Rtl8211f_Access_modify)
+        {
+            IfxGeth_Eth_Phy_Rtl8211f_startMdioWrite(op->regaddr, (mdioValue & ~(uint32)op->mask) | op->value);
+            return FALSE;
+        }
+    }
+
+    if (mdioIndex >= mdioCount)
+    {
+        return TRUE;
+    }
+
+    op = &mdioSequence[mdioIndex];
+
+    if (op->access == IfxGeth_Eth_Phy_Rtl8211f_Access_write)
+    {
+        IfxGeth_Eth_Phy_Rtl8211f_startMdioWrite(op->regaddr, op->value);
+        mdioIndex++;
+    }
+    else
+    {
+        IfxGeth_Eth_Phy_Rtl8211f_startMdioRead(op->regaddr);
+        mdioReadPending = TRUE;
+    }
+
+    return FALSE;
+}
+
+
 void IfxGeth_Eth_Phy_Rtl8211f_read_mdio_reg(uint32 layeraddr, uint32 regaddr, uint32 *pdata)
 {
     // 5bit Physical Layer Adddress, 5bit GMII Regnr, 4bit csrclock divider, Read, Busy
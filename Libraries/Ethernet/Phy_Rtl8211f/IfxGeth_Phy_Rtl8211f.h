@@ -81,6 +81,18 @@
 /*-----------------------------------Macros-----------------------------------*/
 /******************************************************************************/
 
+#ifndef IFXGETH_PHY_RTL8211F_TX_DELAY
+#define IFXGETH_PHY_RTL8211F_TX_DELAY 1         // 1: the PHY delays the RGMII TXC by 2ns (0: the delay is on the board or in the GETH)
+#endif
+
+#ifndef IFXGETH_PHY_RTL8211F_RX_DELAY
+#define IFXGETH_PHY_RTL8211F_RX_DELAY 1         // 1: the PHY delays the RGMII RXC by 2ns
+#endif
+
+#ifndef IFXGETH_PHY_RTL8211F_ADVERTISE_1000
+#define IFXGETH_PHY_RTL8211F_ADVERTISE_1000 1   // 1: advertise 1000BASE-T full duplex, 0: 10/100 Mbit/s only
+#endif
+
 /******************************************************************************/
 /*--------------------------------Enumerations--------------------------------*/
 /******************************************************************************/
@@ -97,7 +109,16 @@ IFX_EXTERN uint32 IfxGeth_Eth_Phy_Rtl8211f_iPhyInitDone;
 /******************************************************************************/
 /*-------------------------Function Prototypes--------------------------------*/
 /******************************************************************************/
+/* The PHY is set up without waiting: IfxGeth_Eth_Phy_Rtl8211f_init() starts the reset,
+ * IfxGeth_Eth_Phy_Rtl8211f_process() (called from the main loop) runs the MDIO accesses one
+ * after the other and returns 1 when a link status requested by
+ * IfxGeth_Eth_Phy_Rtl8211f_requestLinkStatus() has been read. The blocking
+ * read/write functions must not be used while the PHY is being set up or a request is
+ * pending. */
 IFX_EXTERN uint32 IfxGeth_Eth_Phy_Rtl8211f_init(void);
+IFX_EXTERN uint32 IfxGeth_Eth_Phy_Rtl8211f_process(void);
+IFX_EXTERN void IfxGeth_Eth_Phy_Rtl8211f_requestLinkStatus(void);
+IFX_EXTERN uint32 IfxGeth_Eth_Phy_Rtl8211f_getLinkStatus(IfxGeth_LineSpeed *speed, IfxGeth_DuplexMode *duplexMode);
 IFX_EXTERN void IfxGeth_Eth_Phy_Rtl8211f_read_mdio_reg(uint32 layeraddr, uint32 regaddr, uint32 *pdata);
 IFX_EXTERN void IfxGeth_Eth_Phy_Rtl8211f_write_mdio_reg(uint32 layeraddr, uint32 regaddr, uint32 data);
 
@@ -0,0 +1,102 @@
+/**
+ * \file Ifx_Gptp.h
+ * \brief IEEE 802.1AS (gPTP) slave disciplining the system time of the GETH
+ *
+ * \copyright Copyright (c) 2019 Infineon Technologies AG. All rights reserved.
+ *
+ *
+ *
+ *                                 IMPORTANT NOTICE
+ *
+ *
+ * Use of this file is subject to the terms of use agreed between (i) you or
+ * the company in which ordinary course of business you are acting and (ii)
+ * Infineon Technologies AG or its licensees. If and as long as no such
+ * terms of use are agreed, use of this file is subject to following:
+
+
+ * Boost Software License - Version 1.0 - August 17th, 2003
+
+ * Permission is hereby granted, free of charge, to any person or
+ * organization obtaining a copy of the software and accompanying
+ * documentation covered by this license (the "Software") to use, reproduce,
+ * display, distribute, execute, and transmit the Software, and to prepare
+ * derivative works of the Software, and to permit third-parties to whom the
+ * Software is furnished to do so, all subject to the following:
+
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer, must
+ * be included in all copies of the Software, in whole or in part, and all
+ * derivative works of the Software, unless such copies or derivative works are
+ * solely in the form of machine-executable object code generated by a source
+ * language processor.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+
+ *
+ */
+
+#ifndef IFX_GPTP_H
+#define IFX_GPTP_H
+
+//________________________________________________________________________________________
+// INCLUDES
+
+#include "Ifx_Lwip.h"
+
+//________________________________________________________________________________________
+// MACROS
+
+/** \brief Period of Ifx_Gptp_timer() in ms */
+#define IFX_GPTP_TMR_INTERVAL 10U
+
+//________________________________________________________________________________________
+// DATA STRUCTURES
+
+/** \brief State of the 802.1AS slave, see Ifx_Gptp_getStatus() */
+typedef struct
+{
+    boolean asCapable;          /**< \brief the neighbour answers the peer delay requests */
+    boolean synchronized;       /**< \brief the last offset from the master has been below 1 us */
+    uint8   master[10];         /**< \brief port identity (clock identity, port number) of the master the clock follows */
+    sint64  offset;             /**< \brief last offset of the system time from the master in ns (local - master) */
+    sint64  meanLinkDelay;      /**< \brief propagation delay to the neighbour in ns */
+    sint32  frequency;          /**< \brief frequency adjustment of the system time in ppb */
+    uint32  syncCount;          /**< \brief Sync / Follow_Up pairs the servo has used */
+    uint32  stepCount;          /**< \brief times the system time has been stepped */
+    uint32  pdelayCount;        /**< \brief completed peer delay measurements */
+} Ifx_Gptp_Status;
+
+//________________________________________________________________________________________
+// FUNCTION PROTOTYPES
+
+/** \addtogroup lib_lwIP
+ * \{ */
+
+/** \brief Starts the slave on the default netif, after Ifx_Lwip_init() has added it
+ *
+ * The clock identity is derived from the MAC address, the netif subscribes to the
+ * 802.1AS address 01:80:C2:00:00:0E.
+ * \param netif the default netif (on the GETH with IFX_LWIP_PTP) */
+IFX_EXTERN void Ifx_Gptp_init(netif_t *netif);
+
+/** \brief Handles a received 802.1AS message (Ethernet type 0x88F7), called by the netif
+ * \param netif the netif which has received it
+ * \param p the frame including the Ethernet header, released here */
+IFX_EXTERN void Ifx_Gptp_input(netif_t *netif, pbuf_t *p);
+
+/** \brief Sends the peer delay requests and the follow ups of the sent messages, every IFX_GPTP_TMR_INTERVAL ms */
+IFX_EXTERN void Ifx_Gptp_timer(void);
+
+/** \brief Returns the state of the slave */
+IFX_EXTERN const Ifx_Gptp_Status *Ifx_Gptp_getStatus(void);
+
+/** \} */
+
+#endif /* IFX_GPTP_H */
@@ -110,9 +110,13 @@ typedef struct
         uint16 tcp_fast;
         uint16 tcp_slow;
         uint16 link;
+#if IFX_LWIP_GPTP
+        uint16 gptp;
+#endif
     }               timer;
 
     volatile uint16 timerFlags;
+    volatile uint16 ethFlags;       /* events signalled by the GETH interrupts, handled by Ifx_Lwip_pollReceiveFlags() */
 } Ifx_Lwip;
 
 /** \brief Configuration structure for the AURIX LWIP stack */
@@ -125,16 +129,279 @@ typedef struct
 } Ifx_Lwip_Config;
 
 #define IFXGETH_HEADER_LENGTH 14 // words
-#define IFXGETH_MAX_TX_BUFFER_SIZE (2560+IFXGETH_HEADER_LENGTH+2) // bytes
-#define IFXGETH_MAX_RX_BUFFER_SIZE (2560+IFXGETH_HEADER_LENGTH+2) // bytes
+
+#ifndef IFX_LWIP_MTU
+#define IFX_LWIP_MTU 1500 // bytes, IP packet size of the netifs, up to 9000 (jumbo frames)
+#endif
+
+#if (IFX_LWIP_MTU < 576) || (IFX_LWIP_MTU > 9000)
+#error "IFX_LWIP_MTU has to be 576..9000"
+#endif
+
+/* longest frame on the wire: Ethernet header, VLAN tag and CRC around one MTU */
+#define IFX_LWIP_MAX_FRAME_SIZE (IFX_LWIP_MTU + 22)
+
+#ifndef IFXGETH_MAX_TX_BUFFER_SIZE
+#define IFXGETH_MAX_TX_BUFFER_SIZE 1536 // bytes, one standard frame, longer frames span several descriptors
+#endif
+
+#ifndef IFXGETH_MAX_RX_BUFFER_SIZE
+#define IFXGETH_MAX_RX_BUFFER_SIZE 1536 // bytes, one standard frame (incl. VLAN tag and CRC), longer frames span several descriptors
+#endif
+
+/* where the linker places the descriptors and buffers of the GETH */
+#define IFX_LWIP_DMA_MEMORY_DSPR   0 // DSPR of CPU_WHICH_SERVICE_ETHERNET, not cached
+#define IFX_LWIP_DMA_MEMORY_LMU_NC 1 // LMU, section "lmubss_dma_nc" in the non-cached mirror
+#define IFX_LWIP_DMA_MEMORY_LMU    2 // buffers in the cached LMU (section "lmubss_dma"), descriptors in "lmubss_dma_nc"
+
+#ifndef IFX_LWIP_DMA_MEMORY
+#define IFX_LWIP_DMA_MEMORY IFX_LWIP_DMA_MEMORY_DSPR
+#endif
+
+#ifndef IFX_LWIP_DMA_CACHE_MAINTENANCE
+#define IFX_LWIP_DMA_CACHE_MAINTENANCE (IFX_LWIP_DMA_MEMORY == IFX_LWIP_DMA_MEMORY_LMU) // 1: write back / invalidate the cached lines of what the DMA reads or writes, also of zero-copy pbufs
+#endif
+
+/* data cache line of the TriCore, the DMA buffers are aligned to it and consist of whole lines */
+#define IFX_LWIP_CACHE_LINE_SIZE 32U
+#define IFX_LWIP_DMA_ALIGN       IFX_ALIGN(32)
+
+#if ((IFXGETH_MAX_TX_BUFFER_SIZE % IFX_LWIP_CACHE_LINE_SIZE) != 0) || ((IFXGETH_MAX_RX_BUFFER_SIZE % IFX_LWIP_CACHE_LINE_SIZE) != 0)
+#error "IFXGETH_MAX_TX_BUFFER_SIZE and IFXGETH_MAX_RX_BUFFER_SIZE have to be multiples of IFX_LWIP_CACHE_LINE_SIZE"
+#endif
+
+#ifndef IFX_LWIP_NUM_CHANNELS
+#define IFX_LWIP_NUM_CHANNELS 1 // GETH Tx/Rx DMA channels (and MTL queues) in use, 1 or 4
+#endif
+
+#if (IFX_LWIP_NUM_CHANNELS != 1) && (IFX_LWIP_NUM_CHANNELS != 4)
+#error "IFX_LWIP_NUM_CHANNELS has to be 1 or 4"
+#endif
+
+#ifndef IFX_LWIP_TX_DESCRIPTORS
+#define IFX_LWIP_TX_DESCRIPTORS IFXGETH_MAX_TX_DESCRIPTORS // descriptors in the Tx ring of each channel
+#endif
+
+#ifndef IFX_LWIP_RX_DESCRIPTORS
+#define IFX_LWIP_RX_DESCRIPTORS IFXGETH_MAX_RX_DESCRIPTORS // descriptors in the Rx ring of each channel
+#endif
+
+#ifndef IFX_LWIP_TX_BUFFERS
+#define IFX_LWIP_TX_BUFFERS IFX_LWIP_TX_DESCRIPTORS // copy buffers of each Tx channel, descriptor i copies into buffer i % IFX_LWIP_TX_BUFFERS
+#endif
+
+#if ((IFX_LWIP_TX_DESCRIPTORS % IFX_LWIP_TX_BUFFERS) != 0)
+#error "IFX_LWIP_TX_BUFFERS has to divide IFX_LWIP_TX_DESCRIPTORS"
+#endif
+
+#ifndef IFX_LWIP_RX_ZERO_COPY
+#define IFX_LWIP_RX_ZERO_COPY 0 // copy received frames into PBUF_POOL pbufs
+#endif
+
+#ifndef IFX_LWIP_TX_ZERO_COPY
+#define IFX_LWIP_TX_ZERO_COPY 0 // copy every frame into the channelTxBuffer1 rows of its descriptors
+#endif
+
+#ifndef IFX_LWIP_RX_BUDGET
+#define IFX_LWIP_RX_BUDGET 16 // frames per channel and Ifx_Lwip_pollReceiveFlags() call
+#endif
+
+#ifndef IFX_LWIP_RX_COALESCE_TIME
+#define IFX_LWIP_RX_COALESCE_TIME 0 // us, Rx interrupt watchdog (RIWT) for the descriptors without IOC, 0: no watchdog
+#endif
+
+#ifndef IFX_LWIP_RX_COALESCE_FRAMES
+#define IFX_LWIP_RX_COALESCE_FRAMES 1 // IOC on every Nth Rx descriptor, the watchdog signals the frames in between
+#endif
+
+#ifndef IFX_LWIP_RX_COALESCE_ADAPTIVE
+#define IFX_LWIP_RX_COALESCE_ADAPTIVE 0 // 1: shorten the watchdog while the interrupts bring single frames
+#endif
+
+#if (IFX_LWIP_RX_COALESCE_FRAMES > 1) && (IFX_LWIP_RX_COALESCE_TIME == 0)
+#error "IFX_LWIP_RX_COALESCE_FRAMES requires IFX_LWIP_RX_COALESCE_TIME"
+#endif
+
+#ifndef IFX_LWIP_TX_COALESCE_FRAMES
+#define IFX_LWIP_TX_COALESCE_FRAMES 1 // IOC on every Nth transmitted frame
+#endif
+
+#ifndef IFX_LWIP_TX_QUEUE_LENGTH
+#define IFX_LWIP_TX_QUEUE_LENGTH 0 // frames per channel waiting for Tx descriptors, 0: a full ring refuses the frame (ERR_WOULDBLOCK)
+#endif
+
+#ifndef IFX_LWIP_RX_CHECKSUM_OFFLOAD
+#define IFX_LWIP_RX_CHECKSUM_OFFLOAD 0 // 1: the GETH verifies the IPv4/TCP/UDP/ICMP checksums, LwIP only checks what it has left out (pbuf chksum_checked, LWIP_PBUF_CUSTOM_DATA)
+#endif
+
+#ifndef IFX_LWIP_TX_CHECKSUM_OFFLOAD
+#define IFX_LWIP_TX_CHECKSUM_OFFLOAD 0 // 1: the GETH inserts the IPv4/TCP/UDP/ICMP checksums, LwIP leaves the fields zero
+#endif
+
+#if IFX_LWIP_TX_CHECKSUM_OFFLOAD && !LWIP_CHECKSUM_CTRL_PER_NETIF
+#error "IFX_LWIP_TX_CHECKSUM_OFFLOAD requires LWIP_CHECKSUM_CTRL_PER_NETIF"
+#endif
+
+#ifndef IFX_LWIP_TX_TSO
+#define IFX_LWIP_TX_TSO 0 // 1: LwIP passes TCP segments of up to TCP_TSO_MAX_SIZE, the driver cuts them into frames
+#endif
+
+#if IFX_LWIP_TX_TSO && (!IFX_LWIP_TX_CHECKSUM_OFFLOAD || !TCP_TSO_MAX_SIZE)
+#error "IFX_LWIP_TX_TSO requires IFX_LWIP_TX_CHECKSUM_OFFLOAD and TCP_TSO_MAX_SIZE"
+#endif
+
+#ifndef IFX_LWIP_VLAN_TAG
+#define IFX_LWIP_VLAN_TAG 0 // VLAN tag (priority, DEI, VLAN ID) the GETH inserts into the frames of the default netif, 0: untagged
+#endif
+
+#ifndef IFX_LWIP_VLAN_NETIFS
+#define IFX_LWIP_VLAN_NETIFS 0 // netifs on further VLANs (ifx_netif_vlan_init()), the GETH inserts and strips their tags
+#endif
+
+#ifndef IFX_LWIP_PTP
+#define IFX_LWIP_PTP 0 // 1: the GETH runs the IEEE 1588 system time and timestamps the frames (pbuf ts_sec/ts_nsec, LWIP_PBUF_CUSTOM_DATA)
+#endif
+
+#ifndef IFX_LWIP_PTP_RX_ALL
+#define IFX_LWIP_PTP_RX_ALL 1 // 1: every received frame is timestamped (takes a second Rx descriptor), 0: only the PTP event messages
+#endif
+
+#ifndef IFX_LWIP_GPTP
+#define IFX_LWIP_GPTP 0 // 1: an IEEE 802.1AS slave (Ifx_Gptp) disciplines the system time of the GETH
+#endif
+
+#if IFX_LWIP_GPTP && !IFX_LWIP_PTP
+#error "IFX_LWIP_GPTP requires IFX_LWIP_PTP"
+#endif
+
+#ifndef IFX_LWIP_MULTICORE
+#define IFX_LWIP_MULTICORE 0 // 1: every Rx channel is served by its own CPU (IFX_LWIP_RX_CHANNELn_CPU), LwIP stays on CPU_WHICH_SERVICE_ETHERNET
+#endif
+
+#ifndef IFX_LWIP_RX_RING_SIZE
+#define IFX_LWIP_RX_RING_SIZE 16 // frames in flight from one Rx CPU to the LwIP CPU, power of 2
+#endif
+
+#if IFX_LWIP_MULTICORE
+#if !IFX_LWIP_RX_ZERO_COPY
+#error "IFX_LWIP_MULTICORE requires IFX_LWIP_RX_ZERO_COPY, the pbuf pools belong to the LwIP CPU"
+#endif
+/* CPU serving each Rx DMA channel, plain numbers as they select the interrupt vector table */
+#ifndef IFX_LWIP_RX_CHANNEL0_CPU
+#define IFX_LWIP_RX_CHANNEL0_CPU 1
+#endif
+#ifndef IFX_LWIP_RX_CHANNEL1_CPU
+#define IFX_LWIP_RX_CHANNEL1_CPU 2
+#endif
+#ifndef IFX_LWIP_RX_CHANNEL2_CPU
+#define IFX_LWIP_RX_CHANNEL2_CPU 3
+#endif
+#ifndef IFX_LWIP_RX_CHANNEL3_CPU
+#define IFX_LWIP_RX_CHANNEL3_CPU 4
+#endif
+#else
+#define IFX_LWIP_RX_CHANNEL0_CPU CPU_WHICH_SERVICE_ETHERNET
+#define IFX_LWIP_RX_CHANNEL1_CPU CPU_WHICH_SERVICE_ETHERNET
+#define IFX_LWIP_RX_CHANNEL2_CPU CPU_WHICH_SERVICE_ETHERNET
+#define IFX_LWIP_RX_CHANNEL3_CPU CPU_WHICH_SERVICE_ETHERNET
+#endif
+
+#ifndef IFX_LWIP_RX_SPARE_BUFFERS
+#define IFX_LWIP_RX_SPARE_BUFFERS 8 // buffers
+#endif
+
+#if IFX_LWIP_RX_ZERO_COPY
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "IFX_LWIP_RX_ZERO_COPY requires LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+/* descriptors own IFX_LWIP_RX_DESCRIPTORS buffers per channel, the spare ones (shared by all channels) re-arm descriptors while LwIP holds a frame */
+#define IFX_LWIP_RX_BUFFER_COUNT ((IFX_LWIP_NUM_CHANNELS*IFX_LWIP_RX_DESCRIPTORS)+IFX_LWIP_RX_SPARE_BUFFERS)
+/* bytes in front of the DMA buffer, used for the ETH_PAD_SIZE padding of the pbuf (keeps the DMA address word aligned) */
+#define IFX_LWIP_RX_HEADROOM LWIP_MEM_ALIGN_SIZE(ETH_PAD_SIZE)
+#else
+#define IFX_LWIP_RX_BUFFER_COUNT (IFX_LWIP_NUM_CHANNELS*IFX_LWIP_RX_DESCRIPTORS)
+#define IFX_LWIP_RX_HEADROOM 0
+#endif
+
+/* a frame has to fit into the ring in one piece (the DMA waits for the descriptors otherwise),
+ * besides the context descriptor of its timestamp */
+#if ((IFX_LWIP_RX_DESCRIPTORS - 1) * (IFXGETH_MAX_RX_BUFFER_SIZE - IFX_LWIP_RX_HEADROOM)) < IFX_LWIP_MAX_FRAME_SIZE
+#error "IFX_LWIP_RX_DESCRIPTORS too small for a frame of IFX_LWIP_MTU bytes"
+#endif
+
+/* a copied frame takes a buffer per IFXGETH_MAX_TX_BUFFER_SIZE bytes, besides the unused descriptor and a VLAN context descriptor */
+#if ((IFX_LWIP_TX_DESCRIPTORS - 2) * IFXGETH_MAX_TX_BUFFER_SIZE) < IFX_LWIP_MAX_FRAME_SIZE
+#error "IFX_LWIP_TX_DESCRIPTORS too small for a frame of IFX_LWIP_MTU bytes"
+#endif
+
+/* ... and all descriptors in flight have to fit into the copy buffers then, the VLAN context descriptor included */
+#if ((IFX_LWIP_TX_BUFFERS - 1) * IFXGETH_MAX_TX_BUFFER_SIZE) < IFX_LWIP_MAX_FRAME_SIZE
+#error "IFX_LWIP_TX_BUFFERS too small for a frame of IFX_LWIP_MTU bytes"
+#endif
+
+/* bytes of the descriptors (16 each) and buffers of all channels */
+#define IFX_LWIP_DMA_MEMORY_SIZE ((16UL * IFX_LWIP_NUM_CHANNELS * (IFX_LWIP_TX_DESCRIPTORS + IFX_LWIP_RX_DESCRIPTORS)) + \
+                                  (1UL * IFX_LWIP_NUM_CHANNELS * IFX_LWIP_TX_BUFFERS * IFXGETH_MAX_TX_BUFFER_SIZE) + \
+                                  (1UL * IFX_LWIP_RX_BUFFER_COUNT * IFXGETH_MAX_RX_BUFFER_SIZE))
+
+/* LMU of the TC39x (lmuram in the linker files), shared with the other LMU data of the application */
+#define IFX_LWIP_LMU_SIZE (768UL * 1024UL)
+
+#if (IFX_LWIP_DMA_MEMORY != IFX_LWIP_DMA_MEMORY_DSPR) && (IFX_LWIP_DMA_MEMORY_SIZE > IFX_LWIP_LMU_SIZE)
+#error "the GETH descriptors and buffers don't fit into the LMU, reduce the ring depths or IFXGETH_MAX_RX_BUFFER_SIZE"
+#endif
+
+/* traffic classes of the Rx DMA channels. The channel number is also the Rx queue number,
+ * queue 0 has the highest priority in the Rx arbitration and is drained first */
+#if IFX_LWIP_NUM_CHANNELS > 1
+#define IFX_LWIP_CHANNEL_CONTROL   0 // VLAN user priority 4..7
+#define IFX_LWIP_CHANNEL_MULTICAST 1 // multicast and broadcast
+#define IFX_LWIP_CHANNEL_UNICAST   2 // untagged unicast
+#define IFX_LWIP_CHANNEL_BULK      3 // VLAN user priority 0..3
+#else
+#define IFX_LWIP_CHANNEL_CONTROL   0
+#define IFX_LWIP_CHANNEL_MULTICAST 0
+#define IFX_LWIP_CHANNEL_UNICAST   0
+#define IFX_LWIP_CHANNEL_BULK      0
+#endif
+
+/* traffic classes of the Tx DMA channels, by the priority of the frame (udp_set_priority(),
+ * otherwise the IP precedence). The channel number is also the Tx queue number, the queues
+ * are served by strict priority with the highest queue first */
+#if IFX_LWIP_NUM_CHANNELS > 1
+#define IFX_LWIP_TX_CHANNEL_BEST_EFFORT 0 // priority 0..1
+#define IFX_LWIP_TX_CHANNEL_STREAM_B    1 // priority 2, SR class B (IEEE 802.1BA)
+#define IFX_LWIP_TX_CHANNEL_STREAM_A    2 // priority 3, SR class A
+#define IFX_LWIP_TX_CHANNEL_CONTROL     3 // priority 4..7 and PTP
+#else
+#define IFX_LWIP_TX_CHANNEL_BEST_EFFORT 0
+#define IFX_LWIP_TX_CHANNEL_STREAM_B    0
+#define IFX_LWIP_TX_CHANNEL_STREAM_A    0
+#define IFX_LWIP_TX_CHANNEL_CONTROL     0
+#endif
+
+#ifndef IFX_LWIP_TX_CBS_CLASS_A_SLOPE
+#define IFX_LWIP_TX_CBS_CLASS_A_SLOPE 0 // kbit/s reserved for SR class A (idleSlope of the credit-based shaper, IEEE 802.1Qav), 0: no shaper
+#endif
+
+#ifndef IFX_LWIP_TX_CBS_CLASS_B_SLOPE
+#define IFX_LWIP_TX_CBS_CLASS_B_SLOPE 0 // kbit/s reserved for SR class B, 0: no shaper
+#endif
+
+#if ((IFX_LWIP_TX_CBS_CLASS_A_SLOPE > 0) || (IFX_LWIP_TX_CBS_CLASS_B_SLOPE > 0)) && (IFX_LWIP_NUM_CHANNELS == 1)
+#error "IFX_LWIP_TX_CBS_CLASS_A_SLOPE / IFX_LWIP_TX_CBS_CLASS_B_SLOPE require IFX_LWIP_NUM_CHANNELS 4"
+#endif
 
 //________________________________________________________________________________________
 // GLOBAL VARIABLES
 IFX_EXTERN volatile uint32 g_TickCount_1ms;
 IFX_EXTERN Ifx_Lwip g_Lwip;
 IFX_EXTERN IfxGeth_Eth g_IfxGeth;
-IFX_EXTERN uint8 channel0TxBuffer1[IFXGETH_MAX_TX_DESCRIPTORS][IFXGETH_MAX_TX_BUFFER_SIZE];
-IFX_EXTERN uint8 channel0RxBuffer1[IFXGETH_MAX_RX_DESCRIPTORS][IFXGETH_MAX_RX_BUFFER_SIZE];
+/* DMA memory, placed by IFX_LWIP_DMA_MEMORY */
+IFX_EXTERN IfxGeth_TxDescr channelTxDescr[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_TX_DESCRIPTORS];
+IFX_EXTERN IfxGeth_RxDescr channelRxDescr[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_RX_DESCRIPTORS];
+IFX_EXTERN uint8 channelTxBuffer1[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_TX_BUFFERS][IFXGETH_MAX_TX_BUFFER_SIZE];
+IFX_EXTERN uint8 channelRxBuffer1[IFX_LWIP_RX_BUFFER_COUNT][IFXGETH_MAX_RX_BUFFER_SIZE];
 
 //________________________________________________________________________________________
 // FUNCTION PROTOTYPES
@@ -145,6 +412,12 @@ IFX_EXTERN void     Ifx_Lwip_init(eth_addr_t ethAddr);
 IFX_EXTERN void     Ifx_Lwip_onTimerTick(void);
 IFX_EXTERN void     Ifx_Lwip_pollTimerFlags(void);
 IFX_EXTERN void     Ifx_Lwip_pollReceiveFlags(void);
+IFX_EXTERN void     Ifx_Lwip_pollRxWorker(void);
+#if IFX_LWIP_VLAN_NETIFS > 0
+IFX_EXTERN err_t    Ifx_Lwip_addVlanNetif(netif_t *netif, const u16_t *vlanTag, const ip_addr_t *ipAddr, const ip_addr_t *netMask, const ip_addr_t *gateway);
+#endif
+IFX_INLINE void     Ifx_Lwip_dmaFlush(const void *data, uint32 length);
+IFX_INLINE void     Ifx_Lwip_dmaInvalidate(void *data, uint32 length);
 IFX_INLINE netif_t *Ifx_Lwip_getNetIf(void);
 IFX_INLINE uint8   *Ifx_Lwip_getIpAddrPtr(void);
 IFX_INLINE uint8   *Ifx_Lwip_getHwAddrPtr(void);
@@ -156,6 +429,71 @@ IFX_INLINE IfxGeth_Eth *IfxGeth_get(void);
 //________________________________________________________________________________________
 // INLINE FUNCTION IMPLEMENTATIONS
 
+/** \brief Writes the cached lines of a buffer back before the DMA reads it
+ *
+ * Only the cached segment 0x9 (LMU, DLMU) is concerned, the DSPR and the non-cached
+ * mirrors are seen by the DMA as they are. The lines are invalidated as well.
+ * \param data start of the buffer
+ * \param length number of bytes, the lines around them are written back */
+IFX_INLINE void Ifx_Lwip_dmaFlush(const void *data, uint32 length)
+{
+#if IFX_LWIP_DMA_CACHE_MAINTENANCE
+    uint32 addr = (uint32)data;
+    uint32 end  = addr + length;
+
+    if (((addr >> 28) == 0x9U) && (length > 0))
+    {
+        for (addr &= ~(IFX_LWIP_CACHE_LINE_SIZE - 1U); addr < end; addr += IFX_LWIP_CACHE_LINE_SIZE)
+        {
+            __cacheawi((uint8 *)addr);
+        }
+
+        /* the write-backs are done before the DMA is started */
+        __dsync();
+    }
+#else
+    (void)data;
+    (void)length;
+#endif
+}
+
+
+/** \brief Invalidates the cached lines of a buffer the DMA has written
+ *
+ * Called before the CPU reads what the DMA has written, on the CPU which reads it.
+ * CACHEA.I drops the lines without writing them back, also dirty ones: the lines of
+ * the frame must not be written back over it. A buffer handed to the DMA goes through
+ * Ifx_Lwip_dmaFlush() instead, on the CPU which has written into it. The buffer has
+ * to consist of whole lines (IFX_LWIP_DMA_ALIGN).
+ * \param data start of the buffer
+ * \param length number of bytes, the lines around them are invalidated */
+IFX_INLINE void Ifx_Lwip_dmaInvalidate(void *data, uint32 length)
+{
+#if IFX_LWIP_DMA_CACHE_MAINTENANCE
+    uint32 addr = (uint32)data;
+    uint32 end  = addr + length;
+
+    if (((addr >> 28) == 0x9U) && (length > 0))
+    {
+        for (addr &= ~(IFX_LWIP_CACHE_LINE_SIZE - 1U); addr < end; addr += IFX_LWIP_CACHE_LINE_SIZE)
+        {
+#if defined(__TASKING__)
+            __asm("cachea.i [%0]0" : : "a" (addr));
+#else
+            __cacheai((uint8 *)addr);
+#endif
+        }
+
+        /* no load of the buffer before the lines are gone */
+        __dsync();
+    }
+#else
+    (void)data;
+    (void)length;
+#endif
+}
+
+
 /** \brief Returns pointer to the default network interface */
 IFX_INLINE netif_t *Ifx_Lwip_getNetIf(void)
 {
@@ -45,7 +45,68 @@
 #ifndef IFX_LWIP_NETIF_H
 #define IFX_LWIP_NETIF_H
 
-err_t ifx_netif_init(struct netif *netif);
-err_t ifx_netif_input(struct netif *netif);
+/* pbuf flag for frames passed to netif->linkoutput which already carry their checksums,
+ * or must not be touched at all: the GETH sends them without checksum insertion */
+#define IFX_NETIF_PBUF_FLAG_TX_RAW 0x40U
+
+#if IFX_LWIP_PTP
+/* pbuf flag requesting the transmit timestamp of a frame, on any pbuf of the chain the sender keeps
+ * referenced: when the frame has been sent, the driver writes the timestamp into ts_sec/ts_nsec of
+ * that pbuf and clears the flag (ifx_netif_get_timestamp()). Frames copied by the Tx queue lose it. */
+#define IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP 0x80U
+#endif
+
+/* what the Rx CPU has found out about a frame, offsets are relative to the payload of the pbuf */
+typedef struct
+{
+    uint16 ethType;     /* Ethernet type behind an optional VLAN tag */
+    uint16 vlanTci;     /* tag control information (stripped by the GETH), 0 for untagged frames */
+    uint16 l3Offset;    /* start of the network header */
+    uint16 l4Offset;    /* start of the transport header, 0 if unknown */
+    uint16 dstPort;     /* UDP/TCP destination port, 0 if unknown */
+    uint8  ipProto;     /* IPv4 protocol, 0 for other frames */
+} Ifx_Netif_RxInfo;
+
+/* application receive callback running on the CPU of an Rx channel (IFX_LWIP_MULTICORE).
+ * Returns TRUE if it has taken the frame; it then owns p and must release it with
+ * ifx_netif_rx_release(), no lwIP function may be called from that CPU.
+ * Returns FALSE to pass the frame on to lwIP. */
+typedef boolean (*Ifx_Netif_RxHook)(struct pbuf *p, const Ifx_Netif_RxInfo *info, void *arg);
+
+/* transmit status the DMA has written back into the last descriptor of the frames, per Tx channel */
+typedef struct
+{
+    uint32 frames;      /* frames reclaimed */
+    uint32 errors;      /* frames with the error summary (ES) set */
+    uint32 underflow;   /* UF: the DMA couldn't deliver the frame in time */
+    uint32 carrier;     /* NC, LOC: no carrier or carrier lost */
+    uint32 collision;   /* EC, LC, ED: excessive or late collisions, excessive deferral */
+    uint32 checksum;    /* IHE, PCE: the checksums couldn't be inserted */
+    uint32 flushed;     /* FF: flushed from the Tx queue */
+    uint32 jabber;      /* JT: jabber timeout */
+    uint32 lastStatus;  /* TDES3 of the last frame with an error */
+} Ifx_Netif_TxErrors;
+
+err_t  ifx_netif_init(struct netif *netif);
+err_t  ifx_netif_input(struct netif *netif, IfxGeth_RxDmaChannel channel);
+void   ifx_netif_tx_complete(struct netif *netif);
+void   ifx_netif_link_update(struct netif *netif);
+uint32 ifx_netif_tx_queued(struct netif *netif);
+const Ifx_Netif_TxErrors *ifx_netif_get_tx_errors(IfxGeth_TxDmaChannel channel);
+#if IFX_LWIP_VLAN_NETIFS > 0
+err_t  ifx_netif_vlan_init(struct netif *netif);
+#endif
+#if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
+err_t  ifx_netif_mac_filter(struct netif *netif, const uint8 *addr, enum netif_mac_filter_action action);
+#endif
+#if IFX_LWIP_PTP
+boolean ifx_netif_get_timestamp(const struct pbuf *p, IfxGeth_Eth_Timestamp *timestamp);
+#endif
+#if IFX_LWIP_MULTICORE
+void   ifx_netif_set_rx_hook(IfxGeth_RxDmaChannel channel, Ifx_Netif_RxHook hook, void *arg);
+err_t  ifx_netif_rx_worker(struct netif *netif, IfxGeth_RxDmaChannel channel);
+void   ifx_netif_rx_release(struct pbuf *p);
+uint32 ifx_netif_rx_deliver(struct netif *netif, IfxGeth_RxDmaChannel channel, uint32 budget);
+#endif
 
 #endif
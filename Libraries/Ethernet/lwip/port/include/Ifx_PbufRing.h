@@ -0,0 +1,262 @@
+/**
+ * \file Ifx_PbufRing.h
+ * \brief Lock-free pbuf rings for handing frames from one core to another
+ *
+ * \copyright Copyright (c) 2019 Infineon Technologies AG. All rights reserved.
+ *
+ *
+ *
+ *                                 IMPORTANT NOTICE
+ *
+ *
+ * Use of this file is subject to the terms of use agreed between (i) you or
+ * the company in which ordinary course of business you are acting and (ii)
+ * Infineon Technologies AG or its licensees. If and as long as no such
+ * terms of use are agreed, use of this file is subject to following:
+
+
+ * Boost Software License - Version 1.0 - August 17th, 2003
+
+ * Permission is hereby granted, free of charge, to any person or
+ * organization obtaining a copy of the software and accompanying
+ * documentation covered by this license (the "Software") to use, reproduce,
+ * display, distribute, execute, and transmit the Software, and to prepare
+ * derivative works of the Software, and to permit third-parties to whom the
+ * Software is furnished to do so, all subject to the following:
+
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer, must
+ * be included in all copies of the Software, in whole or in part, and all
+ * derivative works of the Software, unless such copies or derivative works are
+ * solely in the form of machine-executable object code generated by a source
+ * language processor.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+
+ *
+ */
+
+#ifndef IFX_PBUFRING_H
+#define IFX_PBUFRING_H
+
+//________________________________________________________________________________________
+// INCLUDES
+
+#include "Ifx_Types.h"
+#include "IfxCpu.h"
+#include "lwip/pbuf.h"
+
+//________________________________________________________________________________________
+// MACROS
+
+/** \brief Data cache line of the TriCore, the indices written by different cores are kept apart by it */
+#define IFX_PBUFRING_CACHE_LINE 32U
+
+/** \brief Alignment for ring and slot definitions, e.g. Ifx_PbufRing ring IFX_PBUFRING_ALIGN; */
+#define IFX_PBUFRING_ALIGN      IFX_ALIGN(32)
+
+//________________________________________________________________________________________
+// DATA STRUCTURES
+
+/** \brief Lock-free ring of pbuf pointers between cores
+ *
+ * Single producer: the producer only writes \ref tail, the consumer only writes \ref head,
+ * so no lock is needed between two cores (Ifx_PbufRing_put(), Ifx_PbufRing_putBatch()).
+ *
+ * Multiple producers: the producers claim slots by a CMPSWAP on \ref reserve and publish
+ * them in order through \ref tail (Ifx_PbufRing_putMp(), Ifx_PbufRing_putBatchMp()).
+ * Single- and multi-producer functions must not be mixed on one ring.
+ *
+ * There is always a single consumer (Ifx_PbufRing_get(), Ifx_PbufRing_getBatch()).
+ * The ring and the slots have to be in memory which all cores see coherently (non-cached,
+ * e.g. section "lmubss_nc" in the LMU), aligned with \ref IFX_PBUFRING_ALIGN.
+ */
+typedef struct
+{
+    volatile uint32 head;                   /**< \brief next slot to read, written by the consumer */
+    uint32          reserved0[(IFX_PBUFRING_CACHE_LINE / 4) - 1];
+    volatile uint32 tail;                   /**< \brief slots below are readable, written by the producers */
+    volatile uint32 reserve;                /**< \brief next slot to claim (multiple producers only) */
+    uint32          mask;                   /**< \brief number of slots - 1 */
+    struct pbuf   **slots;                  /**< \brief slot array, the number of slots is a power of 2 */
+    uint32          reserved1[(IFX_PBUFRING_CACHE_LINE / 4) - 4];
+} Ifx_PbufRing;
+
+//________________________________________________________________________________________
+// FUNCTION PROTOTYPES
+
+/** \addtogroup lib_lwIP
+ * \{ */
+IFX_INLINE void         Ifx_PbufRing_init(Ifx_PbufRing *ring, struct pbuf **slots, uint32 numOfSlots);
+IFX_INLINE boolean      Ifx_PbufRing_put(Ifx_PbufRing *ring, struct pbuf *p);
+IFX_INLINE uint32       Ifx_PbufRing_putBatch(Ifx_PbufRing *ring, struct pbuf **p, uint32 count);
+IFX_INLINE boolean      Ifx_PbufRing_putMp(Ifx_PbufRing *ring, struct pbuf *p);
+IFX_INLINE uint32       Ifx_PbufRing_putBatchMp(Ifx_PbufRing *ring, struct pbuf **p, uint32 count);
+IFX_INLINE struct pbuf *Ifx_PbufRing_get(Ifx_PbufRing *ring);
+IFX_INLINE uint32       Ifx_PbufRing_getBatch(Ifx_PbufRing *ring, struct pbuf **p, uint32 count);
+IFX_INLINE uint32       Ifx_PbufRing_getCount(Ifx_PbufRing *ring);
+IFX_INLINE boolean      Ifx_PbufRing_isEmpty(Ifx_PbufRing *ring);
+/** \} */
+
+//________________________________________________________________________________________
+// INLINE FUNCTION IMPLEMENTATIONS
+
+/** \brief Initialises an empty ring, numOfSlots has to be a power of 2 */
+IFX_INLINE void Ifx_PbufRing_init(Ifx_PbufRing *ring, struct pbuf **slots, uint32 numOfSlots)
+{
+    IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, (numOfSlots != 0) && ((numOfSlots & (numOfSlots - 1)) == 0));
+
+    ring->head    = 0;
+    ring->tail    = 0;
+    ring->reserve = 0;
+    ring->mask    = numOfSlots - 1;
+    ring->slots   = slots;
+}
+
+
+/** \brief Single producer: appends a pbuf, returns FALSE if the ring is full */
+IFX_INLINE boolean Ifx_PbufRing_put(Ifx_PbufRing *ring, struct pbuf *p)
+{
+    return (boolean)(Ifx_PbufRing_putBatch(ring, &p, 1) == 1);
+}
+
+
+/** \brief Single producer: appends up to count pbufs with one index update, returns the number appended */
+IFX_INLINE uint32 Ifx_PbufRing_putBatch(Ifx_PbufRing *ring, struct pbuf **p, uint32 count)
+{
+    uint32 tail  = ring->tail;
+    uint32 space = (ring->mask + 1) - (tail - ring->head);
+    uint32 i;
+
+    if (count > space)
+    {
+        count = space;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        ring->slots[(tail + i) & ring->mask] = p[i];
+    }
+
+    if (count > 0)
+    {
+        __dsync();              /* the slots have to be visible before the consumer sees the new tail */
+        ring->tail = tail + count;
+    }
+
+    return count;
+}
+
+
+/** \brief Multiple producers: appends a pbuf, returns FALSE if the ring is full */
+IFX_INLINE boolean Ifx_PbufRing_putMp(Ifx_PbufRing *ring, struct pbuf *p)
+{
+    return (boolean)(Ifx_PbufRing_putBatchMp(ring, &p, 1) == 1);
+}
+
+
+/** \brief Multiple producers: appends up to count pbufs, returns the number appended
+ *
+ * The slots are claimed with CMPSWAP and published once the producers which have claimed
+ * earlier slots are done. The interrupts are disabled meanwhile, so that a producer on the
+ * same core can't wait for a preempted one.
+ */
+IFX_INLINE uint32 Ifx_PbufRing_putBatchMp(Ifx_PbufRing *ring, struct pbuf **p, uint32 count)
+{
+    boolean interruptState = IfxCpu_disableInterrupts();
+    uint32  reserve;
+    uint32  claim;
+    uint32  i;
+
+    do
+    {
+        uint32 space;
+
+        reserve = ring->reserve;
+        space   = (ring->mask + 1) - (reserve - ring->head);
+        claim   = (count > space) ? space : count;
+
+        if (claim == 0)
+        {
+            IfxCpu_restoreInterrupts(interruptState);
+            return 0;
+        }
+    } while (__cmpAndSwap((unsigned int *)&ring->reserve, reserve + claim, reserve) != reserve);
+
+    for (i = 0; i < claim; i++)
+    {
+        ring->slots[(reserve + i) & ring->mask] = p[i];
+    }
+
+    __dsync();                  /* the slots have to be visible before the consumer sees the new tail */
+
+    while (ring->tail != reserve)
+    {
+        /* an earlier claim is still being written by another core */
+    }
+
+    ring->tail = reserve + claim;
+
+    IfxCpu_restoreInterrupts(interruptState);
+
+    return claim;
+}
+
+
+/** \brief Consumer: removes the oldest pbuf, returns NULL if the ring is empty */
+IFX_INLINE struct pbuf *Ifx_PbufRing_get(Ifx_PbufRing *ring)
+{
+    struct pbuf *p;
+
+    return (Ifx_PbufRing_getBatch(ring, &p, 1) == 1) ? p : NULL;
+}
+
+
+/** \brief Consumer: removes up to count pbufs with one index update, returns the number removed */
+IFX_INLINE uint32 Ifx_PbufRing_getBatch(Ifx_PbufRing *ring, struct pbuf **p, uint32 count)
+{
+    uint32 head      = ring->head;
+    uint32 available = ring->tail - head;
+    uint32 i;
+
+    if (count > available)
+    {
+        count = available;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        p[i] = ring->slots[(head + i) & ring->mask];
+    }
+
+    if (count > 0)
+    {
+        __dsync();              /* the slots have been read before the producers may reuse them */
+        ring->head = head + count;
+    }
+
+    return count;
+}
+
+
+/** \brief Returns the number of pbufs in the ring */
+IFX_INLINE uint32 Ifx_PbufRing_getCount(Ifx_PbufRing *ring)
+{
+    return ring->tail - ring->head;
+}
+
+
+/** \brief Returns TRUE if the ring holds no pbuf */
+IFX_INLINE boolean Ifx_PbufRing_isEmpty(Ifx_PbufRing *ring)
+{
+    return (boolean)(ring->head == ring->tail);
+}
+
+
+#endif /* IFX_PBUFRING_H */
@@ -0,0 +1,714 @@
+/**
+ * \file Ifx_Gptp.c
+ * \brief IEEE 802.1AS (gPTP) slave disciplining the system time of the GETH
+ *
+ * \copyright Copyright (c) 2019 Infineon Technologies AG. All rights reserved.
+ *
+ *
+ *
+ *                                 IMPORTANT NOTICE
+ *
+ *
+ * Use of this file is subject to the terms of use agreed between (i) you or
+ * the company in which ordinary course of business you are acting and (ii)
+ * Infineon Technologies AG or its licensees. If and as long as no such
+ * terms of use are agreed, use of this file is subject to following:
+
+
+ * Boost Software License - Version 1.0 - August 17th, 2003
+
+ * Permission is hereby granted, free of charge, to any person or
+ * organization obtaining a copy of the software and accompanying
+ * documentation covered by this license (the "Software") to use, reproduce,
+ * display, distribute, execute, and transmit the Software, and to prepare
+ * derivative works of the Software, and to permit third-parties to whom the
+ * Software is furnished to do so, all subject to the following:
+
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer, must
+ * be included in all copies of the Software, in whole or in part, and all
+ * derivative works of the Software, unless such copies or derivative works are
+ * solely in the form of machine-executable object code generated by a source
+ * language processor.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+
+ *
+ */
+
+/******************************************************************************/
+/*----------------------------------Includes----------------------------------*/
+/******************************************************************************/
+#include "Ifx_Lwip.h"
+#include "Ifx_Netif.h"
+#include "Ifx_Gptp.h"
+#include "netif/ethernet.h"
+#include <string.h>
+
+#if IFX_LWIP_GPTP
+
+#if !(LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD))
+#error "IFX_LWIP_GPTP requires the multicast address filters of LWIP_IGMP"
+#endif
+
+/******************************************************************************/
+/*-----------------------------------Macros-----------------------------------*/
+/******************************************************************************/
+/* message types */
+#define IFX_GPTP_SYNC                  0x0U
+#define IFX_GPTP_PDELAY_REQ            0x2U
+#define IFX_GPTP_PDELAY_RESP           0x3U
+#define IFX_GPTP_FOLLOW_UP             0x8U
+#define IFX_GPTP_PDELAY_RESP_FOLLOW_UP 0xAU
+
+/* common header */
+#define IFX_GPTP_OFS_TYPE              0U   // transportSpecific (1: 802.1AS), messageType
+#define IFX_GPTP_OFS_VERSION           1U
+#define IFX_GPTP_OFS_LENGTH            2U
+#define IFX_GPTP_OFS_DOMAIN            4U
+#define IFX_GPTP_OFS_FLAGS             6U
+#define IFX_GPTP_OFS_CORRECTION        8U   // ns * 2^16
+#define IFX_GPTP_OFS_SOURCE            20U  // sourcePortIdentity
+#define IFX_GPTP_OFS_SEQUENCE          30U
+#define IFX_GPTP_OFS_CONTROL           32U
+#define IFX_GPTP_OFS_INTERVAL          33U
+#define IFX_GPTP_HEADER_LENGTH         34U
+
+/* message bodies */
+#define IFX_GPTP_OFS_TIMESTAMP         34U  // origin, precise origin, request receipt or response origin timestamp
+#define IFX_GPTP_OFS_REQUESTING        44U  // requestingPortIdentity of Pdelay_Resp and Pdelay_Resp_Follow_Up
+#define IFX_GPTP_FOLLOW_UP_LENGTH      44U  // without the follow up information TLV
+#define IFX_GPTP_PDELAY_LENGTH         54U
+
+#define IFX_GPTP_PORT_IDENTITY_LENGTH  10U
+#define IFX_GPTP_FLAG_TWO_STEP         0x02U // first flag octet
+
+#define IFX_GPTP_NS_PER_S              1000000000LL
+
+#define IFX_GPTP_PDELAY_PERIOD         (1000U / IFX_GPTP_TMR_INTERVAL)  // Pdelay_Req every 1 s
+#define IFX_GPTP_TX_TIMEOUT            (100U / IFX_GPTP_TMR_INTERVAL)   // transmit timestamp not coming any more
+#define IFX_GPTP_SYNC_TIMEOUT          (3000U / IFX_GPTP_TMR_INTERVAL)  // master lost after 3 s without Sync
+#define IFX_GPTP_ALLOWED_LOST          3U                                // missing peer delay responses until asCapable is dropped
+
+#define IFX_GPTP_MAX_LINK_DELAY        100000LL   // ns, longer measured delays are rejected
+#define IFX_GPTP_STEP_THRESHOLD        1000000LL  // ns, larger offsets step the system time
+#define IFX_GPTP_SYNC_THRESHOLD        1000LL     // ns, synchronized below
+#define IFX_GPTP_MAX_PPB               500000.0f  // limit of the frequency adjustment
+#define IFX_GPTP_KP                    0.7f       // proportional gain, per sync interval
+#define IFX_GPTP_KI                    0.3f       // integral gain, per sync interval
+
+/******************************************************************************/
+/*-----------------------------Data Structures--------------------------------*/
+/******************************************************************************/
+/** \brief Runtime state of the 802.1AS slave */
+typedef struct
+{
+    netif_t        *netif;
+    uint8           portIdentity[IFX_GPTP_PORT_IDENTITY_LENGTH]; /* EUI-64 of the MAC address, port 1 */
+
+    /* peer delay requester */
+    struct
+    {
+        pbuf_t *req;            /* Pdelay_Req until its transmit timestamp t1 has been read */
+        uint16  age;            /* timer ticks since req has been sent */
+        uint16  timer;          /* timer ticks since the last Pdelay_Req */
+        uint16  sequence;
+        uint8   lost;           /* exchanges without response in a row */
+        boolean t1Valid;
+        boolean respValid;
+        boolean followUpValid;
+        boolean done;           /* the exchange of sequence has been evaluated */
+        sint64  t1;             /* Pdelay_Req sent */
+        sint64  t2;             /* Pdelay_Req received by the neighbour */
+        sint64  t3;             /* Pdelay_Resp sent by the neighbour */
+        sint64  t4;             /* Pdelay_Resp received */
+        sint64  correction;     /* correction fields of Pdelay_Resp and Pdelay_Resp_Follow_Up */
+        uint8   responder[IFX_GPTP_PORT_IDENTITY_LENGTH];
+    } pdelay;
+
+    /* peer delay responder */
+    struct
+    {
+        pbuf_t *resp;           /* Pdelay_Resp until its transmit timestamp t3 has been read */
+        uint16  age;
+        uint16  sequence;
+        uint8   requester[IFX_GPTP_PORT_IDENTITY_LENGTH];
+    } responder;
+
+    /* slave */
+    struct
+    {
+        boolean valid;          /* a Sync is waiting for its Follow_Up */
+        uint16  sequence;
+        uint16  timer;          /* timer ticks since the last Sync of the master */
+        sint8   logInterval;
+        sint64  receipt;        /* t2 of the Sync */
+        sint64  correction;     /* correction field of the Sync */
+        float32 drift;          /* integral part of the servo in ppb */
+    } sync;
+
+    Ifx_Gptp_Status status;
+} Ifx_Gptp;
+
+/******************************************************************************/
+/*------------------------Private Variables/Constants-------------------------*/
+/******************************************************************************/
+static Ifx_Gptp               Ifx_Gptp_port;
+
+/* all 802.1AS messages are sent to the neighbour, bridges do not forward this address */
+static const struct eth_addr  Ifx_Gptp_address = ETH_ADDR(0x01, 0x80, 0xC2, 0x00, 0x00, 0x0E);
+
+/******************************************************************************/
+/*-------------------------Function Implementations---------------------------*/
+/******************************************************************************/
+
+static uint16 Ifx_Gptp_get16(const uint8 *data)
+{
+    return (uint16)(((uint16)data[0] << 8) | data[1]);
+}
+
+
+static uint32 Ifx_Gptp_get32(const uint8 *data)
+{
+    return ((uint32)data[0] << 24) | ((uint32)data[1] << 16) | ((uint32)data[2] << 8) | data[3];
+}
+
+
+static void Ifx_Gptp_put16(uint8 *data, uint16 value)
+{
+    data[0] = (uint8)(value >> 8);
+    data[1] = (uint8)value;
+}
+
+
+static void Ifx_Gptp_put32(uint8 *data, uint32 value)
+{
+    data[0] = (uint8)(value >> 24);
+    data[1] = (uint8)(value >> 16);
+    data[2] = (uint8)(value >> 8);
+    data[3] = (uint8)value;
+}
+
+
+/** \brief Reads a PTP timestamp (48 bit seconds, of which the lower 32 bits are used, 32 bit nanoseconds) in ns */
+static sint64 Ifx_Gptp_getTimestamp(const uint8 *data)
+{
+    return ((sint64)Ifx_Gptp_get32(&data[2]) * IFX_GPTP_NS_PER_S) + Ifx_Gptp_get32(&data[6]);
+}
+
+
+static void Ifx_Gptp_putTimestamp(uint8 *data, sint64 time)
+{
+    Ifx_Gptp_put16(&data[0], 0);
+    Ifx_Gptp_put32(&data[2], (uint32)(time / IFX_GPTP_NS_PER_S));
+    Ifx_Gptp_put32(&data[6], (uint32)(time % IFX_GPTP_NS_PER_S));
+}
+
+
+/** \brief Reads the correction field of a message in ns, the sub-nanoseconds are dropped */
+static sint64 Ifx_Gptp_getCorrection(const uint8 *msg)
+{
+    sint64 correction = (sint64)(((uint64)Ifx_Gptp_get32(&msg[IFX_GPTP_OFS_CORRECTION]) << 32) | Ifx_Gptp_get32(&msg[IFX_GPTP_OFS_CORRECTION + 4]));
+
+    return correction / 65536;
+}
+
+
+/** \brief Reads the GETH timestamp of a frame in ns
+ * \return FALSE if the frame has none */
+static boolean Ifx_Gptp_getFrameTime(const pbuf_t *p, sint64 *time)
+{
+    IfxGeth_Eth_Timestamp timestamp;
+
+    if (ifx_netif_get_timestamp(p, &timestamp) == FALSE)
+    {
+        return FALSE;
+    }
+
+    *time = ((sint64)timestamp.seconds * IFX_GPTP_NS_PER_S) + timestamp.nanoseconds;
+    return TRUE;
+}
+
+
+/** \brief Allocates a message and fills in its common header
+ * \return the message (the payload starts with the PTP header), NULL if out of memory */
+static pbuf_t *Ifx_Gptp_alloc(uint8 type, uint16 length, uint16 sequence, uint8 control)
+{
+    pbuf_t *p = pbuf_alloc(PBUF_LINK, length, PBUF_RAM);
+    uint8  *msg;
+
+    if (p == NULL)
+    {
+        return NULL;
+    }
+
+    msg = (uint8 *)p->payload;
+    memset(msg, 0, length);
+
+    msg[IFX_GPTP_OFS_TYPE]    = (uint8)(0x10U | type);
+    msg[IFX_GPTP_OFS_VERSION] = 2;
+    Ifx_Gptp_put16(&msg[IFX_GPTP_OFS_LENGTH], length);
+    memcpy(&msg[IFX_GPTP_OFS_SOURCE], Ifx_Gptp_port.portIdentity, IFX_GPTP_PORT_IDENTITY_LENGTH);
+    Ifx_Gptp_put16(&msg[IFX_GPTP_OFS_SEQUENCE], sequence);
+    msg[IFX_GPTP_OFS_CONTROL]  = control;
+    msg[IFX_GPTP_OFS_INTERVAL] = 0x7F; /* not used by the peer delay messages */
+
+    return p;
+}
+
+
+/** \brief Sends a message to the neighbour
+ * \param p the message, still owned by the caller
+ * \param timestamp TRUE to get its transmit timestamp into p (ifx_netif_get_timestamp())
+ * \return FALSE if it couldn't be sent */
+static boolean Ifx_Gptp_send(pbuf_t *p, boolean timestamp)
+{
+    netif_t *netif = Ifx_Gptp_port.netif;
+
+    if (timestamp)
+    {
+        p->flags |= IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP;
+    }
+
+    if (ethernet_output(netif, p, (const struct eth_addr *)netif->hwaddr, &Ifx_Gptp_address, ETHTYPE_PTP) != ERR_OK)
+    {
+        p->flags &= (u8_t)~IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+/** \brief Evaluates a complete peer delay exchange (neighbour rate ratio 1) */
+static void Ifx_Gptp_updateLinkDelay(void)
+{
+    Ifx_Gptp *port = &Ifx_Gptp_port;
+    sint64    delay;
+
+    if (port->pdelay.done || !port->pdelay.t1Valid || !port->pdelay.respValid || !port->pdelay.followUpValid)
+    {
+        return;
+    }
+
+    port->pdelay.done = TRUE;
+    port->pdelay.lost = 0;
+
+    delay = ((port->pdelay.t4 - port->pdelay.t1) - (port->pdelay.t3 - port->pdelay.t2) - port->pdelay.correction) / 2;
+
+    if ((delay < 0) || (delay > IFX_GPTP_MAX_LINK_DELAY))
+    {
+        return;
+    }
+
+    if (port->status.pdelayCount == 0)
+    {
+        port->status.meanLinkDelay = delay;
+    }
+    else
+    {
+        /* averaged over about 8 measurements */
+        port->status.meanLinkDelay += (delay - port->status.meanLinkDelay) / 8;
+    }
+
+    port->status.pdelayCount++;
+    port->status.asCapable = TRUE;
+}
+
+
+/** \brief Disciplines the system time by the offset from the master (PI servo) */
+static void Ifx_Gptp_servo(sint64 offset, sint8 logInterval)
+{
+    Ifx_Gptp    *port = &Ifx_Gptp_port;
+    IfxGeth_Eth *geth = port->netif->state;
+    float32      interval;
+    float32      ppb;
+
+    port->status.offset = offset;
+    port->status.syncCount++;
+
+    if ((offset > IFX_GPTP_STEP_THRESHOLD) || (offset < -IFX_GPTP_STEP_THRESHOLD))
+    {
+        /* far off, e.g. with the first Sync: step the time and keep the frequency, the
+         * timestamps of the running peer delay exchange are not comparable any more */
+        IfxGeth_Eth_adjustSystemTime(geth, -offset);
+        port->status.stepCount++;
+        port->status.synchronized = FALSE;
+        port->pdelay.done         = TRUE;
+        return;
+    }
+
+    logInterval = (sint8)LWIP_MIN(LWIP_MAX(logInterval, -7), 4);
+    interval    = (logInterval >= 0) ? (float32)(1U << logInterval) : (1.0f / (float32)(1U << -logInterval));
+
+    /* ns per sync interval -> ppb */
+    port->sync.drift += (IFX_GPTP_KI * (float32)offset) / interval;
+    port->sync.drift  = LWIP_MIN(LWIP_MAX(port->sync.drift, -IFX_GPTP_MAX_PPB), IFX_GPTP_MAX_PPB);
+    ppb               = ((IFX_GPTP_KP * (float32)offset) / interval) + port->sync.drift;
+    ppb               = LWIP_MIN(LWIP_MAX(ppb, -IFX_GPTP_MAX_PPB), IFX_GPTP_MAX_PPB);
+
+    /* the system time is ahead of the master if the offset is positive: slow it down */
+    port->status.frequency    = (sint32)(-ppb);
+    port->status.synchronized = (offset < IFX_GPTP_SYNC_THRESHOLD) && (offset > -IFX_GPTP_SYNC_THRESHOLD);
+    IfxGeth_Eth_adjustSystemTimeFrequency(geth, port->status.frequency);
+}
+
+
+static void Ifx_Gptp_onSync(const uint8 *msg, const pbuf_t *p)
+{
+    Ifx_Gptp *port = &Ifx_Gptp_port;
+    sint64    receipt;
+
+    if ((port->sync.timer >= IFX_GPTP_SYNC_TIMEOUT) || (port->status.syncCount == 0 && !port->sync.valid))
+    {
+        /* no master yet or it has gone silent: follow this one (no best master selection) */
+        memcpy(port->status.master, &msg[IFX_GPTP_OFS_SOURCE], IFX_GPTP_PORT_IDENTITY_LENGTH);
+    }
+    else if (memcmp(port->status.master, &msg[IFX_GPTP_OFS_SOURCE], IFX_GPTP_PORT_IDENTITY_LENGTH) != 0)
+    {
+        return;
+    }
+
+    if (Ifx_Gptp_getFrameTime(p, &receipt) == FALSE)
+    {
+        return;
+    }
+
+    port->sync.valid       = ((msg[IFX_GPTP_OFS_FLAGS] & IFX_GPTP_FLAG_TWO_STEP) != 0); /* one-step Syncs are not supported */
+    port->sync.sequence    = Ifx_Gptp_get16(&msg[IFX_GPTP_OFS_SEQUENCE]);
+    port->sync.timer       = 0;
+    port->sync.logInterval = (sint8)msg[IFX_GPTP_OFS_INTERVAL];
+    port->sync.receipt     = receipt;
+    port->sync.correction  = Ifx_Gptp_getCorrection(msg);
+}
+
+
+static void Ifx_Gptp_onFollowUp(const uint8 *msg)
+{
+    Ifx_Gptp *port = &Ifx_Gptp_port;
+    sint64    origin;
+
+    if (!port->sync.valid || (Ifx_Gptp_get16(&msg[IFX_GPTP_OFS_SEQUENCE]) != port->sync.sequence) ||
+        (memcmp(port->status.master, &msg[IFX_GPTP_OFS_SOURCE], IFX_GPTP_PORT_IDENTITY_LENGTH) != 0))
+    {
+        return;
+    }
+
+    port->sync.valid = FALSE;
+
+    /* the time of the master when the Sync has left the neighbour, corrected by the residence times of the bridges */
+    origin = Ifx_Gptp_getTimestamp(&msg[IFX_GPTP_OFS_TIMESTAMP]) + Ifx_Gptp_getCorrection(msg) + port->sync.correction;
+
+    Ifx_Gptp_servo(port->sync.receipt - origin - port->status.meanLinkDelay, port->sync.logInterval);
+}
+
+
+/** \brief Answers a Pdelay_Req of the neighbour, the Pdelay_Resp_Follow_Up is sent by Ifx_Gptp_timer() */
+static void Ifx_Gptp_onPdelayReq(const uint8 *msg, const pbuf_t *p)
+{
+    Ifx_Gptp *port = &Ifx_Gptp_port;
+    sint64    receipt;
+    pbuf_t   *resp;
+    uint8    *data;
+    uint16    sequence = Ifx_Gptp_get16(&msg[IFX_GPTP_OFS_SEQUENCE]);
+
+    if (Ifx_Gptp_getFrameTime(p, &receipt) == FALSE)
+    {
+        return;
+    }
+
+    resp = Ifx_Gptp_alloc(IFX_GPTP_PDELAY_RESP, IFX_GPTP_PDELAY_LENGTH, sequence, 5);
+
+    if (resp == NULL)
+    {
+        return;
+    }
+
+    data                      = (uint8 *)resp->payload;
+    data[IFX_GPTP_OFS_FLAGS] |= IFX_GPTP_FLAG_TWO_STEP;
+    Ifx_Gptp_putTimestamp(&data[IFX_GPTP_OFS_TIMESTAMP], receipt);
+    memcpy(&data[IFX_GPTP_OFS_REQUESTING], &msg[IFX_GPTP_OFS_SOURCE], IFX_GPTP_PORT_IDENTITY_LENGTH);
+
+    if (port->responder.resp != NULL)
+    {
+        /* the previous one didn't get its timestamp */
+        pbuf_free(port->responder.resp);
+        port->responder.resp = NULL;
+    }
+
+    if (Ifx_Gptp_send(resp, TRUE))
+    {
+        port->responder.resp     = resp;
+        port->responder.age      = 0;
+        port->responder.sequence = sequence;
+        memcpy(port->responder.requester, &msg[IFX_GPTP_OFS_SOURCE], IFX_GPTP_PORT_IDENTITY_LENGTH);
+    }
+    else
+    {
+        pbuf_free(resp);
+    }
+}
+
+
+/** \brief Pdelay_Resp and Pdelay_Resp_Follow_Up to our Pdelay_Req */
+static void Ifx_Gptp_onPdelayResponse(uint8 type, const uint8 *msg, const pbuf_t *p)
+{
+    Ifx_Gptp *port = &Ifx_Gptp_port;
+
+    if ((Ifx_Gptp_get16(&msg[IFX_GPTP_OFS_SEQUENCE]) != port->pdelay.sequence) ||
+        (memcmp(&msg[IFX_GPTP_OFS_REQUESTING], port->portIdentity, IFX_GPTP_PORT_IDENTITY_LENGTH) != 0))
+    {
+        return;
+    }
+
+    if (type == IFX_GPTP_PDELAY_RESP)
+    {
+        if (port->pdelay.respValid || (Ifx_Gptp_getFrameTime(p, &port->pdelay.t4) == FALSE))
+        {
+            /* several responders (not a point to point link) or no timestamp */
+            port->pdelay.done = TRUE;
+            return;
+        }
+
+        port->pdelay.t2          = Ifx_Gptp_getTimestamp(&msg[IFX_GPTP_OFS_TIMESTAMP]);
+        port->pdelay.correction += Ifx_Gptp_getCorrection(msg);
+        port->pdelay.respValid   = TRUE;
+        memcpy(port->pdelay.responder, &msg[IFX_GPTP_OFS_SOURCE], IFX_GPTP_PORT_IDENTITY_LENGTH);
+    }
+    else
+    {
+        if (!port->pdelay.respValid || (memcmp(port->pdelay.responder, &msg[IFX_GPTP_OFS_SOURCE], IFX_GPTP_PORT_IDENTITY_LENGTH) != 0))
+        {
+            return;
+        }
+
+        port->pdelay.t3             = Ifx_Gptp_getTimestamp(&msg[IFX_GPTP_OFS_TIMESTAMP]);
+        port->pdelay.correction    += Ifx_Gptp_getCorrection(msg);
+        port->pdelay.followUpValid  = TRUE;
+    }
+
+    Ifx_Gptp_updateLinkDelay();
+}
+
+
+/** \brief Starts a new peer delay exchange */
+static void Ifx_Gptp_sendPdelayReq(void)
+{
+    Ifx_Gptp *port = &Ifx_Gptp_port;
+    pbuf_t   *req;
+
+    if (!port->pdelay.done)
+    {
+        /* no complete answer to the last request */
+        if (++port->pdelay.lost >= IFX_GPTP_ALLOWED_LOST)
+        {
+            port->status.asCapable = FALSE;
+        }
+    }
+
+    if (port->pdelay.req != NULL)
+    {
+        pbuf_free(port->pdelay.req);
+        port->pdelay.req = NULL;
+    }
+
+    port->pdelay.sequence++;
+    port->pdelay.t1Valid       = FALSE;
+    port->pdelay.respValid     = FALSE;
+    port->pdelay.followUpValid = FALSE;
+    port->pdelay.done          = FALSE;
+    port->pdelay.correction    = 0;
+
+    req = Ifx_Gptp_alloc(IFX_GPTP_PDELAY_REQ, IFX_GPTP_PDELAY_LENGTH, port->pdelay.sequence, 5);
+
+    if (req == NULL)
+    {
+        return;
+    }
+
+    if (Ifx_Gptp_send(req, TRUE))
+    {
+        port->pdelay.req = req;
+        port->pdelay.age = 0;
+    }
+    else
+    {
+        pbuf_free(req);
+    }
+}
+
+
+/** \brief Sends the Pdelay_Resp_Follow_Up with the transmit timestamp of the Pdelay_Resp */
+static void Ifx_Gptp_sendPdelayRespFollowUp(sint64 responseOrigin)
+{
+    Ifx_Gptp *port = &Ifx_Gptp_port;
+    pbuf_t   *followUp = Ifx_Gptp_alloc(IFX_GPTP_PDELAY_RESP_FOLLOW_UP, IFX_GPTP_PDELAY_LENGTH, port->responder.sequence, 5);
+    uint8    *data;
+
+    if (followUp == NULL)
+    {
+        return;
+    }
+
+    data = (uint8 *)followUp->payload;
+    Ifx_Gptp_putTimestamp(&data[IFX_GPTP_OFS_TIMESTAMP], responseOrigin);
+    memcpy(&data[IFX_GPTP_OFS_REQUESTING], port->responder.requester, IFX_GPTP_PORT_IDENTITY_LENGTH);
+
+    Ifx_Gptp_send(followUp, FALSE);
+    pbuf_free(followUp);
+}
+
+
+void Ifx_Gptp_init(netif_t *netif)
+{
+    Ifx_Gptp *port = &Ifx_Gptp_port;
+
+    memset(port, 0, sizeof(*port));
+    port->netif             = netif;
+    port->pdelay.done       = TRUE;
+    port->sync.timer        = IFX_GPTP_SYNC_TIMEOUT;
+
+    /* clock identity: EUI-64 of the MAC address, port number 1 */
+    port->portIdentity[0]   = netif->hwaddr[0];
+    port->portIdentity[1]   = netif->hwaddr[1];
+    port->portIdentity[2]   = netif->hwaddr[2];
+    port->portIdentity[3]   = 0xFF;
+    port->portIdentity[4]   = 0xFE;
+    port->portIdentity[5]   = netif->hwaddr[3];
+    port->portIdentity[6]   = netif->hwaddr[4];
+    port->portIdentity[7]   = netif->hwaddr[5];
+    port->portIdentity[8]   = 0;
+    port->portIdentity[9]   = 1;
+
+    ifx_netif_mac_filter(netif, Ifx_Gptp_address.addr, NETIF_ADD_MAC_FILTER);
+}
+
+
+void Ifx_Gptp_input(netif_t *netif, pbuf_t *p)
+{
+    uint8 msg[IFX_GPTP_PDELAY_LENGTH];
+    uint8 type;
+
+    /* the header and the fields used by all messages, the TLVs are ignored */
+    if ((netif != Ifx_Gptp_port.netif) ||
+        (pbuf_copy_partial(p, msg, sizeof(msg), SIZEOF_ETH_HDR) < IFX_GPTP_FOLLOW_UP_LENGTH) ||
+        ((msg[IFX_GPTP_OFS_TYPE] & 0xF0U) != 0x10U) || ((msg[IFX_GPTP_OFS_VERSION] & 0x0FU) != 2) || (msg[IFX_GPTP_OFS_DOMAIN] != 0))
+    {
+        pbuf_free(p);
+        return;
+    }
+
+    type = msg[IFX_GPTP_OFS_TYPE] & 0x0FU;
+
+    if ((p->tot_len < (SIZEOF_ETH_HDR + IFX_GPTP_PDELAY_LENGTH)) &&
+        ((type == IFX_GPTP_PDELAY_REQ) || (type == IFX_GPTP_PDELAY_RESP) || (type == IFX_GPTP_PDELAY_RESP_FOLLOW_UP)))
+    {
+        pbuf_free(p);
+        return;
+    }
+
+    switch (type)
+    {
+    case IFX_GPTP_SYNC:
+        Ifx_Gptp_onSync(msg, p);
+        break;
+
+    case IFX_GPTP_FOLLOW_UP:
+        Ifx_Gptp_onFollowUp(msg);
+        break;
+
+    case IFX_GPTP_PDELAY_REQ:
+        Ifx_Gptp_onPdelayReq(msg, p);
+        break;
+
+    case IFX_GPTP_PDELAY_RESP:
+    case IFX_GPTP_PDELAY_RESP_FOLLOW_UP:
+        Ifx_Gptp_onPdelayResponse(type, msg, p);
+        break;
+
+    default:
+        /* Announce and signaling: there is no best master selection */
+        break;
+    }
+
+    pbuf_free(p);
+}
+
+
+void Ifx_Gptp_timer(void)
+{
+    Ifx_Gptp *port = &Ifx_Gptp_port;
+    sint64    time;
+
+    if (port->netif == NULL)
+    {
+        return;
+    }
+
+    if (port->sync.timer < IFX_GPTP_SYNC_TIMEOUT)
+    {
+        if (++port->sync.timer == IFX_GPTP_SYNC_TIMEOUT)
+        {
+            port->sync.valid          = FALSE;
+            port->status.synchronized = FALSE;
+        }
+    }
+
+    /* t1 of our Pdelay_Req */
+    if (port->pdelay.req != NULL)
+    {
+        if ((port->pdelay.req->flags & IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP) == 0)
+        {
+            port->pdelay.t1Valid = Ifx_Gptp_getFrameTime(port->pdelay.req, &port->pdelay.t1);
+            pbuf_free(port->pdelay.req);
+            port->pdelay.req = NULL;
+            Ifx_Gptp_updateLinkDelay();
+        }
+        else if (++port->pdelay.age >= IFX_GPTP_TX_TIMEOUT)
+        {
+            pbuf_free(port->pdelay.req);
+            port->pdelay.req = NULL;
+        }
+    }
+
+    /* t3 of our Pdelay_Resp goes to the requester in the follow up */
+    if (port->responder.resp != NULL)
+    {
+        if ((port->responder.resp->flags & IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP) == 0)
+        {
+            if (Ifx_Gptp_getFrameTime(port->responder.resp, &time))
+            {
+                Ifx_Gptp_sendPdelayRespFollowUp(time);
+            }
+
+            pbuf_free(port->responder.resp);
+            port->responder.resp = NULL;
+        }
+        else if (++port->responder.age >= IFX_GPTP_TX_TIMEOUT)
+        {
+            pbuf_free(port->responder.resp);
+            port->responder.resp = NULL;
+        }
+    }
+
+    if (++port->pdelay.timer >= IFX_GPTP_PDELAY_PERIOD)
+    {
+        port->pdelay.timer = 0;
+        Ifx_Gptp_sendPdelayReq();
+    }
+}
+
+
+const Ifx_Gptp_Status *Ifx_Gptp_getStatus(void)
+{
+    return &Ifx_Gptp_port.status;
+}
+
+
+#endif /* IFX_LWIP_GPTP */
@@ -56,6 +56,9 @@
 #include <string.h>
 #include <stdarg.h>
 #include <UART_Logging.h>
+#if IFX_LWIP_GPTP
+#include "Ifx_Gptp.h"
+#endif
 
 
 /******************************************************************************/
@@ -68,7 +71,8 @@
 #define IFX_LWIP_TCP_SLOW_PERIOD    (TCP_SLOW_INTERVAL / IFX_LWIP_TIMER_TICK_MS)
 #define IFX_LWIP_DHCP_COARSE_PERIOD (DHCP_COARSE_TIMER_MSECS / IFX_LWIP_TIMER_TICK_MS)
 #define IFX_LWIP_DHCP_FINE_PERIOD   (DHCP_FINE_TIMER_MSECS / IFX_LWIP_TIMER_TICK_MS)
-#define IFX_LWIP_LINK_PERIOD        (100U / IFX_LWIP_TIMER_TICK_MS) /* 100 ms */
+#define IFX_LWIP_LINK_PERIOD        (1000U / IFX_LWIP_TIMER_TICK_MS) /* 1 s, link changes are signalled by ISR_Geth_Link */
+#define IFX_LWIP_GPTP_PERIOD        (IFX_GPTP_TMR_INTERVAL / IFX_LWIP_TIMER_TICK_MS)
 
 #define IFX_LWIP_FLAG_ARP           (1U << 1)
 #define IFX_LWIP_FLAG_TCP_FAST      (1U << 2)
@@ -76,6 +80,11 @@
 #define IFX_LWIP_FLAG_LINK          (1U << 4)
 #define IFX_LWIP_FLAG_DHCP_COARSE   (1U << 5)
 #define IFX_LWIP_FLAG_DHCP_FINE     (1U << 6)
+#define IFX_LWIP_FLAG_GPTP          (1U << 7)
+
+#define IFX_LWIP_ETH_FLAG_TX        (1U << 0)   // Tx descriptors completed
+#define IFX_LWIP_ETH_FLAG_RX(ch)    (1U << (1 + (ch)))  // frames received on channel ch, Rx interrupt masked until the ring is drained
+#define IFX_LWIP_ETH_FLAG_LINK      (1U << 5)   // RGMII link status changed
 
 /******************************************************************************/
 /*--------------------------------Enumerations--------------------------------*/
@@ -211,17 +220,75 @@ Ifx_Lwip    g_Lwip;
 IfxGeth_Eth g_IfxGeth;
 uint32 isrTxCount=0;
 uint32 isrRxCount=0;
-uint8 channel0TxBuffer1[IFXGETH_MAX_TX_DESCRIPTORS][IFXGETH_MAX_TX_BUFFER_SIZE];
-uint8 channel0RxBuffer1[IFXGETH_MAX_RX_DESCRIPTORS][IFXGETH_MAX_RX_BUFFER_SIZE];
+#if IFX_LWIP_DMA_MEMORY == IFX_LWIP_DMA_MEMORY_DSPR
+IfxGeth_TxDescr channelTxDescr[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_TX_DESCRIPTORS] IFX_LWIP_DMA_ALIGN;
+IfxGeth_RxDescr channelRxDescr[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_RX_DESCRIPTORS] IFX_LWIP_DMA_ALIGN;
+uint8 channelTxBuffer1[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_TX_BUFFERS][IFXGETH_MAX_TX_BUFFER_SIZE] IFX_LWIP_DMA_ALIGN;
+uint8 channelRxBuffer1[IFX_LWIP_RX_BUFFER_COUNT][IFXGETH_MAX_RX_BUFFER_SIZE] IFX_LWIP_DMA_ALIGN;
+#endif
 
 
 /******************************************************************************/
 /*------------------------Private Variables/Constants-------------------------*/
 /******************************************************************************/
+#if IFX_LWIP_MULTICORE
+/* per Rx channel, set by its interrupt and handled by Ifx_Lwip_pollRxWorker() on the serving CPU */
+static volatile uint8 Ifx_Lwip_rxWorkerFlags[IFX_LWIP_NUM_CHANNELS];
+
+/* CPUs serving the Rx channels */
+static const uint8 Ifx_Lwip_rxChannelCpu[IFX_LWIP_NUM_CHANNELS] = {
+    IFX_LWIP_RX_CHANNEL0_CPU,
+#if IFX_LWIP_NUM_CHANNELS > 1
+    IFX_LWIP_RX_CHANNEL1_CPU, IFX_LWIP_RX_CHANNEL2_CPU, IFX_LWIP_RX_CHANNEL3_CPU
+#endif
+};
+#endif
 #if defined(__GNUC__)
     #pragma section // end bss section
 #endif
 
+#if IFX_LWIP_DMA_MEMORY != IFX_LWIP_DMA_MEMORY_DSPR
+/* the descriptors are written back by the DMA while the CPU reads their neighbours,
+ * they stay in the non-cached LMU in any case */
+#if defined(__GNUC__)
+#pragma section ".lmubss_dma_nc" aw
+#endif
+#if defined(__TASKING__)
+#pragma section farbss "lmubss_dma_nc"
+#endif
+IfxGeth_TxDescr channelTxDescr[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_TX_DESCRIPTORS] IFX_LWIP_DMA_ALIGN;
+IfxGeth_RxDescr channelRxDescr[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_RX_DESCRIPTORS] IFX_LWIP_DMA_ALIGN;
+#if IFX_LWIP_DMA_MEMORY == IFX_LWIP_DMA_MEMORY_LMU_NC
+uint8 channelTxBuffer1[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_TX_BUFFERS][IFXGETH_MAX_TX_BUFFER_SIZE] IFX_LWIP_DMA_ALIGN;
+uint8 channelRxBuffer1[IFX_LWIP_RX_BUFFER_COUNT][IFXGETH_MAX_RX_BUFFER_SIZE] IFX_LWIP_DMA_ALIGN;
+#endif
+#if defined(__GNUC__)
+#pragma section
+#endif
+#if defined(__TASKING__)
+#pragma section farbss restore
+#endif
+
+#if IFX_LWIP_DMA_MEMORY == IFX_LWIP_DMA_MEMORY_LMU
+/* the buffers are read through the data cache, netif.c writes them back and
+ * invalidates them around the DMA (Ifx_Lwip_dmaFlush(), Ifx_Lwip_dmaInvalidate()) */
+#if defined(__GNUC__)
+#pragma section ".lmubss_dma" aw
+#endif
+#if defined(__TASKING__)
+#pragma section farbss "lmubss_dma"
+#endif
+uint8 channelTxBuffer1[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_TX_BUFFERS][IFXGETH_MAX_TX_BUFFER_SIZE] IFX_LWIP_DMA_ALIGN;
+uint8 channelRxBuffer1[IFX_LWIP_RX_BUFFER_COUNT][IFXGETH_MAX_RX_BUFFER_SIZE] IFX_LWIP_DMA_ALIGN;
+#if defined(__GNUC__)
+#pragma section
+#endif
+#if defined(__TASKING__)
+#pragma section farbss restore
+#endif
+#endif
+#endif
+
 /******************************************************************************/
 /*-------------------------Function Prototypes--------------------------------*/
 /******************************************************************************/
@@ -258,6 +325,10 @@ void Ifx_Lwip_onTimerTick(void)
 
     Ifx_Lwip_timerIncr(lwip->timer.link, IFX_LWIP_LINK_PERIOD, IFX_LWIP_FLAG_LINK);
 
+#if IFX_LWIP_GPTP
+    Ifx_Lwip_timerIncr(lwip->timer.gptp, IFX_LWIP_GPTP_PERIOD, IFX_LWIP_FLAG_GPTP);
+#endif
+
     lwip->timerFlags = timerFlags;
 }
 
@@ -300,6 +371,14 @@ void Ifx_Lwip_pollTimerFlags(void)
             tcp_fasttmr();
     }
 
+#if IFX_LWIP_TX_COALESCE_FRAMES > 1
+    if (timerFlags & IFX_LWIP_FLAG_TCP_FAST)
+    {
+        /* the last frames of a burst raise no Tx interrupt, release their pbufs */
+        ifx_netif_tx_complete(&g_Lwip.netif);
+    }
+#endif
+
     if (timerFlags & IFX_LWIP_FLAG_TCP_SLOW)
     {
         /* only if we have a link we will check the tcp */
@@ -316,44 +395,150 @@ void Ifx_Lwip_pollTimerFlags(void)
 
     if (timerFlags & IFX_LWIP_FLAG_LINK)
     {
-        Ifx_GETH_MAC_PHYIF_CONTROL_STATUS ctrl_status;
-        ctrl_status.U = GETH_MAC_PHYIF_CONTROL_STATUS.U;
-        if (ctrl_status.B.LNKSTS == 0)
-            netif_set_link_down(&g_Lwip.netif);
-        else {
-            IfxGeth_Eth *ethernetif = g_Lwip.netif.state;
-            // we set the correct duplexMode
-            if (ctrl_status.B.LNKMOD == 1)
-                IfxGeth_mac_setDuplexMode(ethernetif->gethSFR, IfxGeth_DuplexMode_fullDuplex);
-            else
-                IfxGeth_mac_setDuplexMode(ethernetif->gethSFR, IfxGeth_DuplexMode_halfDuplex);
-            // we set the correct speed
-            if (ctrl_status.B.LNKSPEED == 0)
-                // 10MBit speed
-                IfxGeth_mac_setLineSpeed(ethernetif->gethSFR, IfxGeth_LineSpeed_10Mbps);
-            else
-                if (ctrl_status.B.LNKSPEED == 1)
-                    // 100MBit speed
-                    IfxGeth_mac_setLineSpeed(ethernetif->gethSFR, IfxGeth_LineSpeed_100Mbps);
-                else
-                    // 1000MBit speed
-                    IfxGeth_mac_setLineSpeed(ethernetif->gethSFR, IfxGeth_LineSpeed_1000Mbps);
-            netif_set_link_up(&g_Lwip.netif);
+        /* in case a link change has not been signalled, see Ifx_Lwip_pollReceiveFlags() */
+        IfxGeth_Eth_Phy_Rtl8211f_requestLinkStatus();
+    }
+
+#if IFX_LWIP_GPTP
+    if (timerFlags & IFX_LWIP_FLAG_GPTP)
+    {
+        /* only if we have a link we will exchange the peer delay messages */
+        if (g_Lwip.netif.flags & NETIF_FLAG_LINK_UP)
+            Ifx_Gptp_timer();
+    }
+#endif
+}
+
+
+/** \brief Handles the frames received on one Rx DMA channel */
+static void Ifx_Lwip_pollReceiveChannel(IfxGeth_RxDmaChannel channel)
+{
+#if !IFX_LWIP_MULTICORE
+    Ifx_Lwip    *lwip       = &g_Lwip;
+#endif
+    IfxGeth_Eth *ethernetif = g_Lwip.netif.state;
+    uint32       budget     = IFX_LWIP_RX_BUDGET;
+    boolean      interruptState;
+
+    IfxGeth_dma_clearInterruptFlag(ethernetif->gethSFR, (IfxGeth_DmaChannel)channel, IfxGeth_DmaInterruptFlag_receiveInterrupt);
+
+    /* handle at most IFX_LWIP_RX_BUDGET frames, so that the timers and the other channels are not starved by a burst */
+    while ((budget > 0) && IfxGeth_Eth_isRxDataAvailable(ethernetif, channel))
+    {
+#if IFX_LWIP_MULTICORE
+        err_t err = ifx_netif_rx_worker(&g_Lwip.netif, channel);
+#else
+        err_t err = ifx_netif_input(&g_Lwip.netif, channel);
+#endif
+
+        if (err == ERR_INPROGRESS)
+        {
+            /* the DMA is still writing the frame or its timestamp, it is read by the next poll */
+            break;
         }
+
+        budget--;
     }
+
+#if IFX_LWIP_RX_COALESCE_ADAPTIVE
+    IfxGeth_Eth_adaptRxCoalescing(ethernetif, channel, IFX_LWIP_RX_BUDGET - budget);
+#endif
+
+    /* the descriptors have been handed back one by one, resume the DMA once for all of them */
+    IfxGeth_Eth_updateRxTailPointer(ethernetif, channel);
+    IfxGeth_Eth_wakeupReceiver(ethernetif, channel);
+
+    interruptState = IfxCpu_disableInterrupts();
+
+    if (IfxGeth_Eth_isRxDataAvailable(ethernetif, channel))
+    {
+        /* budget exhausted (or a frame came in meanwhile), continue with the next poll */
+#if IFX_LWIP_MULTICORE
+        Ifx_Lwip_rxWorkerFlags[channel] = 1;
+#else
+        lwip->ethFlags |= IFX_LWIP_ETH_FLAG_RX(channel);
+#endif
+    }
+    else
+    {
+        /* ring is empty, unmask the Rx interrupt again */
+        IfxGeth_dma_enableInterrupt(ethernetif->gethSFR, (IfxGeth_DmaChannel)channel, IfxGeth_DmaInterruptFlag_receiveInterrupt);
+    }
+
+    IfxCpu_restoreInterrupts(interruptState);
 }
 
 
 /** \brief Polling the ETH receive event flags */
 void Ifx_Lwip_pollReceiveFlags(void)
 {
-    /**
-     * We are assuming that the only interrupt source is an incoming packet
-     */
-    //while (ethernetif_tc29x_timerFlags_interrupt())
-    // {
-    //     ifx_netif_input(&g_Lwip.netif);
-    // }
+    Ifx_Lwip *lwip = &g_Lwip;
+    uint16    ethFlags;
+    uint32    channel;
+
+    /* disable interrupts */
+    boolean interruptState = IfxCpu_disableInterrupts();
+
+    ethFlags       = lwip->ethFlags;
+    lwip->ethFlags = 0;
+
+    /* enable interrupts again */
+    IfxCpu_restoreInterrupts(interruptState);
+
+    /* every channel has its own budget, in the order of the Rx queue priority: a burst
+     * of bulk traffic delays the control channel by one budget at most */
+    for (channel = 0; channel < IFX_LWIP_NUM_CHANNELS; channel++)
+    {
+#if IFX_LWIP_MULTICORE
+        /* the descriptors are served by the CPU of the channel, take what it has queued */
+        ifx_netif_rx_deliver(&g_Lwip.netif, (IfxGeth_RxDmaChannel)channel, IFX_LWIP_RX_BUDGET);
+#else
+        if (ethFlags & IFX_LWIP_ETH_FLAG_RX(channel))
+        {
+            Ifx_Lwip_pollReceiveChannel((IfxGeth_RxDmaChannel)channel);
+        }
+#endif
+    }
+
+    if (ethFlags & IFX_LWIP_ETH_FLAG_LINK)
+    {
+        /* ask the PHY for the new link state */
+        IfxGeth_Eth_Phy_Rtl8211f_requestLinkStatus();
+    }
+
+    /* MDIO accesses of the PHY, the MAC follows the speed and duplex mode the PHY has negotiated */
+    ifx_netif_link_update(&g_Lwip.netif);
+
+    if ((ethFlags & IFX_LWIP_ETH_FLAG_TX) || (ifx_netif_tx_queued(&g_Lwip.netif) != 0))
+    {
+        /* release the pbufs of the transmitted frames and send the queued ones, the
+         * frames in a full ring may raise no Tx interrupt (IFX_LWIP_TX_COALESCE_FRAMES) */
+        ifx_netif_tx_complete(&g_Lwip.netif);
+    }
+}
+
+
+/** \brief Polling the Rx channels served by the calling CPU (IFX_LWIP_MULTICORE)
+ *
+ * Called from the main loop of every CPU: the frames of the channels whose interrupt
+ * is routed to this CPU (IFX_LWIP_RX_CHANNELn_CPU) are passed to the application
+ * callback or queued for the LwIP CPU. Does nothing without IFX_LWIP_MULTICORE.
+ */
+void Ifx_Lwip_pollRxWorker(void)
+{
+#if IFX_LWIP_MULTICORE
+    uint32 cpu = IfxCpu_getCoreIndex();
+    uint32 channel;
+
+    for (channel = 0; channel < IFX_LWIP_NUM_CHANNELS; channel++)
+    {
+        if ((Ifx_Lwip_rxChannelCpu[channel] == cpu) && (Ifx_Lwip_rxWorkerFlags[channel] != 0))
+        {
+            Ifx_Lwip_rxWorkerFlags[channel] = 0;
+            Ifx_Lwip_pollReceiveChannel((IfxGeth_RxDmaChannel)channel);
+        }
+    }
+#endif
 }
 
 #if LWIP_NETIF_EXT_STATUS_CALLBACK
@@ -400,6 +585,11 @@ void Ifx_Lwip_init(eth_addr_t ethAddr)
     netif_set_default(&g_Lwip.netif);
     netif_set_up(&g_Lwip.netif);
 
+#if IFX_LWIP_GPTP
+    /** - start the 802.1AS slave on it */
+    Ifx_Gptp_init(&g_Lwip.netif);
+#endif
+
 #if LWIP_NETIF_HOSTNAME
     g_Lwip.netif.hostname = BOARDNAME;
 #endif
@@ -418,6 +608,28 @@ void Ifx_Lwip_init(eth_addr_t ethAddr)
     LWIP_DEBUGF(IFX_LWIP_DEBUG, ("Ifx_Lwip_init end!\n"));
 }
 
+#if IFX_LWIP_VLAN_NETIFS > 0
+/** \brief Adds a netif on a further VLAN, after Ifx_Lwip_init()
+ *
+ * The netif shares the GETH and the MAC address with the default netif, it has
+ * its own addresses and multicast groups. The GETH tags its frames with *vlanTag
+ * and passes it the frames received on that VLAN.
+ * \param netif the netif, has to stay valid
+ * \param vlanTag VLAN tag (priority, DEI, VLAN ID), has to stay valid
+ * \return ERR_OK, ERR_VAL if ifx_netif_vlan_init() has refused the VLAN */
+err_t Ifx_Lwip_addVlanNetif(netif_t *netif, const u16_t *vlanTag, const ip_addr_t *ipAddr, const ip_addr_t *netMask, const ip_addr_t *gateway)
+{
+    if (netif_add(netif, ipAddr, netMask, gateway, (void *)vlanTag, ifx_netif_vlan_init, ethernet_input) == NULL)
+    {
+        return ERR_VAL;
+    }
+
+    netif_set_up(netif);
+
+    return ERR_OK;
+}
+#endif
+
 /** Returns the current time in milliseconds,
  * may be the same as sys_jiffies or at least based on it. */
 inline u32_t sys_now(void)
@@ -425,6 +637,51 @@ inline u32_t sys_now(void)
     return g_TickCount_1ms;
 }
 
+/** \brief Common part of the Tx interrupts: the pbufs of the completed descriptors are released from the main loop */
+static void Ifx_Lwip_onTxInterrupt(void)
+{
+    isrTxCount++;
+
+    /* the Rx interrupts may preempt us */
+    boolean interruptState = IfxCpu_disableInterrupts();
+    g_Lwip.ethFlags |= IFX_LWIP_ETH_FLAG_TX;
+    IfxCpu_restoreInterrupts(interruptState);
+}
+
+/** \brief Common part of the Rx interrupts */
+static void Ifx_Lwip_onRxInterrupt(IfxGeth_DmaChannel channel)
+{
+    isrRxCount++;
+
+    /* mask the Rx interrupt, the frames are handled by Ifx_Lwip_pollReceiveFlags()
+     * or, with IFX_LWIP_MULTICORE, by Ifx_Lwip_pollRxWorker() on this CPU */
+    boolean interruptState = IfxCpu_disableInterrupts();
+    IfxGeth_dma_disableInterrupt(g_IfxGeth.gethSFR, channel, IfxGeth_DmaInterruptFlag_receiveInterrupt);
+#if IFX_LWIP_MULTICORE
+    Ifx_Lwip_rxWorkerFlags[channel] = 1;
+#else
+    g_Lwip.ethFlags |= IFX_LWIP_ETH_FLAG_RX(channel);
+#endif
+    IfxCpu_restoreInterrupts(interruptState);
+}
+
+/**
+ * This interrupt is raised by a change of the RGMII link status. The initialization is done by low_level_init().
+ *
+ * \isrProvider \ref ISR_PROVIDER_ETH
+ * \isrPriority \ref ISR_PRIORITY_GETH_LINK
+ *
+ */
+IFX_INTERRUPT(ISR_Geth_Link, CPU_WHICH_SERVICE_ETHERNET, ISR_PRIORITY_GETH_LINK)
+{
+    /* reading the status clears the interrupt, the PHY is asked by Ifx_Lwip_pollReceiveFlags() */
+    (void)GETH_MAC_PHYIF_CONTROL_STATUS.U;
+
+    boolean interruptState = IfxCpu_disableInterrupts();
+    g_Lwip.ethFlags |= IFX_LWIP_ETH_FLAG_LINK;
+    IfxCpu_restoreInterrupts(interruptState);
+}
+
 /**
  * This interrupt is raised by the ethernet tx. The initialization is done by IfxGeth_Eth_init().
  *
@@ -434,7 +691,7 @@ inline u32_t sys_now(void)
  */
 IFX_INTERRUPT(ISR_Geth_Tx, CPU_WHICH_SERVICE_ETHERNET, ISR_PRIORITY_GETH_TX)
 {
-    isrTxCount++;
+    Ifx_Lwip_onTxInterrupt();
 }
 
 /**
@@ -444,12 +701,44 @@ IFX_INTERRUPT(ISR_Geth_Tx, CPU_WHICH_SERVICE_ETHERNET, ISR_PRIORITY_GETH_TX)
  * \isrPriority \ref ISR_PRIORITY_GETH_RX
  *
  */
-IFX_INTERRUPT(ISR_Geth_Rx, CPU_WHICH_SERVICE_ETHERNET, ISR_PRIORITY_GETH_RX)
+IFX_INTERRUPT(ISR_Geth_Rx, IFX_LWIP_RX_CHANNEL0_CPU, ISR_PRIORITY_GETH_RX)
 {
-    isrRxCount++;
-    ifx_netif_input(&g_Lwip.netif);
+    Ifx_Lwip_onRxInterrupt(IfxGeth_DmaChannel_0);
 }
 
+#if IFX_LWIP_NUM_CHANNELS > 1
+/* Tx and Rx interrupts of the DMA channels 1..3, see ISR_Geth_Tx and ISR_Geth_Rx */
+IFX_INTERRUPT(ISR_Geth_Tx1, CPU_WHICH_SERVICE_ETHERNET, ISR_PRIORITY_GETH_TX1)
+{
+    Ifx_Lwip_onTxInterrupt();
+}
+
+IFX_INTERRUPT(ISR_Geth_Tx2, CPU_WHICH_SERVICE_ETHERNET, ISR_PRIORITY_GETH_TX2)
+{
+    Ifx_Lwip_onTxInterrupt();
+}
+
+IFX_INTERRUPT(ISR_Geth_Tx3, CPU_WHICH_SERVICE_ETHERNET, ISR_PRIORITY_GETH_TX3)
+{
+    Ifx_Lwip_onTxInterrupt();
+}
+
+IFX_INTERRUPT(ISR_Geth_Rx1, IFX_LWIP_RX_CHANNEL1_CPU, ISR_PRIORITY_GETH_RX1)
+{
+    Ifx_Lwip_onRxInterrupt(IfxGeth_DmaChannel_1);
+}
+
+IFX_INTERRUPT(ISR_Geth_Rx2, IFX_LWIP_RX_CHANNEL2_CPU, ISR_PRIORITY_GETH_RX2)
+{
+    Ifx_Lwip_onRxInterrupt(IfxGeth_DmaChannel_2);
+}
+
+IFX_INTERRUPT(ISR_Geth_Rx3, IFX_LWIP_RX_CHANNEL3_CPU, ISR_PRIORITY_GETH_RX3)
+{
+    Ifx_Lwip_onRxInterrupt(IfxGeth_DmaChannel_3);
+}
+#endif
+
 //________________________________________________________________________________________
 // DEBUGGING FUNCTIONS
 #include "Configuration.h"
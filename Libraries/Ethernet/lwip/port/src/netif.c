@@ -90,11 +90,19 @@
 #include <lwip/snmp.h>
 #include "netif/etharp.h"
 #include "netif/ppp/pppoe.h"
+#include "lwip/prot/ip.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/tcp.h"
 
+#include <Cpu/Std/IfxCpu.h>
 #include "IfxGeth_Eth.h"
 #include "Ifx_Lwip.h"
 #include "Ifx_Netif.h"
+#include "Ifx_PbufRing.h"
 #include "IfxGeth_Phy_Rtl8211f.h"
+#if IFX_LWIP_GPTP
+#include "Ifx_Gptp.h"
+#endif
 #include "Configuration.h"
 #include <string.h>
 
@@ -102,6 +110,43 @@
 #define IFNAME0 'e'
 #define IFNAME1 'n'
 
+/* longest pbuf chain which is sent without copying, longer chains are copied into descriptor buffers */
+#define IFX_NETIF_TX_MAX_SEGMENTS LWIP_MIN(16, IFX_LWIP_TX_DESCRIPTORS - 1)
+
+/* bytes the DMA writes into the buffer of one Rx descriptor, a longer frame continues in the next one */
+#define IFX_NETIF_RX_BUFFER_LENGTH (IFXGETH_MAX_RX_BUFFER_SIZE - IFX_LWIP_RX_HEADROOM)
+
+/* descriptor buffers a copied frame of len bytes takes (several for a jumbo frame) */
+#define IFX_NETIF_TX_COPY_DESCRIPTORS(len) (((uint32)(len) + IFXGETH_MAX_TX_BUFFER_SIZE - 1) / IFXGETH_MAX_TX_BUFFER_SIZE)
+
+/* copy buffer of a Tx descriptor, the descriptors IFX_LWIP_TX_BUFFERS apart share it */
+#define IFX_NETIF_TX_BUFFER(channel, index) (&channelTxBuffer1[channel][(index) % IFX_LWIP_TX_BUFFERS][0])
+
+#if IFX_LWIP_MULTICORE
+/* slots of the return ring, a power of 2 which takes every receive buffer at once */
+#define IFX_NETIF_RX_RETURN_SLOTS ((IFX_LWIP_RX_BUFFER_COUNT <= 256) ? 256U : (IFX_LWIP_RX_BUFFER_COUNT <= 512) ? 512U : \
+                                   (IFX_LWIP_RX_BUFFER_COUNT <= 1024) ? 1024U : 2048U)
+#if IFX_LWIP_RX_BUFFER_COUNT > 2048
+#error "IFX_LWIP_RX_BUFFER_COUNT exceeds the return ring"
+#endif
+#endif
+
+/* multicast MAC addresses tracked by the driver, as many as lwIP can subscribe groups: the first
+ * IfxGeth_mac_getNumOfAddressFilters() slots are in the perfect filter, the MAC passes all multicast
+ * frames while a slot behind them (the overflow) is used */
+#define IFX_NETIF_MCAST_GROUPS ((LWIP_IGMP ? MEMP_NUM_IGMP_GROUP : 0) + ((LWIP_IPV6 && LWIP_IPV6_MLD) ? MEMP_NUM_MLD6_GROUP : 0))
+
+#if IFX_LWIP_RX_CHECKSUM_OFFLOAD
+/* the software checks which the GETH can take over, a received pbuf carries those it has
+ * done in its chksum_checked (LWIP_PBUF_CUSTOM_DATA) */
+#define IFX_NETIF_CHECKSUM_CHECK_L4    (NETIF_CHECKSUM_CHECK_UDP | NETIF_CHECKSUM_CHECK_TCP | NETIF_CHECKSUM_CHECK_ICMP)
+#endif
+
+#if IFX_LWIP_TX_CHECKSUM_OFFLOAD
+/* the checksums the GETH inserts into transmitted frames, lwIP leaves these fields zero */
+#define IFX_NETIF_CHECKSUM_GEN         (NETIF_CHECKSUM_GEN_IP | NETIF_CHECKSUM_GEN_UDP | NETIF_CHECKSUM_GEN_TCP | NETIF_CHECKSUM_GEN_ICMP)
+#endif
+
 /**
  * Helper struct to hold private data used to operate your ethernet interface.
  * Keeping the ethernet address of the MAC in this struct is not necessary
@@ -114,6 +159,178 @@ struct ethernetif
     /* Add whatever per-interface state that is needed here. */
 };
 
+#if IFX_LWIP_RX_ZERO_COPY
+/**
+ * Receive buffer which is handed to lwIP as a custom pbuf (zero-copy receive).
+ * One of these exists for every row of channelRxBuffer1[]. While lwIP holds
+ * the pbuf, the descriptor runs with a spare buffer from the recycle pool; the
+ * buffer goes back to the pool when lwIP frees the pbuf.
+ */
+typedef struct
+{
+    struct pbuf_custom pc;      /* must be the first member, lwIP casts the pbuf back to it */
+    uint8             *buffer;  /* start of the row in channelRxBuffer1[] */
+} Ifx_Netif_RxBuffer;
+#endif
+
+#if IFX_LWIP_MULTICORE
+/* link counters of the frames received by the CPU of a channel, written by that CPU only */
+typedef struct
+{
+    uint32 recv;
+    uint32 drop;
+    uint32 err;
+    uint32 memerr;
+} Ifx_Netif_RxStats;
+
+/* everything below up to the rxStats[] is shared by the Rx CPUs and the LwIP CPU: the data
+ * caches of the CPUs are not coherent, so it lives in the non-cached LMU */
+#if defined(__GNUC__)
+#pragma section ".lmubss_nc" aw
+#endif
+#if defined(__TASKING__)
+#pragma section farbss "lmubss_nc"
+#endif
+#endif
+
+#if IFX_LWIP_RX_ZERO_COPY
+static Ifx_Netif_RxBuffer  rxBuffers[IFX_LWIP_RX_BUFFER_COUNT];
+/* buffer currently armed in each descriptor of the rings */
+static Ifx_Netif_RxBuffer *rxArmed[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_RX_DESCRIPTORS];
+/* recycle pool, shared by all channels: buffers which are neither armed nor held by lwIP */
+static Ifx_Netif_RxBuffer *rxFree[IFX_LWIP_RX_BUFFER_COUNT];
+static uint32              rxFreeCount;
+#endif
+
+#if IFX_LWIP_MULTICORE
+/* the recycle pool is shared by the Rx CPUs and the LwIP CPU */
+static IfxCpu_spinLock     rxFreeLock;
+
+/* application callbacks running on the CPU of the channel */
+static Ifx_Netif_RxHook    rxHook[IFX_LWIP_NUM_CHANNELS];
+static void               *rxHookArg[IFX_LWIP_NUM_CHANNELS];
+
+/* frames on their way from the CPU of a channel to the LwIP CPU */
+static Ifx_PbufRing        rxRing[IFX_LWIP_NUM_CHANNELS] IFX_PBUFRING_ALIGN;
+static struct pbuf        *rxRingSlots[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_RX_RING_SIZE] IFX_PBUFRING_ALIGN;
+/* pbufs dropped by the Rx CPUs or released by their hooks, freed by the LwIP CPU */
+static Ifx_PbufRing        rxReturnRing IFX_PBUFRING_ALIGN;
+static struct pbuf        *rxReturnSlots[IFX_NETIF_RX_RETURN_SLOTS] IFX_PBUFRING_ALIGN;
+static Ifx_Netif_RxStats   rxStats[IFX_LWIP_NUM_CHANNELS];
+#if defined(__GNUC__)
+#pragma section
+#endif
+#if defined(__TASKING__)
+#pragma section farbss restore
+#endif
+
+/* rxStats[] as far as the LwIP CPU has added them to lwip_stats */
+static Ifx_Netif_RxStats   rxStatsSummed[IFX_LWIP_NUM_CHANNELS];
+
+/* low_level_input() runs on the CPU of the channel, lwip_stats belongs to the LwIP CPU */
+#define IFX_NETIF_RX_STATS_INC(channel, counter) (rxStats[channel].counter++)
+#else
+#define IFX_NETIF_RX_STATS_INC(channel, counter) LINK_STATS_INC(link.counter)
+#endif
+
+#if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
+/* multicast group subscribed by the stack, several IP groups may share one MAC address */
+typedef struct
+{
+    uint8  addr[ETHARP_HWADDR_LEN];
+    uint16 refCount;                /* 0: slot unused */
+} Ifx_Netif_McastGroup;
+
+static Ifx_Netif_McastGroup mcastGroups[IFX_NETIF_MCAST_GROUPS];   /* slot i < number of filters uses address filter i + 1 */
+static uint32               mcastOverflow;                          /* used slots without an address filter */
+#endif
+
+/* Tx descriptor bookkeeping per channel, completed descriptors are reclaimed by tx_reclaim() */
+static pbuf_t *txPbuf[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_TX_DESCRIPTORS];  /* frame referenced by its last descriptor until the DMA is done */
+static uint32  txDirty[IFX_LWIP_NUM_CHANNELS];                             /* oldest descriptor not yet reclaimed */
+static uint32  txPending[IFX_LWIP_NUM_CHANNELS];                           /* descriptors handed to the DMA and not yet reclaimed */
+static Ifx_Netif_TxErrors txErrors[IFX_LWIP_NUM_CHANNELS];                 /* frame status written back by the DMA */
+
+/* frame waiting for Tx descriptors, see low_level_output() */
+typedef struct
+{
+    pbuf_t *p;          /* the frame as lwIP has passed it */
+    u16_t   offset;     /* TCP segments of several MSS: first payload byte not handed to the DMA yet, 0: none */
+    u16_t   vlanTag;    /* VLAN tag the GETH inserts (tag control information of the netif), 0: untagged */
+} Ifx_Netif_TxFrame;
+
+#if IFX_LWIP_TX_QUEUE_LENGTH > 0
+/* frames lwIP has passed while the ring of their channel was full, each holding a reference */
+static Ifx_Netif_TxFrame txQueue[IFX_LWIP_NUM_CHANNELS][IFX_LWIP_TX_QUEUE_LENGTH];
+static uint32            txQueueHead[IFX_LWIP_NUM_CHANNELS];                /* oldest queued frame */
+static uint32            txQueueCount[IFX_LWIP_NUM_CHANNELS];
+#endif
+
+#if IFX_LWIP_VLAN_NETIFS > 0
+/* netifs on further VLANs, they share the GETH with the default netif (ifx_netif_vlan_init()) */
+typedef struct
+{
+    netif_t *netif;
+    u16_t    vlanTag;   /* tag control information: priority, DEI and VLAN ID */
+} Ifx_Netif_Vlan;
+
+static Ifx_Netif_Vlan vlanNetifs[IFX_LWIP_VLAN_NETIFS];
+static uint32         vlanNetifCount;
+#endif
+
+#if IFX_LWIP_TX_CHECKSUM_OFFLOAD
+/* the GETH inserts checksums only into frames its Tx queue holds completely, cleared
+ * by low_level_init() if not even the best effort queue can store and forward IFX_LWIP_MTU */
+static boolean txChecksumOffload = TRUE;
+/* channel of the frames with checksum insertion, by the channel of their priority:
+ * the best effort channel for a queue which can't store and forward */
+static IfxGeth_TxDmaChannel txChecksumChannel[IFX_LWIP_NUM_CHANNELS];
+#endif
+
+/* shares of the MTL FIFOs, see mtl_queue_sizes(): weight of each queue (by channel)
+ * and the order in which the queues get room for a full frame. The control queues
+ * carry small frames only (PTP, high priority), they get a frame and no share. */
+#if IFX_LWIP_NUM_CHANNELS > 1
+static const uint8 txQueueWeight[IFX_LWIP_NUM_CHANNELS] = {4, 2, 2, 0};
+static const uint8 txQueueOrder[IFX_LWIP_NUM_CHANNELS]  = {
+    IFX_LWIP_TX_CHANNEL_BEST_EFFORT, IFX_LWIP_TX_CHANNEL_STREAM_A, IFX_LWIP_TX_CHANNEL_STREAM_B, IFX_LWIP_TX_CHANNEL_CONTROL
+};
+static const uint8 rxQueueWeight[IFX_LWIP_NUM_CHANNELS] = {0, 2, 2, 4};
+static const uint8 rxQueueOrder[IFX_LWIP_NUM_CHANNELS]  = {
+    IFX_LWIP_CHANNEL_BULK, IFX_LWIP_CHANNEL_UNICAST, IFX_LWIP_CHANNEL_MULTICAST, IFX_LWIP_CHANNEL_CONTROL
+};
+#else
+static const uint8 txQueueWeight[IFX_LWIP_NUM_CHANNELS] = {1};
+static const uint8 txQueueOrder[IFX_LWIP_NUM_CHANNELS]  = {0};
+static const uint8 rxQueueWeight[IFX_LWIP_NUM_CHANNELS] = {1};
+static const uint8 rxQueueOrder[IFX_LWIP_NUM_CHANNELS]  = {0};
+#endif
+
+/* MAC configuration, follows the mode the PHY has negotiated (ifx_netif_link_update()) */
+static IfxGeth_LineSpeed  linkSpeed;
+static IfxGeth_DuplexMode linkDuplexMode;
+
+/* interrupt priorities of the DMA channels */
+static const uint16 gethTxIsrPriority[IFX_LWIP_NUM_CHANNELS] = {
+    ISR_PRIORITY_GETH_TX,
+#if IFX_LWIP_NUM_CHANNELS > 1
+    ISR_PRIORITY_GETH_TX1, ISR_PRIORITY_GETH_TX2, ISR_PRIORITY_GETH_TX3
+#endif
+};
+static const uint16 gethRxIsrPriority[IFX_LWIP_NUM_CHANNELS] = {
+    ISR_PRIORITY_GETH_RX,
+#if IFX_LWIP_NUM_CHANNELS > 1
+    ISR_PRIORITY_GETH_RX1, ISR_PRIORITY_GETH_RX2, ISR_PRIORITY_GETH_RX3
+#endif
+};
+/* CPUs serving the Rx interrupts */
+static const uint8 gethRxIsrCpu[IFX_LWIP_NUM_CHANNELS] = {
+    IFX_LWIP_RX_CHANNEL0_CPU,
+#if IFX_LWIP_NUM_CHANNELS > 1
+    IFX_LWIP_RX_CHANNEL1_CPU, IFX_LWIP_RX_CHANNEL2_CPU, IFX_LWIP_RX_CHANNEL3_CPU
+#endif
+};
+
 /* pin configuration RTL8211F */
 const IfxGeth_Eth_RgmiiPins rtl8211f_pins = {
                                    .txClk = &ETH_TXCLK_PIN,     /* TXCLK */
@@ -133,379 +350,2430 @@ const IfxGeth_Eth_RgmiiPins rtl8211f_pins = {
 		                           .grefClk = &ETH_GREFCLK_PIN  /* GREFCLK */
 };
 
+#if IFX_LWIP_RX_ZERO_COPY
 /**
- * In this function, the hardware should be initialized.
- * Called from ethernetif_init().
+ * Called by lwIP when a zero-copy receive pbuf is freed. May run from the main
+ * loop or from an interrupt, and with IFX_LWIP_MULTICORE on any of the CPUs,
+ * so the recycle pool is protected.
  *
- * @param netif the already initialized lwip network interface structure
- *        for this ethernetif
+ * @param p the custom pbuf which carried the receive buffer
  */
-static void low_level_init(netif_t *netif)
+static void rx_buffer_free(struct pbuf *p)
 {
-	IfxGeth_Eth *ethernetif = netif->state;
-    int     i;
+    Ifx_Netif_RxBuffer *rxBuffer = (Ifx_Netif_RxBuffer *)p;
 
-    /* set MAC hardware address length */
-    netif->hwaddr_len = ETHARP_HWADDR_LEN;
+    /* lwIP may have written into the buffer (e.g. an echo reply built in place),
+     * none of its lines may be written back once the DMA owns it again */
+    Ifx_Lwip_dmaFlush(rxBuffer->buffer, IFXGETH_MAX_RX_BUFFER_SIZE);
 
-    /* set MAC hardware address */
-    for (i = 0; i < ETHARP_HWADDR_LEN; i++)
+    boolean interruptState = IfxCpu_disableInterrupts();
+#if IFX_LWIP_MULTICORE
+    IfxCpu_setSpinLock(&rxFreeLock, 0xFFFF);
+#endif
+    rxFree[rxFreeCount++] = rxBuffer;
+#if IFX_LWIP_MULTICORE
+    IfxCpu_resetSpinLock(&rxFreeLock);
+#endif
+    IfxCpu_restoreInterrupts(interruptState);
+}
+
+/**
+ * Takes a buffer out of the recycle pool.
+ *
+ * @return the buffer, NULL if all spare buffers are held by lwIP
+ */
+static Ifx_Netif_RxBuffer *rx_buffer_alloc(void)
+{
+    Ifx_Netif_RxBuffer *rxBuffer = NULL;
+
+    boolean interruptState = IfxCpu_disableInterrupts();
+#if IFX_LWIP_MULTICORE
+    IfxCpu_setSpinLock(&rxFreeLock, 0xFFFF);
+#endif
+    if (rxFreeCount > 0)
     {
-        netif->hwaddr[i] = g_Lwip.eth_addr.addr[i];
+        rxBuffer = rxFree[--rxFreeCount];
     }
+#if IFX_LWIP_MULTICORE
+    IfxCpu_resetSpinLock(&rxFreeLock);
+#endif
+    IfxCpu_restoreInterrupts(interruptState);
 
-    /* maximum transfer unit */
-    netif->mtu = 1500;
+    return rxBuffer;
+}
 
-    /* device capabilities */
-    /* don't set NETIF_FLAG_ETHARP if this device is not an ethernet one */
-    /* we don't set the LINK_UP flag because we don't say when it is linked */
-    netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_IGMP;
+/**
+ * Assigns the rows of channelRxBuffer1[] to the descriptors of all channels and
+ * puts the rest into the pool. Must run after IfxGeth_Eth_initModule() and before
+ * the receivers are started: the descriptors are pointed at the rows behind the
+ * headroom (IfxGeth_Eth_initReceiveDescriptors() lines the buffers up by their
+ * DMA size, which is smaller than a row).
+ *
+ * @param ethernetif the GETH driver handle
+ */
+static void rx_buffer_init(IfxGeth_Eth *ethernetif)
+{
+    uint32 i;
 
-    /* Do whatever else is needed to initialize interface. */
+    rxFreeCount = 0;
+    for (i = 0; i < IFX_LWIP_RX_BUFFER_COUNT; i++)
     {
-    	IfxGeth_Eth_Config GethConfig;
+        rxBuffers[i].pc.custom_free_function = rx_buffer_free;
+        rxBuffers[i].buffer                  = &channelRxBuffer1[i][0];
 
-    	IfxGeth_Eth_initModuleConfig(&GethConfig, &MODULE_GETH);
-   		// this is our RTL8211F
-   		GethConfig.phyInterfaceMode = IfxGeth_PhyInterfaceMode_rgmii;
-        GethConfig.pins.rgmiiPins = &rtl8211f_pins;
-       	GethConfig.mac.lineSpeed = IfxGeth_LineSpeed_100Mbps;
-    	// MAC core configuration
-    	GethConfig.mac.loopbackMode = IfxGeth_LoopbackMode_disable;
-    	GethConfig.mac.macAddress[0] = netif->hwaddr[0];
-    	GethConfig.mac.macAddress[1] = netif->hwaddr[1];
-    	GethConfig.mac.macAddress[2] = netif->hwaddr[2];
-    	GethConfig.mac.macAddress[3] = netif->hwaddr[3];
-    	GethConfig.mac.macAddress[4] = netif->hwaddr[4];
-    	GethConfig.mac.macAddress[5] = netif->hwaddr[5];
+        if (i < (IFX_LWIP_NUM_CHANNELS * IFX_LWIP_RX_DESCRIPTORS))
+        {
+            IfxGeth_RxDmaChannel channel = (IfxGeth_RxDmaChannel)(i / IFX_LWIP_RX_DESCRIPTORS);
+            uint32               index   = i % IFX_LWIP_RX_DESCRIPTORS;
 
-    	// MTL configuration
-    	GethConfig.mtl.numOfTxQueues = 1;
-    	GethConfig.mtl.numOfRxQueues = 1;
-    	GethConfig.mtl.txQueue[0].txQueueSize = IfxGeth_QueueSize_2560Bytes;
-    	GethConfig.mtl.txQueue[0].storeAndForward = TRUE;
-    	GethConfig.mtl.rxQueue[0].rxQueueSize = IfxGeth_QueueSize_2560Bytes;
-    	GethConfig.mtl.rxQueue[0].rxDmaChannelMap = IfxGeth_RxDmaChannel_0;
-    	GethConfig.mtl.rxQueue[0].storeAndForward = TRUE;
-
-    	GethConfig.dma.numOfTxChannels = 1;
-    	GethConfig.dma.numOfRxChannels = 1;
-    	GethConfig.dma.txChannel[0].channelId = IfxGeth_TxDmaChannel_0;
-    	GethConfig.dma.txChannel[0].txDescrList = (IfxGeth_TxDescrList*)&IfxGeth_Eth_txDescrList[0];
-    	GethConfig.dma.txChannel[0].txBuffer1StartAddress = (uint32 *)&channel0TxBuffer1[0][0]; // user buffer
-    	GethConfig.dma.txChannel[0].txBuffer1Size = IFXGETH_MAX_TX_BUFFER_SIZE; // used to calculate the next descriptor  buffer offset
-
-    	GethConfig.dma.rxChannel[0].channelId = IfxGeth_RxDmaChannel_0;
-    	GethConfig.dma.rxChannel[0].rxDescrList = (IfxGeth_RxDescrList *)&IfxGeth_Eth_rxDescrList[0];
-    	GethConfig.dma.rxChannel[0].rxBuffer1StartAddress = (uint32 *)&channel0RxBuffer1[0][0]; // user buffer
-    	GethConfig.dma.rxChannel[0].rxBuffer1Size = IFXGETH_MAX_RX_BUFFER_SIZE; // user defined variable
+            rxArmed[channel][index] = &rxBuffers[i];
+            IfxGeth_Eth_getBaseRxDescriptor(ethernetif, channel)[index].RDES0.U = (uint32)&rxBuffers[i].buffer[IFX_LWIP_RX_HEADROOM];
+        }
+        else
+        {
+            rxFree[rxFreeCount++] = &rxBuffers[i];
+        }
+    }
+}
+#endif
 
-    	IfxSrc_Tos gethIsrProvider;
+#if IFX_LWIP_MULTICORE
+/**
+ * Looks into a received frame for the application callback: VLAN tag, Ethernet
+ * type, IPv4 protocol and the UDP/TCP destination port. Zero-copy pbufs hold
+ * the headers in their first pbuf (a receive buffer).
+ *
+ * @param p the received frame, starting with the padding word
+ * @param vlanTci the VLAN tag the GETH has stripped, 0 for untagged frames
+ * @param info filled with what has been found
+ */
+static void rx_classify(const pbuf_t *p, u16_t vlanTci, Ifx_Netif_RxInfo *info)
+{
+    const u8_t *frame = (const u8_t *)p->payload;
+    uint16      offset = ETH_PAD_SIZE + 12;
 
-        if (CPU_WHICH_SERVICE_ETHERNET) gethIsrProvider = (IfxSrc_Tos)(CPU_WHICH_SERVICE_ETHERNET+1);
-        else  gethIsrProvider = (IfxSrc_Tos)CPU_WHICH_SERVICE_ETHERNET;
+    memset(info, 0, sizeof(*info));
+    info->vlanTci = vlanTci;
 
-    	GethConfig.dma.txInterrupt[0].channelId = IfxGeth_DmaChannel_0;
-    	GethConfig.dma.txInterrupt[0].priority = ISR_PRIORITY_GETH_TX;	// priority
-    	GethConfig.dma.txInterrupt[0].provider = gethIsrProvider;
-    	GethConfig.dma.rxInterrupt[0].channelId = IfxGeth_DmaChannel_0;
-    	GethConfig.dma.rxInterrupt[0].priority = ISR_PRIORITY_GETH_RX;	// priority
-    	GethConfig.dma.rxInterrupt[0].provider = gethIsrProvider;
+    if (p->len < (offset + 2))
+    {
+        return;
+    }
 
+    info->ethType = (uint16)((frame[offset] << 8) | frame[offset + 1]);
+    offset       += 2;
 
-    	/* first we reset our phy manually, to make sure that the phy is ready when we init our module */
+    if ((info->ethType == ETHTYPE_VLAN) && (p->len >= (offset + 4)))
+    {
+        info->vlanTci = (uint16)((frame[offset] << 8) | frame[offset + 1]);
+        info->ethType = (uint16)((frame[offset + 2] << 8) | frame[offset + 3]);
+        offset       += 4;
+    }
+
+    info->l3Offset = offset;
+
+    if ((info->ethType == ETHTYPE_IP) && (p->len >= (offset + IP_HLEN)))
+    {
+        const u8_t *iphdr = &frame[offset];
+
+        info->ipProto = iphdr[9];
+
+        /* ports are only in the first fragment */
+        if ((((iphdr[6] & 0x1FU) | iphdr[7]) == 0) &&
+            ((info->ipProto == IP_PROTO_UDP) || (info->ipProto == IP_PROTO_TCP)))
         {
-        	IfxGeth_enableModule(&MODULE_GETH);
-        	IfxPort_setPinModeOutput(ETH_MDC_PIN.pin.port, ETH_MDC_PIN.pin.pinIndex, IfxPort_OutputMode_pushPull, ETH_MDC_PIN.select);
-            GETH_GPCTL.B.ALTI0  = ETH_MDIO_PIN.inSelect;
+            uint16 l4Offset = (uint16)(offset + ((iphdr[0] & 0x0FU) * 4U));
 
-            while (GETH_MAC_MDIO_ADDRESS.B.GB) {};
-            // first we wait that we are able to communicate with the Phy
-            do
+            if (p->len >= (l4Offset + 4))
             {
-            	GETH_MAC_MDIO_ADDRESS.U = (0 << 21) | (0 << 16) | (0 << 8) | (3 << 2) | (1 << 0);
-                while (GETH_MAC_MDIO_ADDRESS.B.GB) {};
-            } while (GETH_MAC_MDIO_DATA.U & 0x8000);                                                      // wait for reset to finish
-            // reset PHY
-            // put data
-        	GETH_MAC_MDIO_DATA.U = 0x8000;
-            GETH_MAC_MDIO_ADDRESS.U = (0 << 21) | (0 << 16) | (0 << 8) |  (1 << 2) | (1 << 0);
-            while (GETH_MAC_MDIO_ADDRESS.B.GB) {};
+                info->l4Offset = l4Offset;
+                info->dstPort  = (uint16)((frame[l4Offset + 2] << 8) | frame[l4Offset + 3]);
+            }
+        }
+    }
+}
+#endif
 
-            do
+#if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
+/**
+ * Reference counted multicast address filtering. A group keeps its slot while it is
+ * subscribed. The groups without an address filter (the overflow) make the MAC pass
+ * all multicast frames; when a filtered group is removed, an overflow group takes
+ * its address filter, and the passing ends with the last overflow group.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param addr multicast MAC address
+ * @param action NETIF_ADD_MAC_FILTER or NETIF_DEL_MAC_FILTER
+ * @return ERR_VAL if a group is removed which has not been added
+ *         ERR_MEM if all slots are used (more groups than lwIP has)
+ */
+static err_t mcast_filter(netif_t *netif, const uint8 *addr, enum netif_mac_filter_action action)
+{
+    IfxGeth_Eth *ethernetif   = netif->state;
+    Ifx_GETH    *gethSFR      = ethernetif->gethSFR;
+    uint32       numOfFilters = LWIP_MIN(IfxGeth_mac_getNumOfAddressFilters(gethSFR), IFX_NETIF_MCAST_GROUPS);
+    sint32       slot         = -1;
+    sint32       freeSlot     = -1;
+    uint32       i;
+
+    for (i = 0; i < IFX_NETIF_MCAST_GROUPS; i++)
+    {
+        if (mcastGroups[i].refCount == 0)
+        {
+            if (freeSlot < 0)
             {
-            	GETH_MAC_MDIO_ADDRESS.U = (0 << 21) | (0 << 16) | (0 << 8) | (3 << 2) | (1 << 0);
-                while (GETH_MAC_MDIO_ADDRESS.B.GB) {};
-            } while (GETH_MAC_MDIO_DATA.U & 0x8000);                                                      // wait for reset to finish
+                freeSlot = (sint32)i;
+            }
+        }
+        else if (memcmp(mcastGroups[i].addr, addr, ETHARP_HWADDR_LEN) == 0)
+        {
+            slot = (sint32)i;
+            break;
+        }
+    }
+
+    if (action == NETIF_ADD_MAC_FILTER)
+    {
+        if (slot >= 0)
+        {
+            mcastGroups[slot].refCount++;
+            return ERR_OK;
+        }
+
+        if (freeSlot < 0)
+        {
+            return ERR_MEM;
+        }
+
+        memcpy(mcastGroups[freeSlot].addr, addr, ETHARP_HWADDR_LEN);
+        mcastGroups[freeSlot].refCount = 1;
+
+        if ((uint32)freeSlot < numOfFilters)
+        {
+            IfxGeth_mac_setAddressFilter(gethSFR, (uint32)freeSlot + 1, addr, (IfxGeth_RxDmaChannel)IFX_LWIP_CHANNEL_MULTICAST);
+            return ERR_OK;
+        }
+
+        /* the first overflow group makes the MAC pass all multicast frames */
+        if (mcastOverflow++ == 0)
+        {
+            IfxGeth_mac_setAllMulticastPassing(gethSFR, TRUE);
+        }
+    }
+    else
+    {
+        if (slot < 0)
+        {
+            return ERR_VAL;
+        }
+
+        if (--mcastGroups[slot].refCount != 0)
+        {
+            return ERR_OK;
+        }
+
+        if ((uint32)slot >= numOfFilters)
+        {
+            mcastOverflow--;
+        }
+        else if (mcastOverflow == 0)
+        {
+            IfxGeth_mac_disableAddressFilter(gethSFR, (uint32)slot + 1);
+            return ERR_OK;
+        }
+        else
+        {
+            /* the address filter goes to an overflow group */
+            for (i = numOfFilters; mcastGroups[i].refCount == 0; i++)
+            {}
+
+            mcastGroups[slot]       = mcastGroups[i];
+            mcastGroups[i].refCount = 0;
+            mcastOverflow--;
+            IfxGeth_mac_setAddressFilter(gethSFR, (uint32)slot + 1, mcastGroups[slot].addr, (IfxGeth_RxDmaChannel)IFX_LWIP_CHANNEL_MULTICAST);
+        }
+
+        if (mcastOverflow == 0)
+        {
+            IfxGeth_mac_setAllMulticastPassing(gethSFR, FALSE);
+        }
+    }
+
+    return ERR_OK;
+}
+#endif
+
+#if LWIP_IGMP
+/**
+ * igmp_mac_filter of the netif: maps the IPv4 group to its MAC address (01:00:5E + 23 bits).
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param group the IPv4 multicast group
+ * @param action NETIF_ADD_MAC_FILTER or NETIF_DEL_MAC_FILTER
+ */
+static err_t low_level_igmp_mac_filter(netif_t *netif, const ip4_addr_t *group, enum netif_mac_filter_action action)
+{
+    u32_t group32 = lwip_ntohl(ip4_addr_get_u32(group));
+    uint8 addr[ETHARP_HWADDR_LEN];
+
+    addr[0] = 0x01;
+    addr[1] = 0x00;
+    addr[2] = 0x5E;
+    addr[3] = (uint8)((group32 >> 16) & 0x7FU);
+    addr[4] = (uint8)(group32 >> 8);
+    addr[5] = (uint8)group32;
+
+    return mcast_filter(netif, addr, action);
+}
+#endif
+
+#if LWIP_IPV6 && LWIP_IPV6_MLD
+/**
+ * mld_mac_filter of the netif: maps the IPv6 group to its MAC address (33:33 + 32 bits).
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param group the IPv6 multicast group
+ * @param action NETIF_ADD_MAC_FILTER or NETIF_DEL_MAC_FILTER
+ */
+static err_t low_level_mld_mac_filter(netif_t *netif, const ip6_addr_t *group, enum netif_mac_filter_action action)
+{
+    u32_t group32 = lwip_ntohl(group->addr[3]);
+    uint8 addr[ETHARP_HWADDR_LEN];
+
+    addr[0] = 0x33;
+    addr[1] = 0x33;
+    addr[2] = (uint8)(group32 >> 24);
+    addr[3] = (uint8)(group32 >> 16);
+    addr[4] = (uint8)(group32 >> 8);
+    addr[5] = (uint8)group32;
+
+    return mcast_filter(netif, addr, action);
+}
+#endif
+
+/**
+ * Programs the VLAN tag filter of the GETH with the VLAN IDs of the netifs:
+ * tagged frames of other VLANs are then dropped by the MAC. If the filters
+ * don't take all of them (or no netif is on a VLAN), the filter stays off and
+ * rx_vlan_if_idx() drops these frames.
+ *
+ * @param ethernetif the GETH driver handle
+ */
+static void vlan_filter_update(IfxGeth_Eth *ethernetif)
+{
+    Ifx_GETH *gethSFR      = ethernetif->gethSFR;
+    uint32    numOfFilters = IfxGeth_mac_getNumOfVlanFilters(gethSFR);
+    uint32    numOfVlans   = 0;
+    u16_t     vlanIds[1 + IFX_LWIP_VLAN_NETIFS];
+    uint32    i;
+
+    if ((IFX_LWIP_VLAN_TAG & 0x0FFFU) != 0)
+    {
+        vlanIds[numOfVlans++] = IFX_LWIP_VLAN_TAG & 0x0FFFU;
+    }
+
+#if IFX_LWIP_VLAN_NETIFS > 0
+    for (i = 0; i < vlanNetifCount; i++)
+    {
+        vlanIds[numOfVlans++] = vlanNetifs[i].vlanTag & 0x0FFFU;
+    }
+#endif
+
+    if ((numOfVlans == 0) || (numOfVlans > numOfFilters))
+    {
+        IfxGeth_mac_setVlanFiltering(gethSFR, FALSE);
+        return;
+    }
+
+    for (i = 0; i < numOfFilters; i++)
+    {
+        if (i < numOfVlans)
+        {
+            IfxGeth_mac_setVlanFilter(gethSFR, i, vlanIds[i]);
+        }
+        else
+        {
+            IfxGeth_mac_disableVlanFilter(gethSFR, i);
+        }
+    }
+
+    IfxGeth_mac_setVlanFiltering(gethSFR, TRUE);
+}
+
+
+/**
+ * Finds the netif of a received frame by the VLAN tag the GETH has stripped.
+ * Untagged and priority tagged frames belong to the default netif. Runs on
+ * the CPU of the Rx channel.
+ *
+ * @param netif the default netif
+ * @param vlanTci the stripped tag control information, 0 for untagged frames
+ * @return netif_get_index() of the netif, NETIF_NO_INDEX if no netif is on the VLAN
+ */
+static u8_t rx_vlan_if_idx(netif_t *netif, u16_t vlanTci)
+{
+    u16_t vlanId = vlanTci & 0x0FFFU;
+
+    if ((vlanId == 0) || (vlanId == (IFX_LWIP_VLAN_TAG & 0x0FFFU)))
+    {
+        return netif_get_index(netif);
+    }
+
+#if IFX_LWIP_VLAN_NETIFS > 0
+    {
+        uint32 i;
+
+        for (i = 0; i < vlanNetifCount; i++)
+        {
+            if ((vlanNetifs[i].vlanTag & 0x0FFFU) == vlanId)
+            {
+                return netif_get_index(vlanNetifs[i].netif);
+            }
+        }
+    }
+#endif
+
+    return NETIF_NO_INDEX;
+}
+
+
+/**
+ * Returns the VLAN tag the GETH inserts into the frames of a netif.
+ *
+ * @param netif the default netif or a VLAN netif
+ * @return tag control information, 0 for untagged frames
+ */
+static u16_t tx_vlan_tag(const netif_t *netif)
+{
+#if IFX_LWIP_VLAN_NETIFS > 0
+    uint32 i;
+
+    for (i = 0; i < vlanNetifCount; i++)
+    {
+        if (vlanNetifs[i].netif == netif)
+        {
+            return vlanNetifs[i].vlanTag;
+        }
+    }
+#else
+    (void)netif;
+#endif
+
+    return IFX_LWIP_VLAN_TAG;
+}
+
+/**
+ * Counts the transmit errors the DMA has written back into the last descriptor
+ * of a frame.
+ *
+ * @param channel the Tx DMA channel
+ * @param descr the last descriptor of the frame, in write-back format
+ */
+static void tx_record_errors(IfxGeth_TxDmaChannel channel, volatile IfxGeth_TxDescr *descr)
+{
+    Ifx_Netif_TxErrors *errors = &txErrors[channel];
+
+    errors->frames++;
+
+    if (descr->TDES3.W.ES == 0)
+    {
+        return;
+    }
+
+    errors->errors++;
+    errors->lastStatus = descr->TDES3.U;
+    errors->underflow += descr->TDES3.W.UF;
+    errors->carrier   += descr->TDES3.W.NC | descr->TDES3.W.LOC;
+    errors->collision += descr->TDES3.W.EC | descr->TDES3.W.LC | descr->TDES3.W.ED;
+    errors->checksum  += descr->TDES3.W.IHE | descr->TDES3.W.PCE;
+    errors->flushed   += descr->TDES3.W.FF;
+    errors->jabber    += descr->TDES3.W.JT;
+
+    LINK_STATS_INC(link.err);
+    LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_LEVEL_WARNING, ("tx_reclaim: channel %d, frame error, TDES3 %#x\n", channel, errors->lastStatus));
+}
+
+#if IFX_LWIP_PTP
+/**
+ * Returns whether the transmit timestamp of a frame has been requested.
+ *
+ * @param p the frame
+ * @return TRUE if a pbuf of the chain has IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP set
+ */
+static boolean tx_timestamp_requested(const pbuf_t *p)
+{
+    for (; p != NULL; p = p->next)
+    {
+        if ((p->flags & IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP) != 0)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * Stores the transmit timestamp of a frame into the pbufs which have requested
+ * it, and clears their request. Without a timestamp (e.g. the frame has been
+ * flushed) they are left at 0.
+ *
+ * @param p the frame
+ * @param descr its last descriptor, released by the DMA
+ */
+static void tx_store_timestamp(pbuf_t *p, volatile IfxGeth_TxDescr *descr)
+{
+    IfxGeth_Eth_Timestamp timestamp = {0, 0};
+
+    IfxGeth_Eth_getTxTimestamp(descr, &timestamp);
+
+    for (; p != NULL; p = p->next)
+    {
+        if ((p->flags & IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP) != 0)
+        {
+            p->ts_sec   = timestamp.seconds;
+            p->ts_nsec  = timestamp.nanoseconds;
+            p->flags   &= (u8_t)~IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP;
+        }
+    }
+}
+#endif
+
+/**
+ * Reclaims the Tx descriptors which the DMA has released, records the status
+ * of their frames and frees the pbufs they referenced.
+ *
+ * @param ethernetif the GETH driver handle
+ * @param channel the Tx DMA channel
+ */
+static void tx_reclaim(IfxGeth_Eth *ethernetif, IfxGeth_TxDmaChannel channel)
+{
+    volatile IfxGeth_TxDescr *base = IfxGeth_Eth_getBaseTxDescriptor(ethernetif, channel);
+
+    while ((txPending[channel] > 0) && (base[txDirty[channel]].TDES3.R.OWN == 0))
+    {
+        pbuf_t *p = txPbuf[channel][txDirty[channel]];
+
+        if ((base[txDirty[channel]].TDES3.W.CTXT == 0) && (base[txDirty[channel]].TDES3.W.LD != 0))
+        {
+            tx_record_errors(channel, &base[txDirty[channel]]);
+#if IFX_LWIP_PTP
+            if (p != NULL)
+            {
+                tx_store_timestamp(p, &base[txDirty[channel]]);
+            }
+#endif
+        }
+
+        txPbuf[channel][txDirty[channel]] = NULL;
+        txDirty[channel]                  = (txDirty[channel] + 1) % IFX_LWIP_TX_DESCRIPTORS;
+        txPending[channel]--;
+
+        if (p != NULL)
+        {
+            pbuf_free(p);
+        }
+    }
+}
+
+/* Tx DMA channel (and so MTL Tx queue) of each priority 0..7 */
+static const IfxGeth_TxDmaChannel txPriorityChannel[8] = {
+    (IfxGeth_TxDmaChannel)IFX_LWIP_TX_CHANNEL_BEST_EFFORT, (IfxGeth_TxDmaChannel)IFX_LWIP_TX_CHANNEL_BEST_EFFORT,
+    (IfxGeth_TxDmaChannel)IFX_LWIP_TX_CHANNEL_STREAM_B,    (IfxGeth_TxDmaChannel)IFX_LWIP_TX_CHANNEL_STREAM_A,
+    (IfxGeth_TxDmaChannel)IFX_LWIP_TX_CHANNEL_CONTROL,     (IfxGeth_TxDmaChannel)IFX_LWIP_TX_CHANNEL_CONTROL,
+    (IfxGeth_TxDmaChannel)IFX_LWIP_TX_CHANNEL_CONTROL,     (IfxGeth_TxDmaChannel)IFX_LWIP_TX_CHANNEL_CONTROL
+};
+
+/**
+ * Returns the priority (802.1Q user priority 0..7) of a frame: the priority of
+ * the UDP pcb which has sent it (udp_set_priority()), otherwise the IP precedence
+ * of an IPv4 frame. PTP messages get the highest priority, the residence time in
+ * the queue delays them. The priority selects the Tx queue and is sent in the
+ * VLAN tag.
+ *
+ * @param p the frame as lwIP passes it (the Ethernet header including the padding)
+ * @return the priority
+ */
+static u8_t tx_priority(const pbuf_t *p)
+{
+    const eth_hdr_t *ethhdr = (const eth_hdr_t *)p->payload;
+
+#if IFX_LWIP_PTP
+    if (ethhdr->type == PP_HTONS(ETHTYPE_PTP))
+    {
+        return 7;
+    }
+#endif
+
+#if LWIP_UDP_PRIORITY
+    if (p->priority != 0)
+    {
+        return p->priority;
+    }
+#endif
+
+    if ((ethhdr->type == PP_HTONS(ETHTYPE_IP)) && (p->len > (SIZEOF_ETH_HDR + 1)))
+    {
+        return ((const uint8 *)p->payload)[SIZEOF_ETH_HDR + 1] >> 5;
+    }
+
+    return 0;
+}
+
+#if (IFX_LWIP_TX_CBS_CLASS_A_SLOPE > 0) || (IFX_LWIP_TX_CBS_CLASS_B_SLOPE > 0)
+/**
+ * Programs the credit-based shapers (IEEE 802.1Qav) of the SR class A and B
+ * queues for the line speed. The slopes are given in kbit/s, the GETH counts
+ * the credit in bits * 1024 per cycle of the Tx clock (4 bits per cycle at
+ * 10/100 Mbit/s, 8 bits at 1000 Mbit/s). The reservations are limited to 75 %
+ * of the line rate, class A first. The high credit is the credit a class can
+ * gain while a maximum sized frame of a lower class (and for class B also one
+ * of class A) is sent, the low credit the credit it loses with its own maximum
+ * sized frame.
+ *
+ * @param ethernetif the GETH driver
+ * @param speed the line speed the MAC runs
+ */
+static void tx_shaper_update(IfxGeth_Eth *ethernetif, IfxGeth_LineSpeed speed)
+{
+    uint64 portRate     = (speed == IfxGeth_LineSpeed_1000Mbps) ? 1000000U : ((speed == IfxGeth_LineSpeed_100Mbps) ? 100000U : 10000U);
+    uint64 bitsPerCycle = (speed == IfxGeth_LineSpeed_1000Mbps) ? 8U : 4U;
+    uint64 maxFrame     = (uint64)IFX_LWIP_MAX_FRAME_SIZE * 8U * 1024U;
+    uint64 reservable   = portRate * 3U / 4U;
+    uint64 idleA        = LWIP_MIN((uint64)IFX_LWIP_TX_CBS_CLASS_A_SLOPE, reservable);
+    uint64 idleB        = LWIP_MIN((uint64)IFX_LWIP_TX_CBS_CLASS_B_SLOPE, reservable - idleA);
+
+    if (idleA > 0)
+    {
+        uint64 sendA = portRate - idleA;
+
+        IfxGeth_mtl_setTxQueueCreditBasedShaper(ethernetif->gethSFR, (IfxGeth_TxMtlQueue)IFX_LWIP_TX_CHANNEL_STREAM_A,
+                                                (uint32)(idleA * 1024U * bitsPerCycle / portRate),
+                                                (uint32)(sendA * 1024U * bitsPerCycle / portRate),
+                                                (uint32)(maxFrame * idleA / portRate),
+                                                -(sint32)(maxFrame * sendA / portRate));
+    }
+
+    if (idleB > 0)
+    {
+        uint64 sendB = portRate - idleB;
+
+        IfxGeth_mtl_setTxQueueCreditBasedShaper(ethernetif->gethSFR, (IfxGeth_TxMtlQueue)IFX_LWIP_TX_CHANNEL_STREAM_B,
+                                                (uint32)(idleB * 1024U * bitsPerCycle / portRate),
+                                                (uint32)(sendB * 1024U * bitsPerCycle / portRate),
+                                                (uint32)((maxFrame * idleB / (portRate - idleA)) + (maxFrame * idleB / portRate)),
+                                                -(sint32)(maxFrame * sendB / portRate));
+    }
+}
+#endif
+
+/**
+ * Sets the checksum generation of a netif and NETIF_FLAG_TSO, as far as the GETH
+ * takes them over (txChecksumOffload).
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ */
+static void tx_offload_init(netif_t *netif)
+{
+#if IFX_LWIP_TX_CHECKSUM_OFFLOAD
+    if (txChecksumOffload)
+    {
+        /* the checksums of transmitted frames are inserted by the GETH (see low_level_output()),
+         * except the L4 checksum of a fragmented datagram which ip4.c still generates */
+        NETIF_SET_CHECKSUM_CTRL(netif, netif->chksum_flags & ~IFX_NETIF_CHECKSUM_GEN);
+#if IFX_LWIP_TX_TSO
+        /* lwIP passes TCP segments of several MSS, tx_segment_tcp() cuts them into frames */
+        netif->flags |= NETIF_FLAG_TSO;
+#endif
+    }
+    else
+    {
+        /* lwIP generates the checksums, a TCP segment is one frame */
+        NETIF_SET_CHECKSUM_CTRL(netif, netif->chksum_flags | IFX_NETIF_CHECKSUM_GEN);
+        netif->flags &= (u8_t)~NETIF_FLAG_TSO;
+    }
+#else
+    LWIP_UNUSED_ARG(netif);
+#endif
+}
+
+
+/**
+ * Splits an MTL FIFO into the queues, in steps of 256 bytes. Every queue gets one
+ * step, then the queues in the given order get room for a full frame (store and
+ * forward) as long as the FIFO has it, the rest is shared by weight. A queue
+ * takes 8 KB at most.
+ *
+ * @param fifoSize size of the FIFO in bytes
+ * @param weight share of each queue
+ * @param order the queues by precedence for a full frame
+ * @param queueSize set to the size of each queue in bytes
+ */
+static void mtl_queue_sizes(uint32 fifoSize, const uint8 *weight, const uint8 *order, uint32 *queueSize)
+{
+    uint32 units      = LWIP_MIN(fifoSize, IFX_LWIP_NUM_CHANNELS * 8192U) / 256U;
+    uint32 frameUnits = (IFX_LWIP_MAX_FRAME_SIZE + 255U) / 256U;
+    uint32 left       = (units > IFX_LWIP_NUM_CHANNELS) ? (units - IFX_LWIP_NUM_CHANNELS) : 0;
+    uint32 spread;
+    uint32 weights    = 0;
+    uint32 i;
+
+    for (i = 0; i < IFX_LWIP_NUM_CHANNELS; i++)
+    {
+        queueSize[i] = 1;
+        weights     += weight[i];
+    }
+
+    for (i = 0; i < IFX_LWIP_NUM_CHANNELS; i++)
+    {
+        if ((frameUnits <= 32U) && (left >= (frameUnits - 1U)))
+        {
+            queueSize[order[i]] = frameUnits;
+            left               -= frameUnits - 1U;
+        }
+    }
+
+    spread = left;
+    for (i = 0; i < IFX_LWIP_NUM_CHANNELS; i++)
+    {
+        uint32 extra = LWIP_MIN((spread * weight[i]) / weights, 32U - queueSize[i]);
+
+        queueSize[i] += extra;
+        left         -= extra;
+    }
+
+    /* what the rounding leaves goes to the first queues in the order */
+    for (i = 0; (i < IFX_LWIP_NUM_CHANNELS) && (left > 0); i++)
+    {
+        uint32 extra = LWIP_MIN(left, 32U - queueSize[order[i]]);
+
+        queueSize[order[i]] += extra;
+        left                -= extra;
+    }
+
+    for (i = 0; i < IFX_LWIP_NUM_CHANNELS; i++)
+    {
+        queueSize[i] *= 256U;
+    }
+}
+
+
+/**
+ * Sets up the lwIP side of a netif on the GETH: addresses, capabilities and
+ * offloads. Shared by the default netif and the VLAN netifs.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ */
+static void low_level_init_netif(netif_t *netif)
+{
+    int i;
+
+    /* set MAC hardware address length */
+    netif->hwaddr_len = ETHARP_HWADDR_LEN;
+
+    /* set MAC hardware address */
+    for (i = 0; i < ETHARP_HWADDR_LEN; i++)
+    {
+        netif->hwaddr[i] = g_Lwip.eth_addr.addr[i];
+    }
+
+    /* maximum transfer unit, frames longer than one buffer span several descriptors */
+    netif->mtu = IFX_LWIP_MTU;
+
+    /* device capabilities */
+    /* don't set NETIF_FLAG_ETHARP if this device is not an ethernet one */
+    /* we don't set the LINK_UP flag because we don't say when it is linked */
+    netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_IGMP;
+
+    /* only the subscribed multicast groups pass the MAC */
+#if LWIP_IGMP
+    netif_set_igmp_mac_filter(netif, low_level_igmp_mac_filter);
+#endif
+#if LWIP_IPV6 && LWIP_IPV6_MLD
+    netif->flags |= NETIF_FLAG_MLD6;
+    netif_set_mld_mac_filter(netif, low_level_mld_mac_filter);
+#endif
+
+    tx_offload_init(netif);
+}
+
+
+/**
+ * In this function, the hardware should be initialized.
+ * Called from ethernetif_init().
+ *
+ * @param netif the already initialized lwip network interface structure
+ *        for this ethernetif
+ */
+static void low_level_init(netif_t *netif)
+{
+	IfxGeth_Eth *ethernetif = netif->state;
+    int     i;
+
+    low_level_init_netif(netif);
+
+    /* Do whatever else is needed to initialize interface. */
+    {
+    	IfxGeth_Eth_Config GethConfig;
+
+    	IfxGeth_Eth_initModuleConfig(&GethConfig, &MODULE_GETH);
+   		// this is our RTL8211F
+   		GethConfig.phyInterfaceMode = IfxGeth_PhyInterfaceMode_rgmii;
+        GethConfig.pins.rgmiiPins = &rtl8211f_pins;
+       	GethConfig.mac.lineSpeed = IfxGeth_LineSpeed_1000Mbps;   // until the PHY reports the negotiated speed
+       	GethConfig.mac.duplexMode = IfxGeth_DuplexMode_fullDuplex;
+    	GethConfig.mac.maxPacketSize = IFX_LWIP_MTU + 18;    // Ethernet header and CRC, 9018: jumbo frames (the MAC adds 4 bytes for a VLAN tag)
+    	// MAC core configuration
+    	GethConfig.mac.loopbackMode = IfxGeth_LoopbackMode_disable;
+    	GethConfig.mac.macAddress[0] = netif->hwaddr[0];
+    	GethConfig.mac.macAddress[1] = netif->hwaddr[1];
+    	GethConfig.mac.macAddress[2] = netif->hwaddr[2];
+    	GethConfig.mac.macAddress[3] = netif->hwaddr[3];
+    	GethConfig.mac.macAddress[4] = netif->hwaddr[4];
+    	GethConfig.mac.macAddress[5] = netif->hwaddr[5];
+    	// destination address filtering: own address, broadcast and the multicast groups set by low_level_igmp_mac_filter()
+    	GethConfig.mac.promiscuousMode = FALSE;
+    	GethConfig.mac.passAllMulticast = FALSE;
+#if IFX_LWIP_RX_CHECKSUM_OFFLOAD
+    	GethConfig.mac.rxChecksumOffloadEnabled = TRUE;
+#endif
+    	// VLAN tags are inserted and stripped by the MAC, lwIP only sees untagged frames (see tx_vlan_tag(), rx_vlan_if_idx())
+    	GethConfig.mac.vlanTagging = TRUE;
+#if IFX_LWIP_PTP
+    	// system time and timestamps, the received ones are passed in the pbufs (low_level_input())
+    	GethConfig.mac.timestampingEnabled = TRUE;
+    	GethConfig.mac.timestampAllPackets = IFX_LWIP_PTP_RX_ALL;
+#endif
+
+    	// MTL configuration, one queue per DMA channel (the queue sizes are set below)
+    	GethConfig.mtl.numOfTxQueues = IFX_LWIP_NUM_CHANNELS;
+    	GethConfig.mtl.numOfRxQueues = IFX_LWIP_NUM_CHANNELS;
+    	GethConfig.mtl.txSchedulingAlgorithm = IfxGeth_TxSchedulingAlgorithm_sp; // the highest queue first
+    	GethConfig.mtl.rxArbitrationAlgorithm = IfxGeth_RxArbitrationAlgorithm_sp; // queue 0 (control) first
+#if IFX_LWIP_NUM_CHANNELS > 1
+    	// Rx steering: the queues are drained by their own DMA channel, a heavy flow only fills its own queue and ring
+    	GethConfig.mtl.rxQueue[IFX_LWIP_CHANNEL_CONTROL].vlanPriorities = 0xF0; // user priority 4..7
+    	GethConfig.mtl.rxQueue[IFX_LWIP_CHANNEL_BULK].vlanPriorities = 0x0F; // user priority 0..3
+    	GethConfig.mtl.untaggedPacketQueue = (IfxGeth_RxMtlQueue)IFX_LWIP_CHANNEL_UNICAST;
+    	GethConfig.mtl.multicastBroadcastQueueEnabled = TRUE; // by destination address, ahead of the VLAN priority
+    	GethConfig.mtl.multicastBroadcastQueue = (IfxGeth_RxMtlQueue)IFX_LWIP_CHANNEL_MULTICAST;
+#endif
+
+    	GethConfig.dma.numOfTxChannels = IFX_LWIP_NUM_CHANNELS;
+    	GethConfig.dma.numOfRxChannels = IFX_LWIP_NUM_CHANNELS;
+
+    	IfxSrc_Tos gethIsrProvider;
+
+        if (CPU_WHICH_SERVICE_ETHERNET) gethIsrProvider = (IfxSrc_Tos)(CPU_WHICH_SERVICE_ETHERNET+1);
+        else  gethIsrProvider = (IfxSrc_Tos)CPU_WHICH_SERVICE_ETHERNET;
+
+        for (i = 0; i < IFX_LWIP_NUM_CHANNELS; i++)
+        {
+        	GethConfig.mtl.rxQueue[i].rxDmaChannelMap = (IfxGeth_RxDmaChannel)i;
+
+        	GethConfig.dma.txChannel[i].channelId = (IfxGeth_TxDmaChannel)i;
+        	GethConfig.dma.txChannel[i].txDescrList = (IfxGeth_TxDescrList*)&channelTxDescr[i][0];
+        	GethConfig.dma.txChannel[i].numOfDescriptors = IFX_LWIP_TX_DESCRIPTORS;
+        	GethConfig.dma.txChannel[i].txBuffer1StartAddress = (uint32 *)&channelTxBuffer1[i][0][0]; // user buffer
+        	GethConfig.dma.txChannel[i].txBuffer1Size = IFXGETH_MAX_TX_BUFFER_SIZE; // used to calculate the next descriptor  buffer offset
+        	GethConfig.dma.txChannel[i].interruptFrameCount = IFX_LWIP_TX_COALESCE_FRAMES; // the pbufs of the frames in between are reclaimed later
+
+        	GethConfig.dma.rxChannel[i].channelId = (IfxGeth_RxDmaChannel)i;
+        	GethConfig.dma.rxChannel[i].rxDescrList = (IfxGeth_RxDescrList *)&channelRxDescr[i][0];
+        	GethConfig.dma.rxChannel[i].numOfDescriptors = IFX_LWIP_RX_DESCRIPTORS;
+        	GethConfig.dma.rxChannel[i].rxBuffer1StartAddress = (uint32 *)&channelRxBuffer1[i * IFX_LWIP_RX_DESCRIPTORS][IFX_LWIP_RX_HEADROOM]; // user buffer
+        	GethConfig.dma.rxChannel[i].rxBuffer1Size = IFX_NETIF_RX_BUFFER_LENGTH; // the headroom is not available to the DMA
+        	GethConfig.dma.rxChannel[i].interruptWatchdogTime = IFX_LWIP_RX_COALESCE_TIME;
+        	GethConfig.dma.rxChannel[i].interruptFrameCount = IFX_LWIP_RX_COALESCE_FRAMES;
+        	GethConfig.dma.rxChannel[i].adaptiveCoalescing = IFX_LWIP_RX_COALESCE_ADAPTIVE;
+
+        	GethConfig.dma.txInterrupt[i].channelId = (IfxGeth_DmaChannel)i;
+        	GethConfig.dma.txInterrupt[i].priority = gethTxIsrPriority[i];	// priority
+        	GethConfig.dma.txInterrupt[i].provider = gethIsrProvider;
+        	GethConfig.dma.rxInterrupt[i].channelId = (IfxGeth_DmaChannel)i;
+        	GethConfig.dma.rxInterrupt[i].priority = gethRxIsrPriority[i];	// priority
+        	GethConfig.dma.rxInterrupt[i].provider = gethRxIsrCpu[i] ? (IfxSrc_Tos)(gethRxIsrCpu[i] + 1) : IfxSrc_Tos_cpu0;
+        }
+
+
+    	/* first we reset our phy manually, to make sure that the phy is ready when we init our module */
+        {
+        	IfxGeth_enableModule(&MODULE_GETH);
+        	IfxPort_setPinModeOutput(ETH_MDC_PIN.pin.port, ETH_MDC_PIN.pin.pinIndex, IfxPort_OutputMode_pushPull, ETH_MDC_PIN.select);
+            GETH_GPCTL.B.ALTI0  = ETH_MDIO_PIN.inSelect;
+
+            while (GETH_MAC_MDIO_ADDRESS.B.GB) {};
+            // first we wait that we are able to communicate with the Phy
+            do
+            {
+            	GETH_MAC_MDIO_ADDRESS.U = (0 << 21) | (0 << 16) | (0 << 8) | (3 << 2) | (1 << 0);
+                while (GETH_MAC_MDIO_ADDRESS.B.GB) {};
+            } while (GETH_MAC_MDIO_DATA.U & 0x8000);                                                      // wait for reset to finish
+            // reset PHY
+            // put data
+        	GETH_MAC_MDIO_DATA.U = 0x8000;
+            GETH_MAC_MDIO_ADDRESS.U = (0 << 21) | (0 << 16) | (0 << 8) |  (1 << 2) | (1 << 0);
+            while (GETH_MAC_MDIO_ADDRESS.B.GB) {};
+
+            do
+            {
+            	GETH_MAC_MDIO_ADDRESS.U = (0 << 21) | (0 << 16) | (0 << 8) | (3 << 2) | (1 << 0);
+                while (GETH_MAC_MDIO_ADDRESS.B.GB) {};
+            } while (GETH_MAC_MDIO_DATA.U & 0x8000);                                                      // wait for reset to finish
+        }
+
+        /* the FIFOs are shared by weight, a queue needs a full frame for store and forward:
+         * the bulk queues get the most, the control queues the least */
+        {
+        	uint32 txQueueSize[IFX_LWIP_NUM_CHANNELS];
+        	uint32 rxQueueSize[IFX_LWIP_NUM_CHANNELS];
+
+        	mtl_queue_sizes(IfxGeth_mtl_getTxFifoSize(&MODULE_GETH), txQueueWeight, txQueueOrder, txQueueSize);
+        	mtl_queue_sizes(IfxGeth_mtl_getRxFifoSize(&MODULE_GETH), rxQueueWeight, rxQueueOrder, rxQueueSize);
+
+        	for (i = 0; i < IFX_LWIP_NUM_CHANNELS; i++)
+        	{
+        		GethConfig.mtl.txQueue[i].txQueueSize = (IfxGeth_QueueSize)((txQueueSize[i] / 256) - 1); // 256 byte steps
+        		GethConfig.mtl.rxQueue[i].rxQueueSize = (IfxGeth_QueueSize)((rxQueueSize[i] / 256) - 1);
+
+        		// a queue too small for a frame passes it on while it is still coming in (threshold mode)
+        		GethConfig.mtl.txQueue[i].storeAndForward = (boolean)(txQueueSize[i] >= IFX_LWIP_MAX_FRAME_SIZE);
+        		GethConfig.mtl.rxQueue[i].storeAndForward = (boolean)(rxQueueSize[i] >= IFX_LWIP_MAX_FRAME_SIZE);
+        		LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_STATE, ("low_level_init: queue %d, Tx %d bytes%s, Rx %d bytes%s\n", i,
+        			txQueueSize[i], GethConfig.mtl.txQueue[i].storeAndForward ? "" : " (threshold)",
+        			rxQueueSize[i], GethConfig.mtl.rxQueue[i].storeAndForward ? "" : " (threshold)"));
+        	}
+
+#if IFX_LWIP_TX_CHECKSUM_OFFLOAD
+        	// the GETH inserts no checksum into a frame its queue can't hold completely
+        	if (GethConfig.mtl.txQueue[IFX_LWIP_TX_CHANNEL_BEST_EFFORT].storeAndForward)
+        	{
+        		for (i = 0; i < IFX_LWIP_NUM_CHANNELS; i++)
+        		{
+        			txChecksumChannel[i] = GethConfig.mtl.txQueue[i].storeAndForward ? (IfxGeth_TxDmaChannel)i : (IfxGeth_TxDmaChannel)IFX_LWIP_TX_CHANNEL_BEST_EFFORT;
+
+        			if (txChecksumChannel[i] != (IfxGeth_TxDmaChannel)i)
+        			{
+        				LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_STATE | LWIP_DBG_LEVEL_WARNING, ("low_level_init: Tx queue %d holds no full frame, "
+        					"its frames with checksum insertion go to queue %d\n", i, IFX_LWIP_TX_CHANNEL_BEST_EFFORT));
+        			}
+        		}
+        	}
+        	else
+        	{
+        		// lwIP generates the checksums and sends no segments of several MSS
+        		for (i = 0; i < IFX_LWIP_NUM_CHANNELS; i++)
+        		{
+        			txChecksumChannel[i] = (IfxGeth_TxDmaChannel)i;
+        		}
+        		txChecksumOffload = FALSE;
+        		tx_offload_init(netif);
+        		LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_STATE | LWIP_DBG_LEVEL_WARNING, ("low_level_init: Tx FIFO too small for a full frame, "
+        			"Tx checksum offload%s disabled\n", IFX_LWIP_TX_TSO ? " and TSO" : ""));
+        	}
+#endif
+        }
+
+        // initialize the module
+    	IfxGeth_Eth_initModule(ethernetif, &GethConfig);
+#if IFX_LWIP_TX_BUFFERS < IFX_LWIP_TX_DESCRIPTORS
+    	// IfxGeth_Eth_initTransmitDescriptors() has lined up one buffer per descriptor, the descriptors share them
+    	for (i = 0; i < IFX_LWIP_NUM_CHANNELS; i++)
+    	{
+    		uint32 d;
+
+    		for (d = 0; d < IFX_LWIP_TX_DESCRIPTORS; d++)
+    		{
+    			IfxGeth_Eth_getBaseTxDescriptor(ethernetif, (IfxGeth_TxDmaChannel)i)[d].TDES0.U = (uint32)IFX_NETIF_TX_BUFFER(i, d);
+    		}
+    	}
+#endif
+    	vlan_filter_update(ethernetif);
+#if (IFX_LWIP_TX_CBS_CLASS_A_SLOPE > 0) || (IFX_LWIP_TX_CBS_CLASS_B_SLOPE > 0)
+    	tx_shaper_update(ethernetif, GethConfig.mac.lineSpeed);
+#endif
+#if IFX_LWIP_RX_ZERO_COPY
+    	rx_buffer_init(ethernetif);
+#endif
+    	// the startup code has cleared the buffers through the data cache
+    	Ifx_Lwip_dmaFlush(channelRxBuffer1, sizeof(channelRxBuffer1));
+#if IFX_LWIP_MULTICORE
+    	for (i = 0; i < IFX_LWIP_NUM_CHANNELS; i++)
+    	{
+    		Ifx_PbufRing_init(&rxRing[i], &rxRingSlots[i][0], IFX_LWIP_RX_RING_SIZE);
+    	}
+    	Ifx_PbufRing_init(&rxReturnRing, rxReturnSlots, IFX_NETIF_RX_RETURN_SLOTS);
+#endif
+
+   		// the PHY is set up by IfxGeth_Eth_Phy_Rtl8211f_process() from the main loop (ifx_netif_link_update())
+   		IfxGeth_Eth_Phy_Rtl8211f_init();
+
+    	// a change of the RGMII in-band link status raises SR0, the PHY is then asked for the new mode
+    	{
+    		volatile Ifx_SRC_SRCR *srcSFR = IfxGeth_getSrcPointer(ethernetif->gethSFR, IfxGeth_ServiceRequest_0);
+
+    		(void)ethernetif->gethSFR->MAC_PHYIF_CONTROL_STATUS.U; // clears a pending status change
+    		IfxGeth_mac_setRgmiiLinkInterrupt(ethernetif->gethSFR, TRUE);
+    		IfxSrc_init(srcSFR, gethIsrProvider, ISR_PRIORITY_GETH_LINK);
+    		IfxSrc_enable(srcSFR);
+    	}
+
+    	// and enable transmitter/receiver
+    	IfxGeth_Eth_startTransmitters(ethernetif, IFX_LWIP_NUM_CHANNELS);
+    	IfxGeth_Eth_startReceivers(ethernetif, IFX_LWIP_NUM_CHANNELS);
+
+    	// The ETH is ready for use now! The link comes up when the PHY has finished the
+    	// auto-negotiation, ifx_netif_link_update() then sets the MAC to the negotiated mode
+    	linkSpeed      = GethConfig.mac.lineSpeed;
+    	linkDuplexMode = GethConfig.mac.duplexMode;
+    }
+}
+
+/**
+ * Checks whether further descriptors fit into the Tx ring of a channel. One
+ * descriptor always stays unused, otherwise the tail pointer would catch up with
+ * the DMA and the ring looks empty. If one of them copies into its buffer, no
+ * other descriptor in flight may use that buffer: the descriptors in flight are
+ * consecutive, together they must not outnumber IFX_LWIP_TX_BUFFERS.
+ *
+ * @param channel the Tx DMA channel
+ * @param numOfDescriptors the descriptors to add, including a VLAN context descriptor
+ * @param copy TRUE if any of them copies into its buffer
+ * @return TRUE if they fit
+ */
+static boolean tx_ring_has_room(IfxGeth_TxDmaChannel channel, uint32 numOfDescriptors, boolean copy)
+{
+    uint32 limit = copy ? LWIP_MIN(IFX_LWIP_TX_DESCRIPTORS - 1, IFX_LWIP_TX_BUFFERS) : (IFX_LWIP_TX_DESCRIPTORS - 1);
+
+    return (boolean)((txPending[channel] + numOfDescriptors) <= limit);
+}
+
+
+/**
+ * Copies a part of a frame into the buffers of consecutive descriptors, one
+ * buffer per IFXGETH_MAX_TX_BUFFER_SIZE bytes.
+ *
+ * @param p the frame
+ * @param offset first byte of p to copy
+ * @param length number of bytes to copy
+ * @param channel the Tx DMA channel
+ * @param index the first descriptor
+ * @param segments gets one segment per descriptor
+ * @return the number of descriptors used, IFX_NETIF_TX_COPY_DESCRIPTORS(length)
+ */
+static uint32 tx_copy(const pbuf_t *p, u16_t offset, u16_t length, IfxGeth_TxDmaChannel channel, uint32 index, IfxGeth_Eth_TxSegment *segments)
+{
+    uint32 numOfSegments = 0;
+
+    while (length > 0)
+    {
+        u8_t *tbuf = IFX_NETIF_TX_BUFFER(channel, index);
+        u16_t n    = (u16_t)LWIP_MIN(length, IFXGETH_MAX_TX_BUFFER_SIZE);
+
+        pbuf_copy_partial(p, tbuf, n, offset);
+        segments[numOfSegments].buffer = tbuf;
+        segments[numOfSegments].length = n;
+        LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_output: data=%#x, %d\n", tbuf, n));
+
+        numOfSegments++;
+        offset = (u16_t)(offset + n);
+        length = (u16_t)(length - n);
+        index  = (index + 1) % IFX_LWIP_TX_DESCRIPTORS;
+    }
+
+    return numOfSegments;
+}
+
+
+/**
+ * Writes the cached lines of the segments of a frame back, the copies in
+ * channelTxBuffer1 as well as zero-copy payloads. Nothing to do for memory
+ * which is not cached.
+ *
+ * @param segments the segments as they are handed to the DMA
+ * @param numOfSegments number of segments
+ */
+static void tx_writeback(const IfxGeth_Eth_TxSegment *segments, uint32 numOfSegments)
+{
+#if IFX_LWIP_DMA_CACHE_MAINTENANCE
+    uint32 i;
+
+    for (i = 0; i < numOfSegments; i++)
+    {
+        Ifx_Lwip_dmaFlush(segments[i].buffer, segments[i].length);
+    }
+#else
+    LWIP_UNUSED_ARG(segments);
+    LWIP_UNUSED_ARG(numOfSegments);
+#endif
+}
+
+
+/**
+ * Hands a frame to the DMA, one descriptor per pbuf segment or a copy in the
+ * buffers of as many descriptors as it takes. Never waits for the DMA.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param p the frame as lwIP passes it (the Ethernet header including the padding)
+ * @param vlanTag the VLAN tag the GETH inserts, 0: untagged
+ * @param channel the Tx DMA channel
+ * @return ERR_OK if the frame has been handed to the DMA
+ *         ERR_WOULDBLOCK if the ring has no free descriptor, nothing has been done
+ */
+static err_t tx_frame(netif_t *netif, pbuf_t *p, u16_t vlanTag, IfxGeth_TxDmaChannel channel)
+{
+    IfxGeth_Eth          *ethernetif = netif->state;
+    IfxGeth_Eth_TxSegment segments[IFX_NETIF_TX_MAX_SEGMENTS];
+#if IFX_LWIP_TX_ZERO_COPY
+    struct pbuf          *q;
+#endif
+    uint32                numOfSegments = 0;
+    uint32                vlanDescriptors = (vlanTag != 0) ? 1 : 0;
+    uint32                index;
+    boolean               copy     = TRUE;
+    boolean               zeroCopy = FALSE;
+#if IFX_LWIP_PTP
+    boolean               timestamp = tx_timestamp_requested(p);
+#endif
+
+#if IFX_LWIP_TX_CHECKSUM_OFFLOAD
+    /* raw frames are sent as they are. The GETH cannot insert the L4 checksum of an IP
+     * fragment, ip4.c generates it before fragmenting a datagram (ip4_frag_chksum()) */
+    IfxGeth_ChecksumInsertion checksumInsertion = (((p->flags & IFX_NETIF_PBUF_FLAG_TX_RAW) != 0) || !txChecksumOffload) ? IfxGeth_ChecksumInsertion_disabled : IfxGeth_ChecksumInsertion_full;
+#else
+    IfxGeth_ChecksumInsertion checksumInsertion = IfxGeth_ChecksumInsertion_disabled; /* lwIP has generated all checksums */
+#endif
+
+#if ETH_PAD_SIZE
+    pbuf_header(p, -ETH_PAD_SIZE); /* drop the padding word */
+#endif
+
+#if IFX_LWIP_TX_ZERO_COPY
+    {
+        boolean refCopy = FALSE;
+
+        for (q = p; q != NULL; q = q->next)
+        {
+            if (q->len != 0)
+            {
+                numOfSegments++;
+            }
+
+            if (PBUF_NEEDS_COPY(q) && ((q->flags & PBUF_FLAG_IS_CUSTOM) == 0))
+            {
+                refCopy = TRUE;
+
+                if (q->len > IFXGETH_MAX_TX_BUFFER_SIZE)
+                {
+                    /* PBUF_REF data longer than the buffer of a descriptor: copy the whole frame */
+                    numOfSegments = IFX_NETIF_TX_MAX_SEGMENTS + 1;
+                    break;
+                }
+            }
+        }
+
+        copy = (boolean)((numOfSegments > IFX_NETIF_TX_MAX_SEGMENTS) || !tx_ring_has_room(channel, vlanDescriptors + numOfSegments, refCopy));
+    }
+#endif
+
+    /* A tagged frame may need a context descriptor in front of it. Otherwise there
+     * has to be room for a copy of the frame */
+    if (copy && !tx_ring_has_room(channel, vlanDescriptors + IFX_NETIF_TX_COPY_DESCRIPTORS(p->tot_len), TRUE))
+    {
+#if ETH_PAD_SIZE
+        pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
+#endif
+        return ERR_WOULDBLOCK;
+    }
+
+    /* a new tag goes to the DMA in a context descriptor, the frame starts behind it */
+    txPending[channel] += IfxGeth_Eth_setTxVlanTag(ethernetif, channel, (boolean)(vlanTag != 0), vlanTag);
+
+    index = (uint32)(IfxGeth_Eth_getActualTxDescriptor(ethernetif, channel) - IfxGeth_Eth_getBaseTxDescriptor(ethernetif, channel));
+
+#if IFX_LWIP_TX_ZERO_COPY
+    if (!copy)
+    {
+        /* one descriptor per segment, the DMA reads the pbuf payloads directly */
+        uint32 i = 0;
+        uint32 d = index;
+
+        for (q = p; q != NULL; q = q->next)
+        {
+            if (q->len == 0)
+            {
+                continue;
+            }
+
+            if (PBUF_NEEDS_COPY(q) && ((q->flags & PBUF_FLAG_IS_CUSTOM) == 0))
+            {
+                /* PBUF_REF data may be reused by the caller as soon as we return,
+                 * it goes through the buffer of its own descriptor */
+                LWIP_ASSERT("low_level_output: segment overflow the buffer\n", (q->len <= IFXGETH_MAX_TX_BUFFER_SIZE));
+                memcpy(IFX_NETIF_TX_BUFFER(channel, d), q->payload, q->len);
+                segments[i].buffer = IFX_NETIF_TX_BUFFER(channel, d);
+            }
+            else
+            {
+                segments[i].buffer = q->payload;
+                zeroCopy           = TRUE;
+            }
+            segments[i].length = q->len;
+            LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_output: data=%#x, %d\n", segments[i].buffer, q->len));
+
+            i++;
+            d = (d + 1) % IFX_LWIP_TX_DESCRIPTORS;
+        }
+    }
+    else
+#endif
+    {
+        /* copy the whole chain into the buffers of the descriptors, a standard
+         * frame takes one of them */
+        numOfSegments = tx_copy(p, 0, p->tot_len, channel, index, segments);
+    }
+
+#if IFX_LWIP_PTP
+    if (timestamp)
+    {
+        /* tx_reclaim() stores the timestamp into the frame, keep it also if it has been copied */
+        IfxGeth_Eth_requestTxTimestamp(ethernetif, channel);
+        zeroCopy = TRUE;
+    }
+#endif
+
+    if (zeroCopy)
+    {
+        /* keep the frame until its last descriptor has been transmitted, it is
+         * released by tx_reclaim() */
+        pbuf_ref(p);
+        txPbuf[channel][(index + numOfSegments - 1) % IFX_LWIP_TX_DESCRIPTORS] = p;
+    }
+
+    txPending[channel] += numOfSegments;
+    tx_writeback(segments, numOfSegments);
+    IfxGeth_Eth_sendTransmitSegments(ethernetif, segments, numOfSegments, channel, checksumInsertion);
+
+    LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_output: signal length: %d\n", p->tot_len));
+
+#if ETH_PAD_SIZE
+    pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
+#endif
+
+    LINK_STATS_INC(link.xmit);
+
+    return ERR_OK;
+}
+
+
+#if IFX_LWIP_TX_TSO
+/**
+ * Cuts a TCP segment longer than the mtu (NETIF_FLAG_TSO) into frames, the GETH of
+ * the TC39x has no TCP segmentation of its own. Every frame gets a copy of the
+ * headers with its own IP length, identification (counted on from the header, ip4.c
+ * has reserved these IDs) and sequence number, FIN and PSH stay on the last frame. The payload is referenced where it is or copied behind
+ * the headers, like tx_frame() does it. The GETH inserts the checksums.
+ *
+ * If the ring runs out of descriptors, the frames sent so far stay on their way
+ * and txFrame->offset remembers where the next call continues.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param txFrame the TCP segment as lwIP passes it (the Ethernet header including the padding)
+ * @param channel the Tx DMA channel
+ * @return ERR_OK if all frames have been handed to the DMA
+ *         ERR_WOULDBLOCK if the ring has no free descriptor for the next frame
+ *         ERR_VAL if p is no TCP segment with all its headers in the first pbuf
+ */
+static err_t tx_segment_tcp(netif_t *netif, Ifx_Netif_TxFrame *txFrame, IfxGeth_TxDmaChannel channel)
+{
+    IfxGeth_Eth          *ethernetif = netif->state;
+    IfxGeth_Eth_TxSegment segments[IFX_NETIF_TX_MAX_SEGMENTS];
+    pbuf_t               *p          = txFrame->p;
+    const eth_hdr_t      *ethhdr     = (const eth_hdr_t *)p->payload;
+    const struct ip_hdr  *iphdr      = (const struct ip_hdr *)((const u8_t *)p->payload + SIZEOF_ETH_HDR);
+    const struct tcp_hdr *tcphdr;
+    pbuf_t               *q;
+    u16_t                 qOffset;
+    u16_t                 ipHeaderLength;
+    u16_t                 headerLength;
+    u16_t                 mss;
+    u16_t                 offset;
+    u16_t                 ipId;
+    u32_t                 seqno;
+    uint32                frame;
+
+    if ((p->len < (SIZEOF_ETH_HDR + IP_HLEN)) || (ethhdr->type != PP_HTONS(ETHTYPE_IP)) || (IPH_PROTO(iphdr) != IP_PROTO_TCP))
+    {
+        LINK_STATS_INC(link.err);
+        return ERR_VAL;
+    }
+
+    ipHeaderLength = IPH_HL_BYTES(iphdr);
+    tcphdr         = (const struct tcp_hdr *)((const u8_t *)iphdr + ipHeaderLength);
+
+    if (p->len < (SIZEOF_ETH_HDR + ipHeaderLength + TCP_HLEN))
+    {
+        LINK_STATS_INC(link.err);
+        return ERR_VAL;
+    }
+
+    headerLength = (u16_t)(SIZEOF_ETH_HDR + ipHeaderLength + TCPH_HDRLEN_BYTES(tcphdr));
+    if (p->len < headerLength)
+    {
+        LINK_STATS_INC(link.err);
+        return ERR_VAL;
+    }
+
+    mss    = (u16_t)(netif->mtu - (headerLength - SIZEOF_ETH_HDR));
+    ipId   = lwip_ntohs(IPH_ID(iphdr));
+    seqno  = lwip_ntohl(tcphdr->seqno);
+    offset = (txFrame->offset != 0) ? txFrame->offset : headerLength; /* the headers are in the first pbuf */
+    frame  = (uint32)(offset - headerLength) / mss;
+
+    /* find the next payload byte */
+    for (q = p, qOffset = offset; qOffset >= q->len; q = q->next)
+    {
+        qOffset -= q->len;
+    }
+
+    for ( ; offset < p->tot_len; frame++)
+    {
+        u16_t           length        = (u16_t)LWIP_MIN(mss, p->tot_len - offset);
+        uint32          copyCount     = IFX_NETIF_TX_COPY_DESCRIPTORS(headerLength + length); /* the padding is in the first buffer */
+        uint32          numOfSegments = 1;
+        boolean         zeroCopy      = FALSE;
+        boolean         copied;
+        uint32          index;
+        u8_t           *tbuf;
+        struct ip_hdr  *frameIphdr;
+        struct tcp_hdr *frameTcphdr;
+
+        /* the headers always go through the buffer of the first descriptor */
+        if (!tx_ring_has_room(channel, ((txFrame->vlanTag != 0) ? 1 : 0) + copyCount, TRUE))
+        {
+            txFrame->offset = offset;
+            LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("tx_segment_tcp: ring full after %d frames\n", frame));
+            return ERR_WOULDBLOCK;
+        }
+
+#if IFX_LWIP_TX_ZERO_COPY
+        {
+            /* one descriptor for the headers and one per pbuf the payload of this frame spans */
+            pbuf_t *r       = q;
+            u16_t   rOffset = qOffset;
+            u16_t   left    = length;
+
+            while (left > 0)
+            {
+                u16_t n = (u16_t)LWIP_MIN(left, r->len - rOffset);
+
+                if (n != 0)
+                {
+                    numOfSegments++;
+                }
+
+                if (PBUF_NEEDS_COPY(r) && ((r->flags & PBUF_FLAG_IS_CUSTOM) == 0) && (n > IFXGETH_MAX_TX_BUFFER_SIZE))
+                {
+                    /* longer than the buffer it would be copied into */
+                    numOfSegments = IFX_NETIF_TX_MAX_SEGMENTS + 1;
+                    break;
+                }
+
+                left    -= n;
+                rOffset += n;
+
+                if (rOffset == r->len)
+                {
+                    r       = r->next;
+                    rOffset = 0;
+                }
+            }
+
+            if ((numOfSegments > IFX_NETIF_TX_MAX_SEGMENTS) || !tx_ring_has_room(channel, ((txFrame->vlanTag != 0) ? 1 : 0) + numOfSegments, TRUE))
+            {
+                numOfSegments = 1;
+            }
+        }
+#endif
+
+        txPending[channel] += IfxGeth_Eth_setTxVlanTag(ethernetif, channel, (boolean)(txFrame->vlanTag != 0), txFrame->vlanTag);
+
+        index = (uint32)(IfxGeth_Eth_getActualTxDescriptor(ethernetif, channel) - IfxGeth_Eth_getBaseTxDescriptor(ethernetif, channel));
+        tbuf  = IFX_NETIF_TX_BUFFER(channel, index);
+
+        /* the headers of this frame go through the buffer of its first descriptor */
+        memcpy(tbuf, p->payload, headerLength);
+        frameIphdr  = (struct ip_hdr *)&tbuf[SIZEOF_ETH_HDR];
+        frameTcphdr = (struct tcp_hdr *)&tbuf[SIZEOF_ETH_HDR + ipHeaderLength];
+        IPH_LEN_SET(frameIphdr, lwip_htons((u16_t)(headerLength - SIZEOF_ETH_HDR + length)));
+        IPH_ID_SET(frameIphdr, lwip_htons((u16_t)(ipId + frame)));
+        IPH_CHKSUM_SET(frameIphdr, 0);
+        frameTcphdr->seqno  = lwip_htonl(seqno + (offset - headerLength));
+        frameTcphdr->chksum = 0;
+
+        if ((offset + length) < p->tot_len)
+        {
+            TCPH_UNSET_FLAG(frameTcphdr, TCP_FIN | TCP_PSH);
+        }
+
+        segments[0].buffer = &tbuf[ETH_PAD_SIZE];
+        segments[0].length = (uint16)(headerLength - ETH_PAD_SIZE);
+
+        copied = (boolean)(numOfSegments == 1);
+
+        if (copied)
+        {
+            /* the payload behind the headers, the rest of a jumbo frame in the next buffers */
+            u16_t n = (u16_t)LWIP_MIN(length, IFXGETH_MAX_TX_BUFFER_SIZE - headerLength);
+
+            pbuf_copy_partial(p, &tbuf[headerLength], n, offset);
+            segments[0].length += n;
+            numOfSegments      += tx_copy(p, (u16_t)(offset + n), (u16_t)(length - n), channel, (index + 1) % IFX_LWIP_TX_DESCRIPTORS, &segments[1]);
+        }
+
+        /* walk the payload of this frame, referencing it for the zero copy descriptors */
+        {
+            u16_t  left = length;
+            uint32 i    = 1;
+
+            while (left > 0)
+            {
+                u16_t n = (u16_t)LWIP_MIN(left, q->len - qOffset);
+
+                if ((n != 0) && !copied)
+                {
+                    uint32 d = (index + i) % IFX_LWIP_TX_DESCRIPTORS;
+
+                    if (PBUF_NEEDS_COPY(q) && ((q->flags & PBUF_FLAG_IS_CUSTOM) == 0))
+                    {
+                        memcpy(IFX_NETIF_TX_BUFFER(channel, d), (const u8_t *)q->payload + qOffset, n);
+                        segments[i].buffer = IFX_NETIF_TX_BUFFER(channel, d);
+                    }
+                    else
+                    {
+                        segments[i].buffer = (const u8_t *)q->payload + qOffset;
+                        zeroCopy           = TRUE;
+                    }
+
+                    segments[i].length = n;
+                    i++;
+                }
+
+                left    -= n;
+                qOffset += n;
+
+                if (qOffset == q->len)
+                {
+                    q       = q->next;
+                    qOffset = 0;
+                }
+            }
+        }
+
+        if (zeroCopy)
+        {
+            /* every frame holds a reference, the last one released by tx_reclaim() frees the segment */
+            pbuf_ref(p);
+            txPbuf[channel][(index + numOfSegments - 1) % IFX_LWIP_TX_DESCRIPTORS] = p;
+        }
+
+        txPending[channel] += numOfSegments;
+        tx_writeback(segments, numOfSegments);
+        IfxGeth_Eth_sendTransmitSegments(ethernetif, segments, numOfSegments, channel, IfxGeth_ChecksumInsertion_full);
+
+        LINK_STATS_INC(link.xmit);
+        offset += length;
+    }
+
+    LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("tx_segment_tcp: %d bytes in %d frames\n", p->tot_len, frame));
+
+    return ERR_OK;
+}
+#endif
+
+
+/**
+ * Hands as much of a frame to the DMA as its ring takes.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param txFrame the frame and how much of it has been sent already
+ * @param channel the Tx DMA channel
+ * @return ERR_OK if the frame is on its way, ERR_WOULDBLOCK if (the rest of) it
+ *         has to wait for free descriptors, any other err_t if it has been dropped
+ */
+static err_t tx_send(netif_t *netif, Ifx_Netif_TxFrame *txFrame, IfxGeth_TxDmaChannel channel)
+{
+#if IFX_LWIP_TX_TSO
+    if (txFrame->p->tot_len > (SIZEOF_ETH_HDR + netif->mtu))
+    {
+        /* a TCP segment of several MSS */
+        return tx_segment_tcp(netif, txFrame, channel);
+    }
+#endif
+
+    return tx_frame(netif, txFrame->p, txFrame->vlanTag, channel);
+}
+
+
+#if IFX_LWIP_TX_QUEUE_LENGTH > 0
+/**
+ * Hands the queued frames of a channel to the DMA, in their order, as far as
+ * the ring has free descriptors.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param channel the Tx DMA channel
+ */
+static void tx_flush(netif_t *netif, IfxGeth_TxDmaChannel channel)
+{
+    while (txQueueCount[channel] > 0)
+    {
+        Ifx_Netif_TxFrame *txFrame = &txQueue[channel][txQueueHead[channel]];
+
+        if (tx_send(netif, txFrame, channel) == ERR_WOULDBLOCK)
+        {
+            break;
+        }
+
+        pbuf_free(txFrame->p);
+        txFrame->p            = NULL;
+        txQueueHead[channel]  = (txQueueHead[channel] + 1) % IFX_LWIP_TX_QUEUE_LENGTH;
+        txQueueCount[channel]--;
+    }
+}
+
+
+/**
+ * Queues a frame which didn't find enough free descriptors. Data lwIP may reuse
+ * after netif->linkoutput has returned (PBUF_REF) is copied first.
+ *
+ * @param txFrame the frame and how much of it has been sent already
+ * @param channel the Tx DMA channel
+ * @return ERR_OK if the frame has been queued
+ *         ERR_MEM if there was no memory for the copy
+ */
+static err_t tx_enqueue(Ifx_Netif_TxFrame *txFrame, IfxGeth_TxDmaChannel channel)
+{
+    pbuf_t *p;
+
+    for (p = txFrame->p; p != NULL; p = p->next)
+    {
+        if (PBUF_NEEDS_COPY(p) && ((p->flags & PBUF_FLAG_IS_CUSTOM) == 0))
+        {
+            break;
+        }
+    }
+
+    if (p != NULL)
+    {
+        p = pbuf_clone(PBUF_RAW, PBUF_RAM, txFrame->p);
+
+        if (p == NULL)
+        {
+            return ERR_MEM;
+        }
+
+        /* a timestamp request is not taken over, the copy can't pass it back */
+        p->flags |= (u8_t)(txFrame->p->flags & IFX_NETIF_PBUF_FLAG_TX_RAW);
+    }
+    else
+    {
+        p = txFrame->p;
+        pbuf_ref(p);
+    }
+
+    txFrame->p = p;
+    txQueue[channel][(txQueueHead[channel] + txQueueCount[channel]) % IFX_LWIP_TX_QUEUE_LENGTH] = *txFrame;
+    txQueueCount[channel]++;
+
+    return ERR_OK;
+}
+#endif
+
+
+/**
+ * This function should do the actual transmission of the packet. The packet is
+ * contained in the pbuf that is passed to the function. This pbuf
+ * might be chained.
+ *
+ * The function never waits for the DMA: frames which find the ring of their
+ * channel full are queued (IFX_LWIP_TX_QUEUE_LENGTH) and sent by
+ * ifx_netif_tx_complete() once the DMA has released descriptors. Without room
+ * in the queue the frame is refused with ERR_WOULDBLOCK, TCP sends it again
+ * with its next output, other senders get the error returned.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param p the MAC packet to send (e.g. IP packet including MAC addresses and type)
+ * @return ERR_OK if the packet has been sent or queued
+ *         ERR_WOULDBLOCK if the Tx ring and the queue of the channel are full
+ *         an err_t value if the packet couldn't be sent
+ */
+static err_t low_level_output(netif_t *netif, pbuf_t *p)
+{
+    IfxGeth_Eth          *ethernetif = netif->state;
+    Ifx_Netif_TxFrame     txFrame;
+    err_t                 err        = ERR_WOULDBLOCK;
+    u8_t                  priority   = tx_priority(p);
+    IfxGeth_TxDmaChannel  channel    = txPriorityChannel[priority];
+
+#if IFX_LWIP_TX_CHECKSUM_OFFLOAD
+    if (txChecksumOffload && ((p->flags & IFX_NETIF_PBUF_FLAG_TX_RAW) == 0))
+    {
+        channel = txChecksumChannel[channel];
+    }
+#endif
+
+    LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_output (p=%#x, channel %d)\n", p, channel));
+
+    txFrame.p       = p;
+    txFrame.offset  = 0;
+    txFrame.vlanTag = tx_vlan_tag(netif);
+
+#if IFX_LWIP_PTP
+    if (((const eth_hdr_t *)p->payload)->type == PP_HTONS(ETHTYPE_PTP))
+    {
+        /* 802.1AS messages are untagged, they go to the neighbour */
+        txFrame.vlanTag = 0;
+    }
+#endif
+
+    if ((txFrame.vlanTag != 0) && (priority != 0))
+    {
+        txFrame.vlanTag = (u16_t)((txFrame.vlanTag & 0x1FFFU) | ((u16_t)priority << 13));
+    }
+
+    tx_reclaim(ethernetif, channel);
+
+#if IFX_LWIP_TX_QUEUE_LENGTH > 0
+    /* the frames queued before go first */
+    tx_flush(netif, channel);
+
+    if (txQueueCount[channel] == 0)
+#endif
+    {
+        err = tx_send(netif, &txFrame, channel);
+    }
+
+#if IFX_LWIP_TX_QUEUE_LENGTH > 0
+    if ((err == ERR_WOULDBLOCK) && (txQueueCount[channel] < IFX_LWIP_TX_QUEUE_LENGTH))
+    {
+        err = tx_enqueue(&txFrame, channel);
+    }
+#endif
+
+    if (err != ERR_OK)
+    {
+        LINK_STATS_INC(link.drop);
+    }
+
+    LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_output: return %d\n", err));
+
+    return err;
+}
+
+static uint16 GetRxFrameSize(IfxGeth_RxDescr *descr)
+{
+  uint16 len;
+
+  uint32 rdes3 = descr->RDES3.U;
+  uint32 rdes1 = descr->RDES1.U;
+
+  /* error summary, IP payload or header checksum error, or not the last descriptor of the frame */
+  if (((rdes3 & (1UL << 15)) != 0U) ||
+	  ((rdes1 & (1UL << 7)) != 0U) ||
+	  ((rdes1 & (1UL << 3)) != 0U) ||
+	  ((rdes3 & (1UL << 28)) == 0U))
+  {
+	/* Error, this block is invalid */
+	len = 0xFFFFU;
+  }
+  else
+  {
+    /* Subtract CRC */
+	len = (rdes3 & 0x7FFF) - 4U;
+  }
+
+  return len;
+}
+
+#if IFX_LWIP_RX_CHECKSUM_OFFLOAD
+/**
+ * Reads what the Rx checksum offload engine has verified for a frame without
+ * checksum errors (those are dropped by GetRxFrameSize()).
+ *
+ * @param descr the last descriptor of the frame
+ * @return NETIF_CHECKSUM_CHECK_IP and/or IFX_NETIF_CHECKSUM_CHECK_L4
+ */
+static u16_t GetRxChecksumStatus(volatile IfxGeth_RxDescr *descr)
+{
+  uint32 rdes3 = descr->RDES3.U;
+  uint32 rdes1 = descr->RDES1.U;
+  uint32 pt    = rdes1 & 0x7U;
+  u16_t  flags = 0;
+
+  /* RDES1 valid and the checksum engine not bypassed */
+  if (((rdes3 & (1UL << 26)) != 0U) && ((rdes1 & (1UL << 6)) == 0U))
+  {
+    if ((rdes1 & (1UL << 4)) != 0U)
+    {
+      flags |= NETIF_CHECKSUM_CHECK_IP;
+    }
+
+    /* payload type UDP, TCP or ICMP; fragments are reported as unknown */
+    if ((pt >= 1U) && (pt <= 3U))
+    {
+      flags |= IFX_NETIF_CHECKSUM_CHECK_L4;
+    }
+  }
+
+  return flags;
+}
+#endif
+
+/**
+ * Reads the VLAN tag the GETH has stripped from a frame.
+ *
+ * @param descr the last descriptor of the frame
+ * @return tag control information, 0 for untagged frames
+ */
+static u16_t GetRxVlanTag(volatile IfxGeth_RxDescr *descr)
+{
+  /* RDES0 valid: the outer VLAN tag is in its lower half */
+  if ((descr->RDES3.U & (1UL << 25)) != 0U)
+  {
+    return (u16_t)(descr->RDES0.U & 0xFFFFU);
+  }
+
+  return 0;
+}
+
+/**
+ * Returns the receive buffer the actual descriptor of a channel has been armed
+ * with, its write-back has replaced the buffer address in RDES0.
+ *
+ * @param ethernetif the GETH driver handle
+ * @param channel the Rx DMA channel
+ * @return the start of the buffer (where the DMA has written the frame)
+ */
+static u8_t *rx_buffer(IfxGeth_Eth *ethernetif, IfxGeth_RxDmaChannel channel)
+{
+    uint32 index = (uint32)(IfxGeth_Eth_getActualRxDescriptor(ethernetif, channel) - IfxGeth_Eth_getBaseRxDescriptor(ethernetif, channel));
+
+#if IFX_LWIP_RX_ZERO_COPY
+    /* the buffer is tracked in software */
+    return &rxArmed[channel][index]->buffer[IFX_LWIP_RX_HEADROOM];
+#else
+    /* the rows as low_level_init() has assigned them */
+    return &channelRxBuffer1[channel * IFX_LWIP_RX_DESCRIPTORS][IFX_LWIP_RX_HEADROOM] + (index * IFX_NETIF_RX_BUFFER_LENGTH);
+#endif
+}
+
+
+/**
+ * Hands the actual descriptor of a channel back to the DMA with the buffer it
+ * has: dropped frames, descriptors with nothing for lwIP in their buffer and
+ * context descriptors (the timestamp of the frame before them).
+ *
+ * @param ethernetif the GETH driver handle
+ * @param channel the Rx DMA channel
+ */
+static void rx_release(IfxGeth_Eth *ethernetif, IfxGeth_RxDmaChannel channel)
+{
+    IfxGeth_Eth_refillReceiveBuffer(ethernetif, channel, rx_buffer(ethernetif, channel));
+}
+
+
+/**
+ * Finds the last descriptor of the frame at the actual descriptor of a channel.
+ * A frame longer than one receive buffer (jumbo frame) spans several descriptors,
+ * its first one has FD and its last one LD set.
+ *
+ * @param ethernetif the GETH driver handle
+ * @param channel the Rx DMA channel
+ * @param last set to the last descriptor of the frame
+ * @return the number of descriptors of the frame, 0 if the DMA is still writing it
+ */
+static uint32 rx_frame_descriptors(IfxGeth_Eth *ethernetif, IfxGeth_RxDmaChannel channel, volatile IfxGeth_RxDescr **last)
+{
+    volatile IfxGeth_RxDescr *base  = IfxGeth_Eth_getBaseRxDescriptor(ethernetif, channel);
+    volatile IfxGeth_RxDescr *descr = IfxGeth_Eth_getActualRxDescriptor(ethernetif, channel);
+    uint32                    count = 1;
+
+    /* a frame without LD in the whole ring is dropped by GetRxFrameSize() */
+    while (((descr->RDES3.U & (1UL << 28)) == 0U) && (count < IFX_LWIP_RX_DESCRIPTORS))
+    {
+        descr = (descr == &base[IFX_LWIP_RX_DESCRIPTORS - 1]) ? base : &descr[1];
+
+        if (descr->RDES3.R.OWN != 0)
+        {
+            return 0;
+        }
+
+        count++;
+    }
+
+    *last = descr;
+    return count;
+}
+
+
+/**
+ * Should allocate a pbuf and transfer the bytes of the incoming
+ * packet from the interface into the pbuf. The pbuf gets the netif of
+ * its VLAN as if_idx and, with IFX_LWIP_PTP, its receive timestamp in
+ * ts_sec/ts_nsec. A frame spanning several descriptors becomes a pbuf
+ * chain (zero-copy: one pbuf per receive buffer).
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param channel the Rx DMA channel to read from
+ * @param vlanTci set to the VLAN tag stripped by the GETH, 0 for untagged frames
+ * @param incomplete set to TRUE if the frame or its timestamp is still coming in,
+ *        it is left in the ring for the next call
+ * @return a pbuf filled with the received packet (including MAC header)
+ *         NULL on memory error
+ */
+static pbuf_t *low_level_input(netif_t *netif, IfxGeth_RxDmaChannel channel, u16_t *vlanTci, boolean *incomplete)
+{
+	IfxGeth_Eth *ethernetif = netif->state;
+    volatile IfxGeth_RxDescr *last;
+    pbuf_t *p = NULL;
+    u16_t   len;
+    u16_t   offset;
+    uint32  count;
+    uint32  i;
+    u8_t    ifIdx;
+#if IFX_LWIP_RX_CHECKSUM_OFFLOAD
+    u16_t   checked;
+#endif
+#if IFX_LWIP_PTP
+    IfxGeth_Eth_Timestamp timestamp = {0, 0};
+
+    /* the timestamps of the frames read before */
+    while (IfxGeth_Eth_isRxContextDescriptor(ethernetif, channel))
+    {
+        rx_release(ethernetif, channel);
+    }
+#endif
+
+    *vlanTci    = 0;
+    *incomplete = FALSE;
+    if (IfxGeth_Eth_isRxDataAvailable(ethernetif, channel) == FALSE)
+    {
+        return (pbuf_t *)0;
+    }
+
+    count = rx_frame_descriptors(ethernetif, channel, &last);
+
+    if (count == 0)
+    {
+        /* the rest of the frame is still coming in, it is read by the next call */
+        *incomplete = TRUE;
+        return (pbuf_t *)0;
+    }
+
+#if IFX_LWIP_PTP
+    if (IfxGeth_Eth_isRxTimestampPending(ethernetif, channel, last))
+    {
+        /* the context descriptor with the timestamp follows, the frame is read by the next call */
+        *incomplete = TRUE;
+        return (pbuf_t *)0;
+    }
+#endif
+
+    /* the status of the frame is in its last descriptor */
+    len = GetRxFrameSize((IfxGeth_RxDescr *)last);
+#if IFX_LWIP_RX_CHECKSUM_OFFLOAD
+    checked = GetRxChecksumStatus(last);
+#endif
+    *vlanTci = GetRxVlanTag(last);
+    ifIdx    = rx_vlan_if_idx(netif, *vlanTci);
+
+    if (((IfxGeth_Eth_getActualRxDescriptor(ethernetif, channel)->RDES3.U & (1UL << 29)) == 0U) || (len == 0))
+    {
+        /* not the first descriptor of a frame (the start is lost) or nothing but the CRC */
+        len = 0xFFFFU;
+    }
+
+    if ((len != 0xFFFFU) && (ifIdx != NETIF_NO_INDEX))
+    {
+#if IFX_LWIP_RX_ZERO_COPY
+        /* receive buffers with frame data (the last one may hold only CRC bytes) */
+        uint32              numOfBuffers = ((uint32)len + IFX_NETIF_RX_BUFFER_LENGTH - 1) / IFX_NETIF_RX_BUFFER_LENGTH;
+        Ifx_Netif_RxBuffer *spare[IFX_LWIP_RX_DESCRIPTORS];
+
+        /* every buffer passed up is replaced by a spare one */
+        for (i = 0; i < numOfBuffers; i++)
+        {
+            spare[i] = rx_buffer_alloc();
+
+            if (spare[i] == NULL)
+            {
+                break;
+            }
+        }
+
+        if (i == numOfBuffers)
+        {
+            /* pass the received buffers up as they are, the payload starts ETH_PAD_SIZE bytes
+             * in front of the frame (inside the headroom) */
+            for (i = 0, offset = 0; i < count; i++)
+            {
+                volatile IfxGeth_RxDescr *descr    = IfxGeth_Eth_getActualRxDescriptor(ethernetif, channel);
+                Ifx_Netif_RxBuffer       *rxBuffer = rxArmed[channel][descr - IfxGeth_Eth_getBaseRxDescriptor(ethernetif, channel)];
+                u16_t                     n        = (u16_t)LWIP_MIN((uint32)(len - offset), IFX_NETIF_RX_BUFFER_LENGTH);
+                pbuf_t                   *q;
+
+#if IFX_LWIP_PTP
+                if (descr == last)
+                {
+                    IfxGeth_Eth_getRxTimestamp(ethernetif, channel, &timestamp);
+                }
+#endif
+
+                if (n == 0)
+                {
+                    /* only the CRC */
+                    rx_release(ethernetif, channel);
+                    continue;
+                }
+
+                /* lines this CPU has read from an earlier frame in the buffer, the
+                 * buffer may have been freed (written back) on another CPU */
+                Ifx_Lwip_dmaInvalidate(&rxBuffer->buffer[IFX_LWIP_RX_HEADROOM], n);
+
+                if (p == NULL)
+                {
+                    q = pbuf_alloced_custom(PBUF_RAW, (u16_t)(n + ETH_PAD_SIZE), PBUF_REF, &rxBuffer->pc,
+                        &rxBuffer->buffer[IFX_LWIP_RX_HEADROOM - ETH_PAD_SIZE],
+                        IFXGETH_MAX_RX_BUFFER_SIZE - (IFX_LWIP_RX_HEADROOM - ETH_PAD_SIZE));
+                    p = q;
+                }
+                else
+                {
+                    q = pbuf_alloced_custom(PBUF_RAW, n, PBUF_REF, &rxBuffer->pc,
+                        &rxBuffer->buffer[IFX_LWIP_RX_HEADROOM], IFX_NETIF_RX_BUFFER_LENGTH);
+                    pbuf_cat(p, q);
+                }
+
+                /* only fails for a length the buffer can't hold */
+                LWIP_ASSERT("low_level_input: custom pbuf", q != NULL);
+
+                /* and re-arm the descriptor with a spare buffer */
+                rxArmed[channel][descr - IfxGeth_Eth_getBaseRxDescriptor(ethernetif, channel)] = spare[--numOfBuffers];
+                IfxGeth_Eth_refillReceiveBuffer(ethernetif, channel, &spare[numOfBuffers]->buffer[IFX_LWIP_RX_HEADROOM]);
+                offset = (u16_t)(offset + n);
+            }
+
+            LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_input: zero-copy payload=0x%x, len=%d\n", p->payload, p->tot_len));
+        }
+        else
+        {
+            /* all spare buffers are held by lwIP: fall back to copying this frame */
+            while (i > 0)
+            {
+                rx_buffer_free(&spare[--i]->pc.pbuf);
+            }
+        }
+
+        if (p == NULL)
+#endif
+        {
+#if IFX_LWIP_MULTICORE
+            /* the pbuf pool belongs to the LwIP CPU and can't be used here: drop the frame */
+            p = NULL;
+#else
+            /* We allocate a pbuf chain of pbufs from the pool. */
+            p = pbuf_alloc(PBUF_RAW, (u16_t)(len + ETH_PAD_SIZE), PBUF_POOL);
+#endif
+
+            if (p != NULL)
+            {
+#if ETH_PAD_SIZE
+                pbuf_header(p, -ETH_PAD_SIZE); /* drop the padding word */
+#endif
+
+                /* copy the frame out of the receive buffers of its descriptors */
+                for (i = 0, offset = 0; i < count; i++)
+                {
+                    u8_t *buffer = rx_buffer(ethernetif, channel);
+                    u16_t n      = (u16_t)LWIP_MIN((uint32)(len - offset), IFX_NETIF_RX_BUFFER_LENGTH);
+
+#if IFX_LWIP_PTP
+                    if (IfxGeth_Eth_getActualRxDescriptor(ethernetif, channel) == last)
+                    {
+                        IfxGeth_Eth_getRxTimestamp(ethernetif, channel, &timestamp);
+                    }
+#endif
+
+                    Ifx_Lwip_dmaInvalidate(buffer, n);
+                    pbuf_take_at(p, buffer, n, offset);
+                    offset = (u16_t)(offset + n);
+
+                    //acknowledge that packet has been read();
+                    rx_release(ethernetif, channel);
+                }
+
+#if ETH_PAD_SIZE
+                pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
+#endif
+                LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_input: payload=0x%x, len=%d\n", p->payload, p->tot_len));
+            }
+            else
+            {
+                IFX_NETIF_RX_STATS_INC(channel, memerr);
+            }
+        }
+    }
+
+    if (p == NULL)
+    {
+        /* errored frame, no netif on its VLAN or out of pbufs: drop it and give the
+         * descriptors back to the DMA, otherwise they would stay blocked */
+        for (i = 0; i < count; i++)
+        {
+            rx_release(ethernetif, channel);
+        }
+
+        if (len == 0xFFFFU)
+        {
+            IFX_NETIF_RX_STATS_INC(channel, err);
+        }
+        IFX_NETIF_RX_STATS_INC(channel, drop);
+        return (pbuf_t *)0;
+    }
+
+    ethernetif->rxChannel[channel].rxCount++;
+    IFX_NETIF_RX_STATS_INC(channel, recv);
+#if IFX_LWIP_RX_CHECKSUM_OFFLOAD
+    p->chksum_checked = checked;
+#endif
+#if IFX_LWIP_PTP
+    p->ts_sec  = timestamp.seconds;
+    p->ts_nsec = timestamp.nanoseconds;
+#endif
+    p->if_idx = ifIdx;
+
+    return p;
+}
+
+
+/**
+ * Determines the type of a received packet and calls the appropriate
+ * input function of the netif of its VLAN. Runs on the LwIP CPU.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param p the received packet, released here if lwIP does not take it
+ */
+static void low_level_pass(netif_t *netif, pbuf_t *p)
+{
+    eth_hdr_t *ethhdr;
+
+    if (p->if_idx != netif_get_index(netif))
+    {
+        /* received on a VLAN netif (low_level_input()) */
+        netif = netif_get_by_index(p->if_idx);
+
+        if (netif == NULL)
+        {
+            pbuf_free(p);
+            LINK_STATS_INC(link.drop);
+            return;
+        }
+    }
+
+    /* points to packet payload, which starts with an Ethernet header */
+    ethhdr = p->payload;
+
+    switch (htons(ethhdr->type))
+    {
+    /* IP or ARP packet? */
+    case ETHTYPE_IP:
+    case ETHTYPE_ARP:
+    case ETHTYPE_VLAN:
+#if PPPOE_SUPPORT
+    /* PPPoE packet? */
+    case ETHTYPE_PPPOEDISC:
+    case ETHTYPE_PPPOE:
+#endif /* PPPOE_SUPPORT */
+
+        /* full packet send to tcpip_thread to process */
+        if (netif->input(p, netif) != ERR_OK)
+        {
+            LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("ifx_netif_input: IP input error\n"));
+            pbuf_free(p);
+            p = NULL;
         }
 
-        // initialize the module
-    	IfxGeth_Eth_initModule(ethernetif, &GethConfig);
-
-   		IfxGeth_Eth_Phy_Rtl8211f_init();
+        break;
 
-    	// and enable transmitter/receiver
-    	IfxGeth_Eth_startTransmitters(ethernetif, 1);
-    	IfxGeth_Eth_startReceivers(ethernetif, 1);
+#if IFX_LWIP_GPTP
+    case ETHTYPE_PTP:
+        Ifx_Gptp_input(netif, p);
+        break;
+#endif
 
-    	// The ETH is ready for use now!
-        /* we set the LINK_UP flag if we have a valid link */
-    	if (GETH_MAC_PHYIF_CONTROL_STATUS.B.LNKSTS == 1)
-    	{
-    		// we have a valid link
-    		netif->flags |= NETIF_FLAG_LINK_UP;
-    		// we set the correct duplexMode
-    		if (GETH_MAC_PHYIF_CONTROL_STATUS.B.LNKMOD == 1)
-    			IfxGeth_mac_setDuplexMode(ethernetif->gethSFR, IfxGeth_DuplexMode_fullDuplex);
-    		else
-    			IfxGeth_mac_setDuplexMode(ethernetif->gethSFR, IfxGeth_DuplexMode_halfDuplex);
-    		// we set the correct speed
-    		if (GETH_MAC_PHYIF_CONTROL_STATUS.B.LNKSPEED == 0)
-    			// 10MBit speed
-    			IfxGeth_mac_setLineSpeed(ethernetif->gethSFR, IfxGeth_LineSpeed_10Mbps);
-    		else
-        		if (GETH_MAC_PHYIF_CONTROL_STATUS.B.LNKSPEED == 1)
-        			// 100MBit speed
-        			IfxGeth_mac_setLineSpeed(ethernetif->gethSFR, IfxGeth_LineSpeed_100Mbps);
-        		else
-        			// 1000MBit speed
-        			IfxGeth_mac_setLineSpeed(ethernetif->gethSFR, IfxGeth_LineSpeed_1000Mbps);
-    	}
+    default:
+        LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("ifx_netif_input: type unknown\n"));
+        pbuf_free(p);
+        p = NULL;
+        break;
     }
 }
 
+
 /**
- * This function should do the actual transmission of the packet. The packet is
- * contained in the pbuf that is passed to the function. This pbuf
- * might be chained.
+ * This function should be called when a packet is ready to be read
+ * from the interface. It uses the function low_level_input() that
+ * should handle the actual reception of bytes from the network
+ * interface. Then the type of the received packet is determined and
+ * the appropriate input function is called.
  *
  * @param netif the lwip network interface structure for this ethernetif
- * @param p the MAC packet to send (e.g. IP packet including MAC addresses and type)
- * @return ERR_OK if the packet could be sent
- *         an err_t value if the packet couldn't be sent
+ * @param channel the Rx DMA channel which has received the packet
+ * @return ERR_INPROGRESS if the frame or its timestamp is still coming in, the
+ *         caller stops polling the channel until the next pass
+ */
+err_t ifx_netif_input(netif_t *netif, IfxGeth_RxDmaChannel channel)
+{
+    pbuf_t *p;
+    u16_t   vlanTci;
+    boolean incomplete;
+
+    /* move received packet into a new pbuf */
+    p = low_level_input(netif, channel, &vlanTci, &incomplete);
+
+    /* no packet could be read, silently ignore this */
+    if (p == NULL)
+    {
+        //LWIP_DEBUGF(NETIF_DEBUG, ("ifx_netif_input: p == NULL!\n"));
+        return incomplete ? ERR_INPROGRESS : ERR_OK;
+    }
+
+    low_level_pass(netif, p);
+
+    return ERR_OK;
+}
+
+
+#if IFX_LWIP_MULTICORE
+/**
+ * Installs the application callback of an Rx channel. The callback runs on
+ * the CPU of the channel before the frame is handed to lwIP, see Ifx_Netif_RxHook.
  *
- * @note Returning ERR_MEM here if a DMA queue of your MAC is full can lead to
- *       strange results. You might consider waiting for space in the DMA queue
- *       to become availale since the stack doesn't retry to send a packet
- *       dropped because of memory failure (except for the TCP timers).
+ * @param channel the Rx DMA channel
+ * @param hook the callback, NULL to pass all frames to lwIP
+ * @param arg passed to the callback
  */
-static err_t low_level_output(netif_t *netif, pbuf_t *p)
+void ifx_netif_set_rx_hook(IfxGeth_RxDmaChannel channel, Ifx_Netif_RxHook hook, void *arg)
 {
-	IfxGeth_Eth      *ethernetif = netif->state;
-    struct pbuf *q;
+    rxHook[channel] = NULL;
+    __dsync();
+    rxHookArg[channel] = arg;
+    __dsync();
+    rxHook[channel] = hook;
+}
 
-    u16_t        length = p->tot_len;
-    LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_output (p=%#x)\n", p));
 
-#if ETH_PAD_SIZE
-    pbuf_header(p, -ETH_PAD_SIZE); /* drop the padding word */
-#endif
+/**
+ * Receives one frame on the CPU which owns the Rx channel: the application
+ * callback gets the first look, all other frames are queued for the LwIP CPU.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param channel the Rx DMA channel which has received the packet
+ * @return ERR_MEM if the frame has been dropped because the LwIP CPU falls behind
+ *         ERR_INPROGRESS if the frame or its timestamp is still coming in
+ */
+err_t ifx_netif_rx_worker(netif_t *netif, IfxGeth_RxDmaChannel channel)
+{
+    Ifx_Netif_RxHook hook = rxHook[channel];
+    pbuf_t          *p;
+    u16_t            vlanTci;
+    boolean          incomplete;
 
-    if ((p->type_internal == PBUF_REF) || (p->type_internal == PBUF_ROM))
+    p = low_level_input(netif, channel, &vlanTci, &incomplete);
+
+    if (p == NULL)
     {
-        // if PBUF_REF or PBUF_ROM, no copy into ethernet RAM buffer is needed.
-        // see pbuf_alloc_special()
-    	IfxGeth_Eth_sendTransmitBuffer(ethernetif, p->tot_len, IfxGeth_TxDmaChannel_0);
+        return incomplete ? ERR_INPROGRESS : ERR_OK;
     }
-    else
+
+    if (hook != NULL)
     {
-        //initiate transfer();
-        u8_t *tbuf = IfxGeth_Eth_waitTransmitBuffer(ethernetif, IfxGeth_TxDmaChannel_0);
-        u16_t l    = 0;
+        Ifx_Netif_RxInfo info;
 
-        for (q = p; q != NULL; q = q->next)
+        rx_classify(p, vlanTci, &info);
+
+        if (hook(p, &info, rxHookArg[channel]) != FALSE)
         {
-            /* Send the data from the pbuf to the interface, one pbuf at a
-             * time. The size of the data in each pbuf is kept in the ->len
-             * variable. */
-            memcpy((u8_t *)&tbuf[l], q->payload, q->len);
-            l = l + q->len;
-            LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_output: data=%#x, %d\n", q->payload, q->len));
-            LWIP_ASSERT("low_level_output: length overflow the buffer\n", (l < 2048));
+            return ERR_OK;
         }
-        /* we correct the buffer 1 size (maybe overwritten in earlier packet */
-        IfxGeth_TxDescr *pactTxDescriptor;
-        pactTxDescriptor = (IfxGeth_TxDescr *)IfxGeth_Eth_getActualTxDescriptor(ethernetif, IfxGeth_TxDmaChannel_0);
-        /* set the buffer length to the max. available */
-        pactTxDescriptor->TDES2.R.B1L = IFXGETH_MAX_TX_BUFFER_SIZE;
-		IfxGeth_Eth_sendTransmitBuffer(ethernetif, l, IfxGeth_TxDmaChannel_0);
     }
 
-    LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_output: signal length: %d\n", length));
-
-#if ETH_PAD_SIZE
-    pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
-#endif
-
-    LINK_STATS_INC(link.xmit);
-
-    LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_output: return OK\n"));
+    if (Ifx_PbufRing_put(&rxRing[channel], p) == FALSE)
+    {
+        ifx_netif_rx_release(p);
+        rxStats[channel].drop++;
+        return ERR_MEM;
+    }
 
     return ERR_OK;
 }
 
-static uint16 GetRxFrameSize(IfxGeth_RxDescr *descr)
+
+/**
+ * Hands a pbuf of an Rx CPU back to the LwIP CPU, which frees it with its next
+ * ifx_netif_rx_deliver(): pbuf_free() is not called on the CPUs which don't own
+ * the lwIP state. The return ring takes all receive buffers, so it doesn't overflow.
+ * Can be called from any CPU.
+ *
+ * @param p the pbuf (chain) to release
+ */
+void ifx_netif_rx_release(pbuf_t *p)
 {
-  uint16 len;
+    boolean returned = Ifx_PbufRing_putMp(&rxReturnRing, p);
 
-  uint32 rdes3 = descr->RDES3.U;
-  uint32 rdes1 = descr->RDES1.U;
+    LWIP_ASSERT("ifx_netif_rx_release: return ring full", returned);
+    LWIP_UNUSED_ARG(returned);
+}
 
-  if (((rdes3 & (1UL << 15)) != 0U) ||
-	  ((rdes1 & (1UL << 7)) != 0U) ||
-	  ((rdes3 & (1UL << 28)) == 0U))
-  {
-	/* Error, this block is invalid */
-	len = 0xFFFFU;
-  }
-  else
-  {
-    /* Subtract CRC */
-	len = (rdes3 & 0x7FFF) - 4U;
-  }
 
-  return len;
+#if LINK_STATS
+/**
+ * Adds what the CPU of an Rx channel has counted since the last call to the link
+ * stats of lwIP. Runs on the LwIP CPU.
+ *
+ * @param channel the Rx DMA channel
+ */
+static void rx_stats_sum(IfxGeth_RxDmaChannel channel)
+{
+    Ifx_Netif_RxStats counted = rxStats[channel];
+
+    lwip_stats.link.recv   = (STAT_COUNTER)(lwip_stats.link.recv + (counted.recv - rxStatsSummed[channel].recv));
+    lwip_stats.link.drop   = (STAT_COUNTER)(lwip_stats.link.drop + (counted.drop - rxStatsSummed[channel].drop));
+    lwip_stats.link.err    = (STAT_COUNTER)(lwip_stats.link.err + (counted.err - rxStatsSummed[channel].err));
+    lwip_stats.link.memerr = (STAT_COUNTER)(lwip_stats.link.memerr + (counted.memerr - rxStatsSummed[channel].memerr));
+    rxStatsSummed[channel] = counted;
 }
+#endif
+
 
 /**
- * Should allocate a pbuf and transfer the bytes of the incoming
- * packet from the interface into the pbuf.
+ * Hands the frames queued by the CPU of an Rx channel to lwIP. Runs on the LwIP CPU.
  *
  * @param netif the lwip network interface structure for this ethernetif
- * @return a pbuf filled with the received packet (including MAC header)
- *         NULL on memory error
+ * @param channel the Rx DMA channel
+ * @param budget maximum number of frames
+ * @return number of frames handed to lwIP
  */
-static pbuf_t *low_level_input(netif_t *netif)
+uint32 ifx_netif_rx_deliver(netif_t *netif, IfxGeth_RxDmaChannel channel, uint32 budget)
 {
-	IfxGeth_Eth *ethernetif = netif->state;
-    pbuf_t *p, *q;
-    u16_t   len;
+    pbuf_t *p[IFX_LWIP_RX_RING_SIZE];
+    uint32  count;
+    uint32  i;
 
-    len = 0;
-    if (IfxGeth_Eth_isRxDataAvailable(ethernetif, IfxGeth_RxDmaChannel_0) != FALSE)
+    /* free what the Rx CPUs have handed back */
+    while ((count = Ifx_PbufRing_getBatch(&rxReturnRing, p, IFX_LWIP_RX_RING_SIZE)) > 0)
     {
-        len = GetRxFrameSize((IfxGeth_RxDescr *)IfxGeth_Eth_getActualRxDescriptor(ethernetif, IfxGeth_RxDmaChannel_0));
+        for (i = 0; i < count; i++)
+        {
+            pbuf_free(p[i]);
+        }
     }
 
-    if (len == 0)
+#if LINK_STATS
+    rx_stats_sum(channel);
+#endif
+
+    /* take the frames with a single update of the ring, the slots are free for the Rx CPU again */
+    count = Ifx_PbufRing_getBatch(&rxRing[channel], p, LWIP_MIN(budget, IFX_LWIP_RX_RING_SIZE));
+
+    for (i = 0; i < count; i++)
     {
-        return (pbuf_t *)0;
+        low_level_pass(netif, p[i]);
     }
 
-#if ETH_PAD_SIZE
-    len += ETH_PAD_SIZE; /* allow room for Ethernet padding */
+    return count;
+}
 #endif
 
-    /* We allocate a pbuf chain of pbufs from the pool. */
-    p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
 
-    if (p != NULL)
+/**
+ * Tx completion handler: records the status of the transmitted frames, releases
+ * them and hands the queued frames to the freed descriptors. Called from the
+ * main loop after the Tx interrupt and as long as frames are queued.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ */
+void ifx_netif_tx_complete(netif_t *netif)
+{
+    uint32 channel;
+
+    for (channel = 0; channel < IFX_LWIP_NUM_CHANNELS; channel++)
     {
-#if ETH_PAD_SIZE
-        pbuf_header(p, -ETH_PAD_SIZE); /* drop the padding word */
+        tx_reclaim(netif->state, (IfxGeth_TxDmaChannel)channel);
+#if IFX_LWIP_TX_QUEUE_LENGTH > 0
+        tx_flush(netif, (IfxGeth_TxDmaChannel)channel);
 #endif
+    }
+}
 
-        u8_t *src = IfxGeth_Eth_getReceiveBuffer(ethernetif, IfxGeth_RxDmaChannel_0);
 
-        /* We iterate over the pbuf chain until we have read the entire
-         * packet into the pbuf. */
-        for (q = p; ((q != NULL) && (src != NULL)); q = q->next)
-        {
-            /* Read enough bytes to fill this pbuf in the chain. The
-             * available data in the pbuf is given by the q->len
-             * variable.
-             * This does not necessarily have to be a memcpy, you can also preallocate
-             * pbufs for a DMA-enabled MAC and after receiving truncate it to the
-             * actually received size. In this case, ensure the tot_len member of the
-             * pbuf is the sum of the chained pbuf len members.
-             */
-            //read data into(q->payload, q->len);
-            memcpy(q->payload, src, q->len);
-            src = &src[q->len];
+/**
+ * Passes the link state of the default netif on to the VLAN netifs.
+ *
+ * @param up TRUE if the link is up
+ */
+static void vlan_set_link(boolean up)
+{
+#if IFX_LWIP_VLAN_NETIFS > 0
+    uint32 i;
 
-            LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("low_level_input: payload=0x%x, len=%d\n", q->payload, q->len));
+    for (i = 0; i < vlanNetifCount; i++)
+    {
+        if (up != FALSE)
+        {
+            netif_set_link_up(vlanNetifs[i].netif);
+        }
+        else
+        {
+            netif_set_link_down(vlanNetifs[i].netif);
         }
+    }
+#else
+    (void)up;
+#endif
+}
 
-        //acknowledge that packet has been read();
-        IfxGeth_Eth_freeReceiveBuffer(ethernetif, IfxGeth_RxDmaChannel_0);
 
-#if ETH_PAD_SIZE
-        pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
-#endif
+/**
+ * Runs the MDIO accesses of the PHY driver without waiting for them and follows
+ * the link state the PHY reports (IfxGeth_Eth_Phy_Rtl8211f_requestLinkStatus()).
+ * Only when the link comes up with another speed or duplex mode than the MAC
+ * runs, the MAC is stopped, switched to the negotiated mode (the GETH then drives
+ * the RGMII TXC with 125, 25 or 2.5 MHz) and started again. lwIP is told when the
+ * link of the netif and its VLAN netifs goes up or down. Called from the main loop.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ */
+void ifx_netif_link_update(netif_t *netif)
+{
+    IfxGeth_Eth       *ethernetif = netif->state;
+    IfxGeth_LineSpeed  speed;
+    IfxGeth_DuplexMode duplexMode;
 
-        LINK_STATS_INC(link.recv);
+    if (IfxGeth_Eth_Phy_Rtl8211f_process() == 0)
+    {
+        /* no new link status */
+        return;
     }
-    else
+
+    if (IfxGeth_Eth_Phy_Rtl8211f_getLinkStatus(&speed, &duplexMode) == 0)
     {
-        //TODO: drop packet();
-        LINK_STATS_INC(link.memerr);
-        LINK_STATS_INC(link.drop);
+        netif_set_link_down(netif);
+        vlan_set_link(FALSE);
+        return;
     }
 
-    return p;
+    if ((speed != linkSpeed) || (duplexMode != linkDuplexMode))
+    {
+        IfxGeth_mac_disableTransmitter(ethernetif->gethSFR);
+        IfxGeth_mac_disableReceiver(ethernetif->gethSFR);
+        IfxGeth_mac_setLineSpeed(ethernetif->gethSFR, speed);
+        IfxGeth_mac_setDuplexMode(ethernetif->gethSFR, duplexMode);
+#if (IFX_LWIP_TX_CBS_CLASS_A_SLOPE > 0) || (IFX_LWIP_TX_CBS_CLASS_B_SLOPE > 0)
+        tx_shaper_update(ethernetif, speed);
+#endif
+        IfxGeth_mac_enableReceiver(ethernetif->gethSFR);
+        IfxGeth_mac_enableTransmitter(ethernetif->gethSFR);
+
+        linkSpeed      = speed;
+        linkDuplexMode = duplexMode;
+
+        LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_STATE, ("ifx_netif_link_update: %s Mbit/s, %s duplex\n",
+                                                   (speed == IfxGeth_LineSpeed_1000Mbps) ? "1000" : ((speed == IfxGeth_LineSpeed_100Mbps) ? "100" : "10"),
+                                                   (duplexMode == IfxGeth_DuplexMode_fullDuplex) ? "full" : "half"));
+    }
+
+    netif_set_link_up(netif);
+    vlan_set_link(TRUE);
 }
 
 
 /**
- * This function should be called when a packet is ready to be read
- * from the interface. It uses the function low_level_input() that
- * should handle the actual reception of bytes from the network
- * interface. Then the type of the received packet is determined and
- * the appropriate input function is called.
+ * Returns the number of frames waiting for Tx descriptors, over all channels.
  *
  * @param netif the lwip network interface structure for this ethernetif
  */
-err_t ifx_netif_input(netif_t *netif)
+uint32 ifx_netif_tx_queued(netif_t *netif)
 {
-    //Ifx_GETH *ethernetif = netif->state;
-    eth_hdr_t *ethhdr;
-    pbuf_t    *p;
-
-    /* move received packet into a new pbuf */
-    p = low_level_input(netif);
+    uint32 queued = 0;
+#if IFX_LWIP_TX_QUEUE_LENGTH > 0
+    uint32 channel;
 
-    /* no packet could be read, silently ignore this */
-    if (p == NULL)
+    for (channel = 0; channel < IFX_LWIP_NUM_CHANNELS; channel++)
     {
-        //LWIP_DEBUGF(NETIF_DEBUG, ("ifx_netif_input: p == NULL!\n"));
-        return ERR_OK;
+        queued += txQueueCount[channel];
     }
+#endif
 
-    /* points to packet payload, which starts with an Ethernet header */
-    ethhdr = p->payload;
+    (void)netif;
 
-    switch (htons(ethhdr->type))
-    {
-    /* IP or ARP packet? */
-    case ETHTYPE_IP:
-    case ETHTYPE_ARP:
-    case ETHTYPE_VLAN:
-#if PPPOE_SUPPORT
-    /* PPPoE packet? */
-    case ETHTYPE_PPPOEDISC:
-    case ETHTYPE_PPPOE:
-#endif /* PPPOE_SUPPORT */
+    return queued;
+}
 
-        /* full packet send to tcpip_thread to process */
-        if (netif->input(p, netif) != ERR_OK)
-        {
-            LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("ifx_netif_input: IP input error\n"));
-            pbuf_free(p);
-            p = NULL;
-        }
 
-        break;
+/**
+ * Returns the transmit status counters of a Tx channel, updated as its
+ * descriptors are reclaimed.
+ *
+ * @param channel the Tx DMA channel
+ */
+const Ifx_Netif_TxErrors *ifx_netif_get_tx_errors(IfxGeth_TxDmaChannel channel)
+{
+    return &txErrors[channel];
+}
 
-    default:
-        LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("ifx_netif_input: type unknown\n"));
-        pbuf_free(p);
-        p = NULL;
-        break;
+
+#if IFX_LWIP_PTP
+/**
+ * Returns the GETH timestamp of a frame: the receive timestamp of the pbufs
+ * passed up by the driver, the transmit timestamp of a pbuf which has requested
+ * it by IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP. The pbuf keeps it also when a UDP
+ * callback gets it, the payload is not copied.
+ *
+ * @param p the pbuf
+ * @param timestamp the system time of the GETH when the frame has passed the MAC
+ * @return TRUE if the pbuf has a timestamp, FALSE if it has none or the transmit
+ *         timestamp is still pending (the flag is set until the frame has been sent)
+ */
+boolean ifx_netif_get_timestamp(const struct pbuf *p, IfxGeth_Eth_Timestamp *timestamp)
+{
+    if (((p->flags & IFX_NETIF_PBUF_FLAG_TX_TIMESTAMP) != 0) || ((p->ts_sec == 0) && (p->ts_nsec == 0)))
+    {
+        return FALSE;
     }
 
-    return ERR_OK;
+    timestamp->seconds     = p->ts_sec;
+    timestamp->nanoseconds = p->ts_nsec;
+    return TRUE;
 }
+#endif
+
+#if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
+/**
+ * Subscribes to / unsubscribes from a multicast MAC address which is not an IP
+ * group, e.g. the 802.1AS address 01:80:C2:00:00:0E. Shares the address filters
+ * with the IP groups.
+ *
+ * @param netif the default netif
+ * @param addr multicast MAC address
+ * @param action NETIF_ADD_MAC_FILTER or NETIF_DEL_MAC_FILTER
+ * @return ERR_VAL if an address is removed which has not been added
+ */
+err_t ifx_netif_mac_filter(struct netif *netif, const uint8 *addr, enum netif_mac_filter_action action)
+{
+    return mcast_filter(netif, addr, action);
+}
+#endif
 
 
 /**
@@ -562,3 +2830,81 @@ err_t ifx_netif_init(netif_t *netif)
 
     return ERR_OK;
 }
+
+
+#if IFX_LWIP_VLAN_NETIFS > 0
+/**
+ * Sets up a netif on a further VLAN. It shares the GETH (and the MAC address)
+ * with the default netif, which has to be added first, and has its own IP
+ * addresses, ARP entries and IGMP groups. The GETH inserts the VLAN tag into
+ * the frames of the netif and strips it from the received ones, which find the
+ * netif by their VLAN ID.
+ *
+ * This function should be passed as a parameter to netif_add(), with a pointer
+ * to the VLAN tag (u16_t: priority, DEI and VLAN ID) as state.
+ *
+ * @param netif the lwip network interface structure for this VLAN
+ * @return ERR_OK if the netif is initialized
+ *         ERR_MEM if all IFX_LWIP_VLAN_NETIFS are in use
+ *         ERR_VAL if the VLAN ID is 0, the one of the default netif or already in use
+ */
+err_t ifx_netif_vlan_init(netif_t *netif)
+{
+    netif_t *defaultNetif = Ifx_Lwip_getNetIf();
+    u16_t    vlanTag;
+    uint32   i;
+
+    LWIP_ASSERT("netif != NULL", (netif != NULL));
+    LWIP_ASSERT("netif->state != NULL", (netif->state != NULL));
+    LWIP_DEBUGF(NETIF_DEBUG | LWIP_DBG_TRACE, ("ifx_netif_vlan_init ( %#x)\n", netif));
+
+    vlanTag = *(const u16_t *)netif->state;
+
+    if (vlanNetifCount >= IFX_LWIP_VLAN_NETIFS)
+    {
+        LWIP_DEBUGF(NETIF_DEBUG, ("ifx_netif_vlan_init: out of VLAN netifs\n"));
+        return ERR_MEM;
+    }
+
+    if (((vlanTag & 0x0FFFU) == 0) || ((vlanTag & 0x0FFFU) == (IFX_LWIP_VLAN_TAG & 0x0FFFU)))
+    {
+        return ERR_VAL;
+    }
+
+    for (i = 0; i < vlanNetifCount; i++)
+    {
+        if ((vlanNetifs[i].vlanTag & 0x0FFFU) == (vlanTag & 0x0FFFU))
+        {
+            return ERR_VAL;
+        }
+    }
+
+#if LWIP_NETIF_HOSTNAME
+    netif->hostname = defaultNetif->hostname;
+#endif /* LWIP_NETIF_HOSTNAME */
+
+    netif->state      = defaultNetif->state;
+    netif->name[0]    = IFNAME0;
+    netif->name[1]    = IFNAME1;
+    netif->output     = etharp_output;
+    netif->linkoutput = low_level_output;
+
+    low_level_init_netif(netif);
+
+    /* the Rx CPUs look at the table (rx_vlan_if_idx()), the entry is complete before it is counted */
+    vlanNetifs[vlanNetifCount].netif   = netif;
+    vlanNetifs[vlanNetifCount].vlanTag = vlanTag;
+    __dsync();
+    vlanNetifCount++;
+
+    vlan_filter_update(netif->state);
+
+    /* the link follows the default netif from now on (ifx_netif_link_update()) */
+    if (netif_is_link_up(defaultNetif))
+    {
+        netif->flags |= NETIF_FLAG_LINK_UP;
+    }
+
+    return ERR_OK;
+}
+#endif
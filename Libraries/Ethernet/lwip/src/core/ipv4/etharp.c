@@ -100,10 +100,48 @@ struct etharp_entry {
   struct eth_addr ethaddr;
   u16_t ctime;
   u8_t state;
+  /** age list the entry is on (ETHARP_AGE_PENDING/QUEUED/STABLE), ETHARP_AGE_NONE
+      for empty and static entries */
+  u8_t age_list;
+  /** next entry of the hash bucket or of the free list */
+  netif_addr_idx_t next;
+  /** older and younger entry on the age list */
+  netif_addr_idx_t older, younger;
 };
 
 static struct etharp_entry arp_table[ARP_TABLE_SIZE];
 
+/* The links between the entries hold the index + 1, so that the zero
+   initialized table starts with empty buckets and lists. */
+#define ETHARP_LINK(i)   ((netif_addr_idx_t)((i) + 1))
+#define ETHARP_INDEX(l)  ((s16_t)((l) - 1))
+#define ETHARP_NO_LINK   0
+
+/** The entries hashed by IP address (pending, stable and static entries) */
+static netif_addr_idx_t arp_hash[ARP_TABLE_HASH_SIZE];
+#define ETHARP_HASH(ipaddr) ((u16_t)((u32_t)(lwip_ntohl(ip4_addr_get_u32(ipaddr)) * 2654435761UL) >> 16) & (ARP_TABLE_HASH_SIZE - 1))
+
+/** Entries freed once, reused first */
+static netif_addr_idx_t arp_free;
+/** Entries from this index on have never been used */
+static s16_t arp_unused;
+
+/** The dynamic entries in the order their age (ctime) was last reset, the
+    oldest first: the pending entries without queued packets, the pending
+    entries with queued packets (from their first packet on) and the stable
+    entries. etharp_find_entry() recycles the head of one of them. */
+#define ETHARP_AGE_NONE    0
+#define ETHARP_AGE_PENDING 1
+#define ETHARP_AGE_QUEUED  2
+#define ETHARP_AGE_STABLE  3
+static struct {
+  netif_addr_idx_t oldest, youngest;
+} arp_age[3];
+
+#if (ARP_TABLE_HASH_SIZE & (ARP_TABLE_HASH_SIZE - 1)) != 0
+#error "ARP_TABLE_HASH_SIZE must be a power of 2"
+#endif
+
 #if !LWIP_NETIF_HWADDRHINT
 static netif_addr_idx_t etharp_cached_entry;
 #endif /* !LWIP_NETIF_HWADDRHINT */
@@ -163,10 +201,99 @@ free_etharp_q(struct etharp_q_entry *q)
 
 #endif /* ARP_QUEUEING */
 
+/**
+ * Removes an entry from its age list.
+ *
+ * @param i entry index
+ */
+static void
+etharp_age_remove(s16_t i)
+{
+  struct etharp_entry *entry = &arp_table[i];
+
+  if (entry->age_list != ETHARP_AGE_NONE) {
+    if (entry->older != ETHARP_NO_LINK) {
+      arp_table[ETHARP_INDEX(entry->older)].younger = entry->younger;
+    } else {
+      arp_age[entry->age_list - 1].oldest = entry->younger;
+    }
+    if (entry->younger != ETHARP_NO_LINK) {
+      arp_table[ETHARP_INDEX(entry->younger)].older = entry->older;
+    } else {
+      arp_age[entry->age_list - 1].youngest = entry->older;
+    }
+    entry->age_list = ETHARP_AGE_NONE;
+  }
+}
+
+/**
+ * Puts an entry as the youngest one on an age list, when it is created or
+ * its ctime is reset.
+ *
+ * @param i entry index
+ * @param age_list ETHARP_AGE_PENDING, ETHARP_AGE_QUEUED or ETHARP_AGE_STABLE
+ */
+static void
+etharp_age_append(s16_t i, u8_t age_list)
+{
+  struct etharp_entry *entry = &arp_table[i];
+
+  etharp_age_remove(i);
+  entry->age_list = age_list;
+  entry->older = arp_age[age_list - 1].youngest;
+  entry->younger = ETHARP_NO_LINK;
+  if (entry->older != ETHARP_NO_LINK) {
+    arp_table[ETHARP_INDEX(entry->older)].younger = ETHARP_LINK(i);
+  } else {
+    arp_age[age_list - 1].oldest = ETHARP_LINK(i);
+  }
+  arp_age[age_list - 1].youngest = ETHARP_LINK(i);
+}
+
+/**
+ * Looks up the pending, stable or static entry of an IP address.
+ *
+ * @param ipaddr IP address
+ * @param netif netif of the entry (ETHARP_TABLE_MATCH_NETIF), NULL for any
+ * @return entry index, -1 if there is none
+ */
+static s16_t
+etharp_lookup(const ip4_addr_t *ipaddr, struct netif *netif)
+{
+  netif_addr_idx_t l;
+
+  LWIP_UNUSED_ARG(netif);
+
+  for (l = arp_hash[ETHARP_HASH(ipaddr)]; l != ETHARP_NO_LINK; l = arp_table[ETHARP_INDEX(l)].next) {
+    s16_t i = ETHARP_INDEX(l);
+    if ((arp_table[i].state != ETHARP_STATE_EMPTY) &&
+        ip4_addr_cmp(ipaddr, &arp_table[i].ipaddr)
+#if ETHARP_TABLE_MATCH_NETIF
+        && ((netif == NULL) || (netif == arp_table[i].netif))
+#endif /* ETHARP_TABLE_MATCH_NETIF */
+       ) {
+      return i;
+    }
+  }
+  return -1;
+}
+
 /** Clean up ARP table entries */
 static void
 etharp_free_entry(int i)
 {
+  netif_addr_idx_t *link;
+
+  /* remove from the hash bucket and the age list, put on the free list */
+  for (link = &arp_hash[ETHARP_HASH(&arp_table[i].ipaddr)]; *link != ETHARP_NO_LINK; link = &arp_table[ETHARP_INDEX(*link)].next) {
+    if (*link == ETHARP_LINK(i)) {
+      *link = arp_table[i].next;
+      break;
+    }
+  }
+  etharp_age_remove((s16_t)i);
+  arp_table[i].next = arp_free;
+  arp_free = ETHARP_LINK(i);
   /* remove from SNMP ARP index tree */
   mib2_remove_arp_entry(arp_table[i].netif, &arp_table[i].ipaddr);
   /* and empty packet queue */
@@ -245,6 +372,10 @@ etharp_tmr(void)
  * empty entries are available and ETHARP_FLAG_TRY_HARD flag is set, recycle
  * old entries. Heuristic choose the least important entry for recycling.
  *
+ * The entries are looked up in the hash bucket of the address, the empty
+ * entries are kept on a free list and the entries to recycle are taken
+ * from the age lists, no search through the whole table is needed.
+ *
  * @param ipaddr IP address to find in ARP cache, or to add if not found.
  * @param flags See @ref etharp_state
  * @param netif netif related to this address (used for NETIF_HWADDRHINT)
@@ -255,143 +386,77 @@ etharp_tmr(void)
 static s16_t
 etharp_find_entry(const ip4_addr_t *ipaddr, u8_t flags, struct netif *netif)
 {
-  s16_t old_pending = ARP_TABLE_SIZE, old_stable = ARP_TABLE_SIZE;
-  s16_t empty = ARP_TABLE_SIZE;
-  s16_t i = 0;
-  /* oldest entry with packets on queue */
-  s16_t old_queue = ARP_TABLE_SIZE;
-  /* its age */
-  u16_t age_queue = 0, age_pending = 0, age_stable = 0;
+  s16_t i;
 
   LWIP_UNUSED_ARG(netif);
 
-  /**
-   * a) do a search through the cache, remember candidates
-   * b) select candidate entry
-   * c) create new entry
-   */
-
-  /* a) in a single search sweep, do all of this
-   * 1) remember the first empty entry (if any)
-   * 2) remember the oldest stable entry (if any)
-   * 3) remember the oldest pending entry without queued packets (if any)
-   * 4) remember the oldest pending entry with queued packets (if any)
-   * 5) search for a matching IP entry, either pending or stable
-   *    until 5 matches, or all entries are searched for.
-   */
-
-  for (i = 0; i < ARP_TABLE_SIZE; ++i) {
-    u8_t state = arp_table[i].state;
-    /* no empty entry found yet and now we do find one? */
-    if ((empty == ARP_TABLE_SIZE) && (state == ETHARP_STATE_EMPTY)) {
-      LWIP_DEBUGF(ETHARP_DEBUG, ("etharp_find_entry: found empty entry %d\n", (int)i));
-      /* remember first empty entry */
-      empty = i;
-    } else if (state != ETHARP_STATE_EMPTY) {
-      LWIP_ASSERT("state == ETHARP_STATE_PENDING || state >= ETHARP_STATE_STABLE",
-                  state == ETHARP_STATE_PENDING || state >= ETHARP_STATE_STABLE);
-      /* if given, does IP address match IP address in ARP entry? */
-      if (ipaddr && ip4_addr_cmp(ipaddr, &arp_table[i].ipaddr)
-#if ETHARP_TABLE_MATCH_NETIF
-          && ((netif == NULL) || (netif == arp_table[i].netif))
-#endif /* ETHARP_TABLE_MATCH_NETIF */
-         ) {
-        LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: found matching entry %d\n", (int)i));
-        /* found exact IP address match, simply bail out */
-        return i;
-      }
-      /* pending entry? */
-      if (state == ETHARP_STATE_PENDING) {
-        /* pending with queued packets? */
-        if (arp_table[i].q != NULL) {
-          if (arp_table[i].ctime >= age_queue) {
-            old_queue = i;
-            age_queue = arp_table[i].ctime;
-          }
-        } else
-          /* pending without queued packets? */
-        {
-          if (arp_table[i].ctime >= age_pending) {
-            old_pending = i;
-            age_pending = arp_table[i].ctime;
-          }
-        }
-        /* stable entry? */
-      } else if (state >= ETHARP_STATE_STABLE) {
-#if ETHARP_SUPPORT_STATIC_ENTRIES
-        /* don't record old_stable for static entries since they never expire */
-        if (state < ETHARP_STATE_STATIC)
-#endif /* ETHARP_SUPPORT_STATIC_ENTRIES */
-        {
-          /* remember entry with oldest stable entry in oldest, its age in maxtime */
-          if (arp_table[i].ctime >= age_stable) {
-            old_stable = i;
-            age_stable = arp_table[i].ctime;
-          }
-        }
-      }
+  /* search for a matching IP entry, either pending or stable */
+  if (ipaddr != NULL) {
+    i = etharp_lookup(ipaddr, netif);
+    if (i >= 0) {
+      LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: found matching entry %d\n", (int)i));
+      return i;
     }
   }
   /* { we have no match } => try to create a new entry */
 
   /* don't create new entry, only search? */
-  if (((flags & ETHARP_FLAG_FIND_ONLY) != 0) ||
-      /* or no empty entry found and not allowed to recycle? */
-      ((empty == ARP_TABLE_SIZE) && ((flags & ETHARP_FLAG_TRY_HARD) == 0))) {
-    LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no empty entry found and not allowed to recycle\n"));
+  if ((flags & ETHARP_FLAG_FIND_ONLY) != 0) {
     return (s16_t)ERR_MEM;
   }
 
-  /* b) choose the least destructive entry to recycle:
-   * 1) empty entry
-   * 2) oldest stable entry
-   * 3) oldest pending entry without queued packets
-   * 4) oldest pending entry with queued packets
-   *
-   * { ETHARP_FLAG_TRY_HARD is set at this point }
-   */
-
-  /* 1) empty entry available? */
-  if (empty < ARP_TABLE_SIZE) {
-    i = empty;
+  /* take an empty entry: a freed one or one never used */
+  if (arp_free != ETHARP_NO_LINK) {
+    i = ETHARP_INDEX(arp_free);
+    arp_free = arp_table[i].next;
+    LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting empty entry %d\n", (int)i));
+  } else if (arp_unused < ARP_TABLE_SIZE) {
+    i = arp_unused++;
     LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting empty entry %d\n", (int)i));
+  } else if ((flags & ETHARP_FLAG_TRY_HARD) == 0) {
+    /* no empty entry found and not allowed to recycle */
+    LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no empty entry found and not allowed to recycle\n"));
+    return (s16_t)ERR_MEM;
   } else {
-    /* 2) found recyclable stable entry? */
-    if (old_stable < ARP_TABLE_SIZE) {
-      /* recycle oldest stable*/
-      i = old_stable;
+    /* choose the least destructive entry to recycle, the head of an age list:
+     * 1) oldest stable entry
+     * 2) oldest pending entry without queued packets
+     * 3) oldest pending entry with queued packets
+     * static entries are on no age list, they are never recycled */
+    if (arp_age[ETHARP_AGE_STABLE - 1].oldest != ETHARP_NO_LINK) {
+      i = ETHARP_INDEX(arp_age[ETHARP_AGE_STABLE - 1].oldest);
       LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting oldest stable entry %d\n", (int)i));
       /* no queued packets should exist on stable entries */
       LWIP_ASSERT("arp_table[i].q == NULL", arp_table[i].q == NULL);
-      /* 3) found recyclable pending entry without queued packets? */
-    } else if (old_pending < ARP_TABLE_SIZE) {
-      /* recycle oldest pending */
-      i = old_pending;
+    } else if (arp_age[ETHARP_AGE_PENDING - 1].oldest != ETHARP_NO_LINK) {
+      i = ETHARP_INDEX(arp_age[ETHARP_AGE_PENDING - 1].oldest);
       LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting oldest pending entry %d (without queue)\n", (int)i));
-      /* 4) found recyclable pending entry with queued packets? */
-    } else if (old_queue < ARP_TABLE_SIZE) {
-      /* recycle oldest pending (queued packets are free in etharp_free_entry) */
-      i = old_queue;
+      LWIP_ASSERT("arp_table[i].q == NULL", arp_table[i].q == NULL);
+    } else if (arp_age[ETHARP_AGE_QUEUED - 1].oldest != ETHARP_NO_LINK) {
+      i = ETHARP_INDEX(arp_age[ETHARP_AGE_QUEUED - 1].oldest);
       LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting oldest pending entry %d, freeing packet queue %p\n", (int)i, (void *)(arp_table[i].q)));
-      /* no empty or recyclable entries found */
     } else {
       LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no empty or recyclable entries found\n"));
       return (s16_t)ERR_MEM;
     }
 
-    /* { empty or recyclable entry found } */
-    LWIP_ASSERT("i < ARP_TABLE_SIZE", i < ARP_TABLE_SIZE);
+    /* { recyclable entry found } */
     etharp_free_entry(i);
+    LWIP_ASSERT("arp_free == ETHARP_LINK(i)", arp_free == ETHARP_LINK(i));
+    arp_free = arp_table[i].next;
   }
 
   LWIP_ASSERT("i < ARP_TABLE_SIZE", i < ARP_TABLE_SIZE);
   LWIP_ASSERT("arp_table[i].state == ETHARP_STATE_EMPTY",
               arp_table[i].state == ETHARP_STATE_EMPTY);
 
+  arp_table[i].next = ETHARP_NO_LINK;
   /* IP address given? */
   if (ipaddr != NULL) {
     /* set IP address */
     ip4_addr_copy(arp_table[i].ipaddr, *ipaddr);
+    arp_table[i].next = arp_hash[ETHARP_HASH(ipaddr)];
+    arp_hash[ETHARP_HASH(ipaddr)] = ETHARP_LINK(i);
   }
   arp_table[i].ctime = 0;
 #if ETHARP_TABLE_MATCH_NETIF
@@ -443,16 +508,18 @@ etharp_update_arp_entry(struct netif *netif, const ip4_addr_t *ipaddr, struct et
 
 #if ETHARP_SUPPORT_STATIC_ENTRIES
   if (flags & ETHARP_FLAG_STATIC_ENTRY) {
-    /* record static type */
+    /* record static type, it never ages */
     arp_table[i].state = ETHARP_STATE_STATIC;
+    etharp_age_remove(i);
   } else if (arp_table[i].state == ETHARP_STATE_STATIC) {
     /* found entry is a static type, don't overwrite it */
     return ERR_VAL;
   } else
 #endif /* ETHARP_SUPPORT_STATIC_ENTRIES */
   {
-    /* mark it stable */
+    /* mark it stable, it becomes the youngest stable entry */
     arp_table[i].state = ETHARP_STATE_STABLE;
+    etharp_age_append(i, ETHARP_AGE_STABLE);
   }
 
   /* record network interface */
@@ -820,6 +887,7 @@ etharp_output(struct netif *netif, struct pbuf *q, const ip4_addr_t *ipaddr)
     /* unicast destination IP address? */
   } else {
     netif_addr_idx_t i;
+    s16_t i_err;
     /* outside local network? if so, this can neither be a global broadcast nor
        a subnet broadcast. */
     if (!ip4_addr_netcmp(ipaddr, netif_ip4_addr(netif), netif_ip4_netmask(netif)) &&
@@ -872,18 +940,13 @@ etharp_output(struct netif *netif, struct pbuf *q, const ip4_addr_t *ipaddr)
     }
 #endif /* LWIP_NETIF_HWADDRHINT */
 
-    /* find stable entry: do this here since this is a critical path for
-       throughput and etharp_find_entry() is kind of slow */
-    for (i = 0; i < ARP_TABLE_SIZE; i++) {
-      if ((arp_table[i].state >= ETHARP_STATE_STABLE) &&
-#if ETHARP_TABLE_MATCH_NETIF
-          (arp_table[i].netif == netif) &&
-#endif
-          (ip4_addr_cmp(dst_addr, &arp_table[i].ipaddr))) {
-        /* found an existing, stable entry */
-        ETHARP_SET_ADDRHINT(netif, i);
-        return etharp_output_to_arp_index(netif, q, i);
-      }
+    /* find stable entry in the hash bucket of the address */
+    i_err = etharp_lookup(dst_addr, netif);
+    if ((i_err >= 0) && (arp_table[i_err].state >= ETHARP_STATE_STABLE)) {
+      /* found an existing, stable entry */
+      i = (netif_addr_idx_t)i_err;
+      ETHARP_SET_ADDRHINT(netif, i);
+      return etharp_output_to_arp_index(netif, q, i);
     }
     /* no stable entry found, use the (slower) query function:
        queue on destination Ethernet address belonging to ipaddr */
@@ -965,6 +1028,7 @@ etharp_query(struct netif *netif, const ip4_addr_t *ipaddr, struct pbuf *q)
   if (arp_table[i].state == ETHARP_STATE_EMPTY) {
     is_new_entry = 1;
     arp_table[i].state = ETHARP_STATE_PENDING;
+    etharp_age_append((s16_t)i, ETHARP_AGE_PENDING);
     /* record network interface for re-sending arp request in etharp_tmr */
     arp_table[i].netif = netif;
   }
@@ -1045,6 +1109,7 @@ etharp_query(struct netif *netif, const ip4_addr_t *ipaddr, struct pbuf *q)
         } else {
           /* queue did not exist, first item in queue */
           arp_table[i].q = new_entry;
+          etharp_age_append((s16_t)i, ETHARP_AGE_QUEUED);
         }
 #if ARP_QUEUE_LEN
         if (qlen >= ARP_QUEUE_LEN) {
@@ -1068,6 +1133,8 @@ etharp_query(struct netif *netif, const ip4_addr_t *ipaddr, struct pbuf *q)
       if (arp_table[i].q != NULL) {
         LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_query: dropped previously queued packet %p for ARP entry %"U16_F"\n", (void *)q, (u16_t)i));
         pbuf_free(arp_table[i].q);
+      } else {
+        etharp_age_append((s16_t)i, ETHARP_AGE_QUEUED);
       }
       arp_table[i].q = p;
       result = ERR_OK;
@@ -104,9 +104,24 @@ static void   igmp_start_timer(struct igmp_group *group, u8_t max_time);
 static void   igmp_delaying_member(struct igmp_group *group, u8_t maxresp);
 static err_t  igmp_ip_output_if(struct pbuf *p, const ip4_addr_t *src, const ip4_addr_t *dest, struct netif *netif);
 static void   igmp_send(struct netif *netif, struct igmp_group *group, u8_t type);
+static void   igmp_stop_timer(struct igmp_group *group);
+static void   igmp_hash_remove(struct igmp_group *group);
+static void   igmp_schedule_reports(struct netif *netif, u8_t maxresp);
 
 static ip4_addr_t     allsystems;
 static ip4_addr_t     allrouters;
+
+/** Slots of the report timer wheel, covers the largest max response time (255) */
+#define IGMP_TIMER_SLOTS 256
+/** Hash bucket of a group address */
+#define IGMP_GROUP_HASH(addr) ((u16_t)((u32_t)(lwip_ntohl(ip4_addr_get_u32(addr)) * 2654435761UL) >> 16) & (IGMP_GROUP_HASH_SIZE - 1))
+
+/** The groups of all netifs by group address */
+static struct igmp_group *igmp_group_hash[IGMP_GROUP_HASH_SIZE];
+/** The groups with a running report timer by the slot they expire in */
+static struct igmp_group *igmp_timer_wheel[IGMP_TIMER_SLOTS];
+/** Slot of the last igmp_tmr() call */
+static u8_t igmp_tmr_pos;
 /**
  * Initialize the IGMP module
  */
@@ -178,6 +193,8 @@ igmp_stop(struct netif *netif)
     }
 
     /* free group */
+    igmp_stop_timer(group);
+    igmp_hash_remove(group);
     memp_free(MEMP_IGMP_GROUP, group);
 
     /* move to "next" */
@@ -194,18 +211,32 @@ igmp_stop(struct netif *netif)
 void
 igmp_report_groups(struct netif *netif)
 {
-  struct igmp_group *group = netif_igmp_data(netif);
-
   LWIP_DEBUGF(IGMP_DEBUG, ("igmp_report_groups: sending IGMP reports on if %p\n", (void *)netif));
 
-  /* Skip the first group in the list, it is always the allsystems group added in igmp_start() */
-  if (group != NULL) {
-    group = group->next;
-  }
+  igmp_schedule_reports(netif, IGMP_JOIN_DELAYING_MEMBER_TMR);
+}
 
-  while (group != NULL) {
-    igmp_delaying_member(group, IGMP_JOIN_DELAYING_MEMBER_TMR);
-    group = group->next;
+/**
+ * Let igmp_tmr() delay a membership report for every group of a netif
+ * (except the allsystems group), at least IGMP_QUERY_GROUPS_PER_TMR groups
+ * per call and enough to be done before the response time runs out.
+ * A sweep already pending is restarted, with the shorter response time.
+ *
+ * @param netif network interface whose groups to report
+ * @param maxresp the time the reports are due within
+ */
+static void
+igmp_schedule_reports(struct netif *netif, u8_t maxresp)
+{
+  struct igmp_group *list_head = netif_igmp_data(netif);
+
+  if ((list_head != NULL) && (list_head->next != NULL)) {
+    if ((list_head->query_next == NULL) || (maxresp < list_head->query_maxresp)) {
+      list_head->query_maxresp = maxresp;
+    }
+    /* Skip the first group in the list, it is always the allsystems group added in igmp_start() */
+    list_head->query_next = list_head->next;
+    list_head->query_left = list_head->num_groups;
   }
 }
 
@@ -220,13 +251,12 @@ igmp_report_groups(struct netif *netif)
 struct igmp_group *
 igmp_lookfor_group(struct netif *ifp, const ip4_addr_t *addr)
 {
-  struct igmp_group *group = netif_igmp_data(ifp);
+  struct igmp_group *group;
 
-  while (group != NULL) {
-    if (ip4_addr_cmp(&(group->group_address), addr)) {
+  for (group = igmp_group_hash[IGMP_GROUP_HASH(addr)]; group != NULL; group = group->hash_next) {
+    if ((group->netif == ifp) && ip4_addr_cmp(&(group->group_address), addr)) {
       return group;
     }
-    group = group->next;
   }
 
   /* to be clearer, we return NULL here instead of
@@ -259,11 +289,22 @@ igmp_lookup_group(struct netif *ifp, const ip4_addr_t *addr)
   /* Group doesn't exist yet, create a new one */
   group = (struct igmp_group *)memp_malloc(MEMP_IGMP_GROUP);
   if (group != NULL) {
+    u16_t bucket = IGMP_GROUP_HASH(addr);
+
     ip4_addr_set(&(group->group_address), addr);
-    group->timer              = 0; /* Not running */
+    group->netif              = ifp;
+    group->timer              = 0;
+    group->timer_next         = NULL;
+    group->timer_pprev        = NULL; /* Not running */
+    group->query_next         = NULL;
+    group->query_maxresp      = 0;
+    group->num_groups         = 0;
+    group->query_left         = 0;
     group->group_state        = IGMP_GROUP_NON_MEMBER;
     group->last_reporter_flag = 0;
     group->use                = 0;
+    group->hash_next          = igmp_group_hash[bucket];
+    igmp_group_hash[bucket]   = group;
 
     /* Ensure allsystems group is always first in list */
     if (list_head == NULL) {
@@ -278,6 +319,7 @@ igmp_lookup_group(struct netif *ifp, const ip4_addr_t *addr)
                   (ip4_addr_cmp(addr, &allsystems) == 0));
       group->next = list_head->next;
       list_head->next = group;
+      list_head->num_groups++;
     }
   }
 
@@ -288,6 +330,24 @@ igmp_lookup_group(struct netif *ifp, const ip4_addr_t *addr)
   return group;
 }
 
+/**
+ * Remove a group from the hash table
+ *
+ * @param group the group to remove
+ */
+static void
+igmp_hash_remove(struct igmp_group *group)
+{
+  struct igmp_group **link;
+
+  for (link = &igmp_group_hash[IGMP_GROUP_HASH(&group->group_address)]; *link != NULL; link = &(*link)->hash_next) {
+    if (*link == group) {
+      *link = group->hash_next;
+      break;
+    }
+  }
+}
+
 /**
  * Remove a group from netif's igmp group list, but don't free it yet
  *
@@ -310,6 +370,16 @@ igmp_remove_group(struct netif *netif, struct igmp_group *group)
   /* Group not found in netif's igmp group list */
   if (tmp_group == NULL) {
     err = ERR_ARG;
+  } else {
+    struct igmp_group *list_head = netif_igmp_data(netif);
+
+    list_head->num_groups--;
+    /* a pending query continues with the next group */
+    if (list_head->query_next == group) {
+      list_head->query_next = group->next;
+    }
+    igmp_stop_timer(group);
+    igmp_hash_remove(group);
   }
 
   return err;
@@ -327,7 +397,6 @@ igmp_input(struct pbuf *p, struct netif *inp, const ip4_addr_t *dest)
 {
   struct igmp_msg   *igmp;
   struct igmp_group *group;
-  struct igmp_group *groupref;
 
   IGMP_STATS_INC(igmp.recv);
 
@@ -381,18 +450,9 @@ igmp_input(struct pbuf *p, struct netif *inp, const ip4_addr_t *dest)
           IGMP_STATS_INC(igmp.rx_general);
         }
 
-        groupref = netif_igmp_data(inp);
-
-        /* Do not send messages on the all systems group address! */
-        /* Skip the first group in the list, it is always the allsystems group added in igmp_start() */
-        if (groupref != NULL) {
-          groupref = groupref->next;
-        }
-
-        while (groupref) {
-          igmp_delaying_member(groupref, igmp->igmp_maxresp);
-          groupref = groupref->next;
-        }
+        /* Do not send messages on the all systems group address!
+           The reports are scheduled by igmp_tmr(), not for all groups here */
+        igmp_schedule_reports(inp, igmp->igmp_maxresp);
       } else {
         /* IGMP_MEMB_QUERY to a specific group ? */
         if (!ip4_addr_isany(&igmp->igmp_group_address)) {
@@ -424,7 +484,7 @@ igmp_input(struct pbuf *p, struct netif *inp, const ip4_addr_t *dest)
       IGMP_STATS_INC(igmp.rx_report);
       if (group->group_state == IGMP_GROUP_DELAYING_MEMBER) {
         /* This is on a specific group we have already looked up */
-        group->timer = 0; /* stopped */
+        igmp_stop_timer(group);
         group->group_state = IGMP_GROUP_IDLE_MEMBER;
         group->last_reporter_flag = 0;
       }
@@ -644,18 +704,42 @@ void
 igmp_tmr(void)
 {
   struct netif *netif;
+  struct igmp_group *group;
+
+  /* only the groups expiring now */
+  igmp_tmr_pos++;
+  while ((group = igmp_timer_wheel[igmp_tmr_pos]) != NULL) {
+    igmp_stop_timer(group);
+    igmp_timeout(group->netif, group);
+  }
 
+  /* continue the pending queries */
   NETIF_FOREACH(netif) {
-    struct igmp_group *group = netif_igmp_data(netif);
+    struct igmp_group *list_head = netif_igmp_data(netif);
 
-    while (group != NULL) {
-      if (group->timer > 0) {
-        group->timer--;
-        if (group->timer == 0) {
-          igmp_timeout(netif, group);
-        }
+    if ((list_head != NULL) && (list_head->query_next != NULL)) {
+      /* a report is delayed by 1 .. maxresp - 1 calls: this call and the calls up to the
+         last but one of the response time share the groups left, the last one takes all */
+      u16_t ticks = (u16_t)((list_head->query_maxresp > 2) ? (list_head->query_maxresp - 1) : 1);
+      u16_t batch = (u16_t)((list_head->query_left + ticks - 1) / ticks);
+      u16_t n;
+
+      if (batch < IGMP_QUERY_GROUPS_PER_TMR) {
+        batch = IGMP_QUERY_GROUPS_PER_TMR;
+      }
+      if (ticks == 1) {
+        batch = 0xFFFF;
+      }
+      for (n = 0; (n < batch) && (list_head->query_next != NULL); n++) {
+        group = list_head->query_next;
+        list_head->query_next = group->next;
+        igmp_delaying_member(group, list_head->query_maxresp);
+      }
+      list_head->query_left = (u16_t)((list_head->query_left > n) ? (list_head->query_left - n) : 0);
+      /* the groups left get the time left */
+      if (list_head->query_maxresp > 1) {
+        list_head->query_maxresp--;
       }
-      group = group->next;
     }
   }
 }
@@ -694,15 +778,44 @@ igmp_timeout(struct netif *netif, struct igmp_group *group)
 static void
 igmp_start_timer(struct igmp_group *group, u8_t max_time)
 {
+  u8_t delay;
+
 #ifdef LWIP_RAND
-  group->timer = (u16_t)(max_time > 2 ? (LWIP_RAND() % max_time) : 1);
+  delay = (u8_t)(max_time > 2 ? (LWIP_RAND() % max_time) : 1);
 #else /* LWIP_RAND */
   /* ATTENTION: use this only if absolutely necessary! */
-  group->timer = max_time / 2;
+  delay = max_time / 2;
 #endif /* LWIP_RAND */
 
-  if (group->timer == 0) {
-    group->timer = 1;
+  if (delay == 0) {
+    delay = 1;
+  }
+
+  igmp_stop_timer(group);
+  group->timer = (u8_t)(igmp_tmr_pos + delay);
+  group->timer_next = igmp_timer_wheel[group->timer];
+  if (group->timer_next != NULL) {
+    group->timer_next->timer_pprev = &group->timer_next;
+  }
+  group->timer_pprev = &igmp_timer_wheel[group->timer];
+  igmp_timer_wheel[group->timer] = group;
+}
+
+/**
+ * Stop the timer of an igmp group, if it is running
+ *
+ * @param group the igmp_group whose timer to stop
+ */
+static void
+igmp_stop_timer(struct igmp_group *group)
+{
+  if (group->timer_pprev != NULL) {
+    *group->timer_pprev = group->timer_next;
+    if (group->timer_next != NULL) {
+      group->timer_next->timer_pprev = group->timer_pprev;
+    }
+    group->timer_next = NULL;
+    group->timer_pprev = NULL;
   }
 }
 
@@ -717,7 +830,7 @@ igmp_delaying_member(struct igmp_group *group, u8_t maxresp)
 {
   if ((group->group_state == IGMP_GROUP_IDLE_MEMBER) ||
       ((group->group_state == IGMP_GROUP_DELAYING_MEMBER) &&
-       ((group->timer == 0) || (maxresp < group->timer)))) {
+       ((group->timer_pprev == NULL) || (maxresp < (u8_t)(group->timer - igmp_tmr_pos))))) {
     igmp_start_timer(group, maxresp);
     group->group_state = IGMP_GROUP_DELAYING_MEMBER;
   }
@@ -56,6 +56,9 @@
 #include "lwip/autoip.h"
 #include "lwip/stats.h"
 #include "lwip/prot/iana.h"
+#include "lwip/prot/icmp.h"
+#include "lwip/prot/tcp.h"
+#include "lwip/prot/udp.h"
 
 #include <string.h>
 
@@ -496,7 +499,7 @@ ip4_input(struct pbuf *p, struct netif *inp)
 
   /* verify checksum */
 #if CHECKSUM_CHECK_IP
-  IF__NETIF_CHECKSUM_ENABLED(inp, NETIF_CHECKSUM_CHECK_IP) {
+  IF__NETIF_CHECKSUM_CHECK_ENABLED(inp, p, NETIF_CHECKSUM_CHECK_IP) {
     if (inet_chksum(iphdr, iphdr_hlen) != 0) {
 
       LWIP_DEBUGF(IP_DEBUG | LWIP_DBG_LEVEL_SERIOUS,
@@ -758,6 +761,101 @@ ip4_input(struct pbuf *p, struct netif *inp)
   return ERR_OK;
 }
 
+#if TCP_TSO_MAX_SIZE
+/**
+ * Reserves the IP identifications of the frames a TSO capable netif cuts a TCP
+ * segment into: the netif numbers them on from the ID in the header, so the
+ * next datagram must not take one of them.
+ *
+ * @param p the TCP segment (p->payload points to the IP header, the TCP
+ *        header follows in the same pbuf)
+ * @param netif the netif which cuts the segment into frames of its mtu
+ */
+static void
+ip4_tso_reserve_ids(struct pbuf *p, struct netif *netif)
+{
+  struct ip_hdr *iphdr = (struct ip_hdr *)p->payload;
+  u16_t hlen = IPH_HL_BYTES(iphdr);
+  u16_t mss;
+  u16_t frames;
+
+  if (p->len < (hlen + TCP_HLEN)) {
+    return;
+  }
+  hlen = (u16_t)(hlen + TCPH_HDRLEN_BYTES((struct tcp_hdr *)((u8_t *)iphdr + IPH_HL_BYTES(iphdr))));
+  if (netif->mtu <= hlen) {
+    return;
+  }
+  mss = (u16_t)(netif->mtu - hlen);
+  frames = (u16_t)((p->tot_len - hlen + mss - 1) / mss);
+  /* the ID of the first frame has been taken when the header was built */
+  ip_id = (u16_t)(ip_id + frames - 1);
+}
+#endif /* TCP_TSO_MAX_SIZE */
+
+#if IP_FRAG && LWIP_CHECKSUM_CTRL_PER_NETIF
+/**
+ * Generates the UDP, TCP or ICMP checksum of a datagram which is about to be
+ * fragmented although the netif inserts that checksum (its NETIF_CHECKSUM_GEN_*
+ * flag is off): a netif only sees the fragments and cannot insert the checksum
+ * of the whole datagram.
+ *
+ * @param p the datagram (p->payload points to the IP header)
+ * @param netif the netif the fragments are sent on
+ */
+static void
+ip4_frag_chksum(struct pbuf *p, struct netif *netif)
+{
+  struct ip_hdr *iphdr = (struct ip_hdr *)p->payload;
+  u16_t hlen = IPH_HL_BYTES(iphdr);
+  u8_t proto = IPH_PROTO(iphdr);
+  ip4_addr_t src, dest;
+
+  if ((IPH_OFFSET(iphdr) & PP_HTONS(IP_OFFMASK | IP_MF)) != 0) {
+    /* a fragment already, the checksum is in the first one */
+    return;
+  }
+  ip4_addr_copy(src, iphdr->src);
+  ip4_addr_copy(dest, iphdr->dest);
+  if (pbuf_remove_header(p, hlen)) {
+    return;
+  }
+
+#if CHECKSUM_GEN_UDP
+  if ((proto == IP_PROTO_UDP) && ((netif->chksum_flags & NETIF_CHECKSUM_GEN_UDP) == 0) &&
+      (p->len >= sizeof(struct udp_hdr))) {
+    struct udp_hdr *udphdr = (struct udp_hdr *)p->payload;
+    u16_t udpchksum;
+
+    udphdr->chksum = 0;
+    udpchksum = inet_chksum_pseudo(p, IP_PROTO_UDP, p->tot_len, &src, &dest);
+    /* chksum zero must become 0xffff, as zero means 'no checksum' */
+    udphdr->chksum = (udpchksum == 0x0000) ? 0xffff : udpchksum;
+  }
+#endif /* CHECKSUM_GEN_UDP */
+#if CHECKSUM_GEN_TCP
+  if ((proto == IP_PROTO_TCP) && ((netif->chksum_flags & NETIF_CHECKSUM_GEN_TCP) == 0) &&
+      (p->len >= TCP_HLEN)) {
+    struct tcp_hdr *tcphdr = (struct tcp_hdr *)p->payload;
+
+    tcphdr->chksum = 0;
+    tcphdr->chksum = inet_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len, &src, &dest);
+  }
+#endif /* CHECKSUM_GEN_TCP */
+#if CHECKSUM_GEN_ICMP
+  if ((proto == IP_PROTO_ICMP) && ((netif->chksum_flags & NETIF_CHECKSUM_GEN_ICMP) == 0) &&
+      (p->len >= sizeof(struct icmp_echo_hdr))) {
+    struct icmp_echo_hdr *icmphdr = (struct icmp_echo_hdr *)p->payload;
+
+    icmphdr->chksum = 0;
+    icmphdr->chksum = inet_chksum_pbuf(p);
+  }
+#endif /* CHECKSUM_GEN_ICMP */
+
+  pbuf_add_header(p, hlen);
+}
+#endif /* IP_FRAG && LWIP_CHECKSUM_CTRL_PER_NETIF */
+
 /**
  * Sends an IP packet on a network interface. This function constructs
  * the IP header and calculates the IP header checksum. If the source
@@ -996,9 +1094,21 @@ ip4_output_if_opt_src(struct pbuf *p, const ip4_addr_t *src, const ip4_addr_t *d
   }
 #endif /* LWIP_MULTICAST_TX_OPTIONS */
 #endif /* ENABLE_LOOPBACK */
+#if TCP_TSO_MAX_SIZE
+  /* TCP segments are cut into frames by a TSO capable netif */
+  if (netif->mtu && (p->tot_len > netif->mtu) &&
+      (netif->flags & NETIF_FLAG_TSO) && (IPH_PROTO((struct ip_hdr *)p->payload) == IP_PROTO_TCP)) {
+    ip4_tso_reserve_ids(p, netif);
+    LWIP_DEBUGF(IP_DEBUG, ("ip4_output_if: call netif->output()\n"));
+    return netif->output(netif, p, dest);
+  }
+#endif /* TCP_TSO_MAX_SIZE */
 #if IP_FRAG
   /* don't fragment if interface has mtu set to 0 [loopif] */
   if (netif->mtu && (p->tot_len > netif->mtu)) {
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+    ip4_frag_chksum(p, netif);
+#endif /* LWIP_CHECKSUM_CTRL_PER_NETIF */
     return ip4_frag(p, netif, dest);
   }
 #endif /* IP_FRAG */
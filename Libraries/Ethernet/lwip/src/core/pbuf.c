@@ -186,6 +186,7 @@ pbuf_init_alloced_pbuf(struct pbuf *p, void *payload, u16_t tot_len, u16_t len,
   p->flags = flags;
   p->ref = 1;
   p->if_idx = NETIF_NO_INDEX;
+  LWIP_PBUF_CUSTOM_DATA_INIT(p);
 }
 
 /**
@@ -1314,6 +1315,41 @@ pbuf_clone(pbuf_layer layer, pbuf_type type, struct pbuf *p)
   err = pbuf_copy(q, p);
   LWIP_UNUSED_ARG(err); /* in case of LWIP_NOASSERT */
   LWIP_ASSERT("pbuf_copy failed", err == ERR_OK);
+  LWIP_PBUF_CUSTOM_DATA_COPY(q, p);
+  return q;
+}
+
+/**
+ * @ingroup pbuf
+ * Copy-on-write for a pbuf which may be referenced by others, e.g. a
+ * multicast datagram passed to several pcbs (SO_REUSE_RXTOALL_SHARED).
+ * If the caller holds the only reference to every pbuf of the chain, p is
+ * returned as is; otherwise p is copied into a new pbuf (via pbuf_clone())
+ * and the caller's reference to p is released.
+ *
+ * @param p the pbuf to modify
+ *
+ * @return a pbuf the caller may modify, or NULL if the copy could not be
+ *         allocated (p is left untouched then)
+ */
+struct pbuf *
+pbuf_unshare(struct pbuf *p)
+{
+  struct pbuf *q;
+
+  for (q = p; q != NULL; q = q->next) {
+    if (q->ref != 1) {
+      break;
+    }
+  }
+  if (q == NULL) {
+    return p;
+  }
+  q = pbuf_clone(PBUF_TRANSPORT, PBUF_RAM, p);
+  if (q == NULL) {
+    return NULL;
+  }
+  pbuf_free(p);
   return q;
 }
 
@@ -182,6 +182,17 @@ struct tcp_pcb **const tcp_pcb_lists[] = {&tcp_listen_pcbs.pcbs, &tcp_bound_pcbs
          &tcp_active_pcbs, &tcp_tw_pcbs
 };
 
+#if (TCP_PCB_HASH_SIZE & (TCP_PCB_HASH_SIZE - 1)) != 0
+#error "TCP_PCB_HASH_SIZE must be a power of 2"
+#endif
+
+/** The PCBs of tcp_active_pcbs hashed by remote address, remote and local port */
+struct tcp_pcb *tcp_active_hash[TCP_PCB_HASH_SIZE];
+/** The PCBs of tcp_tw_pcbs hashed by remote address, remote and local port */
+struct tcp_pcb *tcp_tw_hash[TCP_PCB_HASH_SIZE];
+/** The PCBs of tcp_listen_pcbs hashed by local port */
+struct tcp_pcb *tcp_listen_hash[TCP_PCB_HASH_SIZE];
+
 u8_t tcp_active_pcbs_changed;
 
 /** Timer counter to handle calling slow-timer from tcp_tmr() */
@@ -1393,6 +1404,7 @@ tcp_slowtmr_start:
         LWIP_ASSERT("tcp_slowtmr: first pcb == tcp_active_pcbs", tcp_active_pcbs == pcb);
         tcp_active_pcbs = pcb->next;
       }
+      tcp_pcb_hash_rmv(&tcp_active_pcbs, pcb);
 
       if (pcb_reset) {
         tcp_rst(pcb, pcb->snd_nxt, pcb->rcv_nxt, &pcb->local_ip, &pcb->remote_ip,
@@ -1459,6 +1471,7 @@ tcp_slowtmr_start:
         LWIP_ASSERT("tcp_slowtmr: first pcb == tcp_tw_pcbs", tcp_tw_pcbs == pcb);
         tcp_tw_pcbs = pcb->next;
       }
+      tcp_pcb_hash_rmv(&tcp_tw_pcbs, pcb);
       pcb2 = pcb;
       pcb = pcb->next;
       tcp_free(pcb2);
@@ -2167,6 +2180,98 @@ tcp_pcb_purge(struct tcp_pcb *pcb)
   }
 }
 
+/**
+ * Hash of the connection a PCB or a segment belongs to.
+ *
+ * @param remote_ip remote address, NULL for listening PCBs
+ * @param local_port local port
+ * @param remote_port remote port, 0 for listening PCBs
+ * @return index into tcp_active_hash, tcp_tw_hash or tcp_listen_hash
+ */
+u16_t
+tcp_pcb_hash(const ip_addr_t *remote_ip, u16_t local_port, u16_t remote_port)
+{
+  u32_t h = ((u32_t)remote_port << 16) ^ local_port;
+
+  if (remote_ip != NULL) {
+#if LWIP_IPV6
+    if (IP_IS_V6(remote_ip)) {
+      h ^= ip_2_ip6(remote_ip)->addr[3];
+    } else
+#endif /* LWIP_IPV6 */
+    {
+#if LWIP_IPV4
+      h ^= ip_2_ip4(remote_ip)->addr;
+#endif /* LWIP_IPV4 */
+    }
+  }
+  h ^= h >> 16;
+  h ^= h >> 8;
+  return (u16_t)(h & (TCP_PCB_HASH_SIZE - 1));
+}
+
+/**
+ * Returns the hash bucket a PCB of a PCB list belongs to.
+ *
+ * @param pcbs the PCB list
+ * @param pcb the PCB
+ * @return the head of the bucket, NULL for the lists without hash table
+ */
+static struct tcp_pcb **
+tcp_pcb_hash_bucket(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+  if (pcbs == &tcp_active_pcbs) {
+    return &tcp_active_hash[tcp_pcb_hash(&pcb->remote_ip, pcb->local_port, pcb->remote_port)];
+  }
+  if (pcbs == &tcp_tw_pcbs) {
+    return &tcp_tw_hash[tcp_pcb_hash(&pcb->remote_ip, pcb->local_port, pcb->remote_port)];
+  }
+  if (pcbs == &tcp_listen_pcbs.pcbs) {
+    /* a struct tcp_pcb_listen, only the common members may be accessed */
+    return &tcp_listen_hash[tcp_pcb_hash(NULL, pcb->local_port, 0)];
+  }
+  return NULL;
+}
+
+/**
+ * Adds a PCB to the hash table of a PCB list (called by TCP_REG).
+ *
+ * @param pcbs the PCB list the PCB has been added to
+ * @param npcb the PCB
+ */
+void
+tcp_pcb_hash_reg(struct tcp_pcb **pcbs, struct tcp_pcb *npcb)
+{
+  struct tcp_pcb **bucket = tcp_pcb_hash_bucket(pcbs, npcb);
+
+  if (bucket != NULL) {
+    npcb->hash_next = *bucket;
+    *bucket = npcb;
+  }
+}
+
+/**
+ * Removes a PCB from the hash table of a PCB list (called by TCP_RMV).
+ *
+ * @param pcbs the PCB list the PCB has been removed from
+ * @param npcb the PCB
+ */
+void
+tcp_pcb_hash_rmv(struct tcp_pcb **pcbs, struct tcp_pcb *npcb)
+{
+  struct tcp_pcb **bucket = tcp_pcb_hash_bucket(pcbs, npcb);
+
+  if (bucket != NULL) {
+    for (; *bucket != NULL; bucket = &(*bucket)->hash_next) {
+      if (*bucket == npcb) {
+        *bucket = npcb->hash_next;
+        break;
+      }
+    }
+    npcb->hash_next = NULL;
+  }
+}
+
 /**
  * Purges the PCB and removes it from a PCB list. Any delayed ACKs are sent first.
  *
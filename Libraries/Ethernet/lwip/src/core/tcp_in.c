@@ -117,10 +117,9 @@ static void tcp_remove_sacks_gt(struct tcp_pcb *pcb, u32_t seq);
 void
 tcp_input(struct pbuf *p, struct netif *inp)
 {
-  struct tcp_pcb *pcb, *prev;
+  struct tcp_pcb *pcb;
   struct tcp_pcb_listen *lpcb;
 #if SO_REUSE
-  struct tcp_pcb *lpcb_prev = NULL;
   struct tcp_pcb_listen *lpcb_any = NULL;
 #endif /* SO_REUSE */
   u8_t hdrlen_bytes;
@@ -157,7 +156,7 @@ tcp_input(struct pbuf *p, struct netif *inp)
   }
 
 #if CHECKSUM_CHECK_TCP
-  IF__NETIF_CHECKSUM_ENABLED(inp, NETIF_CHECKSUM_CHECK_TCP) {
+  IF__NETIF_CHECKSUM_CHECK_ENABLED(inp, p, NETIF_CHECKSUM_CHECK_TCP) {
     /* Verify TCP checksum. */
     u16_t chksum = ip_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len,
                                     ip_current_src_addr(), ip_current_dest_addr());
@@ -244,10 +243,10 @@ tcp_input(struct pbuf *p, struct netif *inp)
   }
 
   /* Demultiplex an incoming segment. First, we check if it is destined
-     for an active connection. */
-  prev = NULL;
-
-  for (pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
+     for an active connection. The active PCBs are hashed by their
+     connection, only the PCBs in the bucket of the segment are compared. */
+  for (pcb = tcp_active_hash[tcp_pcb_hash(ip_current_src_addr(), tcphdr->dest, tcphdr->src)];
+       pcb != NULL; pcb = pcb->hash_next) {
     LWIP_ASSERT("tcp_input: active pcb->state != CLOSED", pcb->state != CLOSED);
     LWIP_ASSERT("tcp_input: active pcb->state != TIME-WAIT", pcb->state != TIME_WAIT);
     LWIP_ASSERT("tcp_input: active pcb->state != LISTEN", pcb->state != LISTEN);
@@ -255,7 +254,6 @@ tcp_input(struct pbuf *p, struct netif *inp)
     /* check if PCB is bound to specific netif */
     if ((pcb->netif_idx != NETIF_NO_INDEX) &&
         (pcb->netif_idx != netif_get_index(ip_data.current_input_netif))) {
-      prev = pcb;
       continue;
     }
 
@@ -263,27 +261,15 @@ tcp_input(struct pbuf *p, struct netif *inp)
         pcb->local_port == tcphdr->dest &&
         ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()) &&
         ip_addr_cmp(&pcb->local_ip, ip_current_dest_addr())) {
-      /* Move this PCB to the front of the list so that subsequent
-         lookups will be faster (we exploit locality in TCP segment
-         arrivals). */
-      LWIP_ASSERT("tcp_input: pcb->next != pcb (before cache)", pcb->next != pcb);
-      if (prev != NULL) {
-        prev->next = pcb->next;
-        pcb->next = tcp_active_pcbs;
-        tcp_active_pcbs = pcb;
-      } else {
-        TCP_STATS_INC(tcp.cachehit);
-      }
-      LWIP_ASSERT("tcp_input: pcb->next != pcb (after cache)", pcb->next != pcb);
       break;
     }
-    prev = pcb;
   }
 
   if (pcb == NULL) {
     /* If it did not go to an active connection, we check the connections
        in the TIME-WAIT state. */
-    for (pcb = tcp_tw_pcbs; pcb != NULL; pcb = pcb->next) {
+    for (pcb = tcp_tw_hash[tcp_pcb_hash(ip_current_src_addr(), tcphdr->dest, tcphdr->src)];
+         pcb != NULL; pcb = pcb->hash_next) {
       LWIP_ASSERT("tcp_input: TIME-WAIT pcb->state == TIME-WAIT", pcb->state == TIME_WAIT);
 
       /* check if PCB is bound to specific netif */
@@ -296,9 +282,6 @@ tcp_input(struct pbuf *p, struct netif *inp)
           pcb->local_port == tcphdr->dest &&
           ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()) &&
           ip_addr_cmp(&pcb->local_ip, ip_current_dest_addr())) {
-        /* We don't really care enough to move this PCB to the front
-           of the list since we are not very likely to receive that
-           many segments for connections in TIME-WAIT. */
         LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for TIME_WAITing connection.\n"));
 #ifdef LWIP_HOOK_TCP_INPACKET_PCB
         if (LWIP_HOOK_TCP_INPACKET_PCB(pcb, tcphdr, tcphdr_optlen, tcphdr_opt1len,
@@ -312,14 +295,13 @@ tcp_input(struct pbuf *p, struct netif *inp)
       }
     }
 
-    /* Finally, if we still did not get a match, we check all PCBs that
-       are LISTENing for incoming connections. */
-    prev = NULL;
-    for (lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next) {
+    /* Finally, if we still did not get a match, we check the PCBs that
+       are LISTENing for incoming connections on the destination port. */
+    for (lpcb = (struct tcp_pcb_listen *)tcp_listen_hash[tcp_pcb_hash(NULL, tcphdr->dest, 0)];
+         lpcb != NULL; lpcb = lpcb->hash_next) {
       /* check if PCB is bound to specific netif */
       if ((lpcb->netif_idx != NETIF_NO_INDEX) &&
           (lpcb->netif_idx != netif_get_index(ip_data.current_input_netif))) {
-        prev = (struct tcp_pcb *)lpcb;
         continue;
       }
 
@@ -328,7 +310,6 @@ tcp_input(struct pbuf *p, struct netif *inp)
           /* found an ANY TYPE (IPv4/IPv6) match */
 #if SO_REUSE
           lpcb_any = lpcb;
-          lpcb_prev = prev;
 #else /* SO_REUSE */
           break;
 #endif /* SO_REUSE */
@@ -340,37 +321,21 @@ tcp_input(struct pbuf *p, struct netif *inp)
             /* found an ANY-match */
 #if SO_REUSE
             lpcb_any = lpcb;
-            lpcb_prev = prev;
 #else /* SO_REUSE */
             break;
 #endif /* SO_REUSE */
           }
         }
       }
-      prev = (struct tcp_pcb *)lpcb;
     }
 #if SO_REUSE
     /* first try specific local IP */
     if (lpcb == NULL) {
       /* only pass to ANY if no specific local IP has been found */
       lpcb = lpcb_any;
-      prev = lpcb_prev;
     }
 #endif /* SO_REUSE */
     if (lpcb != NULL) {
-      /* Move this PCB to the front of the list so that subsequent
-         lookups will be faster (we exploit locality in TCP segment
-         arrivals). */
-      if (prev != NULL) {
-        ((struct tcp_pcb_listen *)prev)->next = lpcb->next;
-        /* our successor is the remainder of the listening list */
-        lpcb->next = tcp_listen_pcbs.listen_pcbs;
-        /* put this listening pcb at the head of the listening list */
-        tcp_listen_pcbs.listen_pcbs = lpcb;
-      } else {
-        TCP_STATS_INC(tcp.cachehit);
-      }
-
       LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for LISTENing connection.\n"));
 #ifdef LWIP_HOOK_TCP_INPACKET_PCB
       if (LWIP_HOOK_TCP_INPACKET_PCB((struct tcp_pcb *)lpcb, tcphdr, tcphdr_optlen,
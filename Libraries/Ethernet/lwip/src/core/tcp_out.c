@@ -140,6 +140,58 @@ tcp_route(const struct tcp_pcb *pcb, const ip_addr_t *src, const ip_addr_t *dst)
   }
 }
 
+#if TCP_TSO_MAX_SIZE
+/* tcp_tso_seg_size: size of the segments tcp_write builds for pcb. A netif with
+ * NETIF_FLAG_TSO gets segments of several MSS, it cuts them into frames of its
+ * mtu. This only works out if the MSS fills such a frame. */
+static u16_t
+tcp_tso_seg_size(const struct tcp_pcb *pcb, u16_t mss_local, u8_t optlen)
+{
+  struct netif *netif;
+  u16_t max_size;
+  u16_t segs;
+
+  if ((mss_local != pcb->mss) || !IP_IS_V4(&pcb->remote_ip)) {
+    return mss_local;
+  }
+
+  netif = tcp_route(pcb, &pcb->local_ip, &pcb->remote_ip);
+  if ((netif == NULL) || ((netif->flags & NETIF_FLAG_TSO) == 0) ||
+      ((u32_t)pcb->mss + IP_HLEN + TCP_HLEN != netif->mtu)) {
+    return mss_local;
+  }
+
+  /* don't allocate segments bigger than half the maximum window we ever received */
+  max_size = LWIP_MIN(TCP_TSO_MAX_SIZE, TCPWND_MIN16(pcb->snd_wnd_max / 2));
+  segs = (u16_t)(max_size / (pcb->mss - optlen));
+  if (segs < 2) {
+    return mss_local;
+  }
+  return (u16_t)(segs * (pcb->mss - optlen) + optlen);
+}
+
+/* room at the end of the last unsent segment which tcp_write fills first */
+#if TCP_OVERSIZE
+#define TCP_TSO_UNSENT_OVERSIZE(pcb) ((pcb)->unsent_oversize)
+#else /* TCP_OVERSIZE */
+#define TCP_TSO_UNSENT_OVERSIZE(pcb) 0
+#endif /* TCP_OVERSIZE */
+
+/* tcp_tso_fit_window: cuts a segment of several MSS at the head of pcb->unsent
+ * back to the MSS sized frames which fit into wnd, the rest stays unsent */
+static void
+tcp_tso_fit_window(struct tcp_pcb *pcb, u32_t wnd)
+{
+  struct tcp_seg *seg = pcb->unsent;
+  u32_t inflight = lwip_ntohl(seg->tcphdr->seqno) - pcb->lastack;
+  u16_t frame_len = (u16_t)(pcb->mss - LWIP_TCP_OPT_LENGTH_SEGMENT(seg->flags, pcb));
+
+  if ((seg->len > frame_len) && (inflight + seg->len > wnd) && (inflight + frame_len <= wnd)) {
+    tcp_split_unsent_seg(pcb, (u16_t)(((wnd - inflight) / frame_len) * frame_len));
+  }
+}
+#endif /* TCP_TSO_MAX_SIZE */
+
 /**
  * Create a TCP segment with prefilled header.
  *
@@ -449,6 +501,10 @@ tcp_write(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags)
     optlen = LWIP_TCP_OPT_LENGTH_SEGMENT(0, pcb);
   }
 
+#if TCP_TSO_MAX_SIZE
+  mss_local = tcp_tso_seg_size(pcb, mss_local, optlen);
+#endif /* TCP_TSO_MAX_SIZE */
+
 
   /*
    * TCP segmentation is done in three phases with increasing complexity:
@@ -483,8 +539,23 @@ tcp_write(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags)
 
     /* Usable space at the end of the last unsent segment */
     unsent_optlen = LWIP_TCP_OPT_LENGTH_SEGMENT(last_unsent->flags, pcb);
-    LWIP_ASSERT("mss_local is too small", mss_local >= last_unsent->len + unsent_optlen);
-    space = mss_local - (last_unsent->len + unsent_optlen);
+#if TCP_TSO_MAX_SIZE
+    if ((u32_t)last_unsent->len + unsent_optlen + TCP_TSO_UNSENT_OVERSIZE(pcb) > mss_local) {
+      /* last_unsent was built for a TSO netif which the route of pcb has left: it
+         keeps its size but takes no more data, new segments get the smaller size */
+#if TCP_OVERSIZE
+      pcb->unsent_oversize = 0;
+#if TCP_OVERSIZE_DBGCHECK
+      last_unsent->oversize_left = 0;
+#endif /* TCP_OVERSIZE_DBGCHECK */
+#endif /* TCP_OVERSIZE */
+      space = 0;
+    } else
+#endif /* TCP_TSO_MAX_SIZE */
+    {
+      LWIP_ASSERT("mss_local is too small", mss_local >= last_unsent->len + unsent_optlen);
+      space = mss_local - (last_unsent->len + unsent_optlen);
+    }
 
     /*
      * Phase 1: Copy data directly into an oversized pbuf.
@@ -856,7 +927,11 @@ tcp_split_unsent_seg(struct tcp_pcb *pcb, u16_t split)
     return ERR_OK;
   }
 
+#if TCP_TSO_MAX_SIZE
+  LWIP_ASSERT("split <= TCP_TSO_MAX_SIZE", split <= LWIP_MAX(TCP_TSO_MAX_SIZE, pcb->mss));
+#else /* TCP_TSO_MAX_SIZE */
   LWIP_ASSERT("split <= mss", split <= pcb->mss);
+#endif /* TCP_TSO_MAX_SIZE */
   LWIP_ASSERT("useg->len > 0", useg->len > 0);
 
   /* We should check that we don't exceed TCP_SND_QUEUELEN but we need
@@ -1301,6 +1376,10 @@ tcp_output(struct tcp_pcb *pcb)
     ip_addr_copy(pcb->local_ip, *local_ip);
   }
 
+#if TCP_TSO_MAX_SIZE
+  tcp_tso_fit_window(pcb, wnd);
+#endif /* TCP_TSO_MAX_SIZE */
+
   /* Handle the current segment not fitting within the window */
   if (lwip_ntohl(seg->tcphdr->seqno) - pcb->lastack + seg->len > wnd) {
     /* We need to start the persistent timer when the next unsent segment does not fit
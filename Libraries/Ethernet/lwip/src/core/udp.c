@@ -80,6 +80,93 @@ static u16_t udp_port = UDP_LOCAL_PORT_RANGE_START;
 /* exported in udp.h (was static) */
 struct udp_pcb *udp_pcbs;
 
+#if (UDP_PCB_HASH_SIZE & (UDP_PCB_HASH_SIZE - 1)) != 0
+#error "UDP_PCB_HASH_SIZE must be a power of 2"
+#endif
+
+/* The active UDP PCBs hashed by their local port (chained by port_next) */
+static struct udp_pcb *udp_port_pcbs[UDP_PCB_HASH_SIZE];
+/* The active UDP PCBs hashed for udp_input() (chained by demux_next):
+   connected PCBs by local and remote port, the others by local port only */
+static struct udp_pcb *udp_demux_pcbs[UDP_PCB_HASH_SIZE];
+
+/**
+ * Hash of a local and a remote port (0 for the local port only).
+ *
+ * @return index into udp_port_pcbs / udp_demux_pcbs
+ */
+static u16_t
+udp_hash(u16_t local_port, u16_t remote_port)
+{
+  u16_t h = (u16_t)(local_port ^ (u16_t)(remote_port * 0x9e37U));
+  return (u16_t)((h ^ (h >> 8)) & (UDP_PCB_HASH_SIZE - 1));
+}
+
+/** Demultiplexing bucket of a pcb */
+#define UDP_DEMUX_HASH(pcb) udp_hash((pcb)->local_port, \
+                                     (((pcb)->flags & UDP_FLAGS_CONNECTED) != 0) ? (pcb)->remote_port : 0)
+
+/**
+ * Adds an active pcb to the hash tables, by its current ports.
+ *
+ * @param pcb the pcb to add
+ */
+static void
+udp_hash_insert(struct udp_pcb *pcb)
+{
+  u16_t h = udp_hash(pcb->local_port, 0);
+
+  pcb->port_next = udp_port_pcbs[h];
+  udp_port_pcbs[h] = pcb;
+
+  h = UDP_DEMUX_HASH(pcb);
+  pcb->demux_next = udp_demux_pcbs[h];
+  udp_demux_pcbs[h] = pcb;
+}
+
+/**
+ * Removes a pcb from the hash tables, before its ports change.
+ *
+ * @param pcb the pcb to remove
+ */
+static void
+udp_hash_remove(struct udp_pcb *pcb)
+{
+  struct udp_pcb **ppcb;
+
+  for (ppcb = &udp_port_pcbs[udp_hash(pcb->local_port, 0)]; *ppcb != NULL; ppcb = &(*ppcb)->port_next) {
+    if (*ppcb == pcb) {
+      *ppcb = pcb->port_next;
+      break;
+    }
+  }
+  for (ppcb = &udp_demux_pcbs[UDP_DEMUX_HASH(pcb)]; *ppcb != NULL; ppcb = &(*ppcb)->demux_next) {
+    if (*ppcb == pcb) {
+      *ppcb = pcb->demux_next;
+      break;
+    }
+  }
+}
+
+/**
+ * Checks whether a pcb is on the list of active PCBs.
+ *
+ * @param pcb the pcb to look for
+ * @return 1 if the pcb is active, 0 otherwise
+ */
+static u8_t
+udp_is_active(struct udp_pcb *pcb)
+{
+  struct udp_pcb *ipcb;
+
+  for (ipcb = udp_port_pcbs[udp_hash(pcb->local_port, 0)]; ipcb != NULL; ipcb = ipcb->port_next) {
+    if (ipcb == pcb) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
 /**
  * Initialize this module.
  */
@@ -106,8 +193,8 @@ again:
   if (udp_port++ == UDP_LOCAL_PORT_RANGE_END) {
     udp_port = UDP_LOCAL_PORT_RANGE_START;
   }
-  /* Check all PCBs. */
-  for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+  /* Check the PCBs hashed with this port. */
+  for (pcb = udp_port_pcbs[udp_hash(udp_port, 0)]; pcb != NULL; pcb = pcb->port_next) {
     if (pcb->local_port == udp_port) {
       if (++n > (UDP_LOCAL_PORT_RANGE_END - UDP_LOCAL_PORT_RANGE_START)) {
         return 0;
@@ -194,7 +281,7 @@ void
 udp_input(struct pbuf *p, struct netif *inp)
 {
   struct udp_hdr *udphdr;
-  struct udp_pcb *pcb, *prev;
+  struct udp_pcb *pcb;
   struct udp_pcb *uncon_pcb;
   u16_t src, dest;
   u8_t broadcast;
@@ -243,25 +330,35 @@ udp_input(struct pbuf *p, struct netif *inp)
   ip_addr_debug_print_val(UDP_DEBUG, *ip_current_src_addr());
   LWIP_DEBUGF(UDP_DEBUG, (", %"U16_F")\n", lwip_ntohs(udphdr->src)));
 
-  pcb = NULL;
-  prev = NULL;
   uncon_pcb = NULL;
-  /* Iterate through the UDP pcb list for a matching pcb.
-   * 'Perfect match' pcbs (connected to the remote port & ip address) are
-   * preferred. If no perfect match is found, the first unconnected pcb that
-   * matches the local port and ip address gets the datagram. */
-  for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
-    /* print the PCB local and remote address */
-    LWIP_DEBUGF(UDP_DEBUG, ("pcb ("));
-    ip_addr_debug_print_val(UDP_DEBUG, pcb->local_ip);
-    LWIP_DEBUGF(UDP_DEBUG, (", %"U16_F") <-- (", pcb->local_port));
-    ip_addr_debug_print_val(UDP_DEBUG, pcb->remote_ip);
-    LWIP_DEBUGF(UDP_DEBUG, (", %"U16_F")\n", pcb->remote_port));
-
-    /* compare PCB local addr+port to UDP destination addr+port */
-    if ((pcb->local_port == dest) &&
+  /* 'Perfect match' pcbs (connected to the remote port & ip address) are
+   * preferred, they are hashed by local and remote port. */
+  for (pcb = udp_demux_pcbs[udp_hash(dest, src)]; pcb != NULL; pcb = pcb->demux_next) {
+    if (((pcb->flags & UDP_FLAGS_CONNECTED) != 0) &&
+        (pcb->local_port == dest) && (pcb->remote_port == src) &&
+        (ip_addr_isany_val(pcb->remote_ip) ||
+         ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr())) &&
         (udp_input_local_match(pcb, inp, broadcast) != 0)) {
-      if ((pcb->flags & UDP_FLAGS_CONNECTED) == 0) {
+      UDP_STATS_INC(udp.cachehit);
+      break;
+    }
+  }
+  /* If no perfect match is found, the first unconnected pcb that matches
+   * the local port and ip address gets the datagram. They are hashed by
+   * the local port only. */
+  if (pcb == NULL) {
+    for (pcb = udp_demux_pcbs[udp_hash(dest, 0)]; pcb != NULL; pcb = pcb->demux_next) {
+      /* print the PCB local and remote address */
+      LWIP_DEBUGF(UDP_DEBUG, ("pcb ("));
+      ip_addr_debug_print_val(UDP_DEBUG, pcb->local_ip);
+      LWIP_DEBUGF(UDP_DEBUG, (", %"U16_F") <-- (", pcb->local_port));
+      ip_addr_debug_print_val(UDP_DEBUG, pcb->remote_ip);
+      LWIP_DEBUGF(UDP_DEBUG, (", %"U16_F")\n", pcb->remote_port));
+
+      /* compare PCB local addr+port to UDP destination addr+port */
+      if (((pcb->flags & UDP_FLAGS_CONNECTED) == 0) &&
+          (pcb->local_port == dest) &&
+          (udp_input_local_match(pcb, inp, broadcast) != 0)) {
         if (uncon_pcb == NULL) {
           /* the first unconnected matching PCB */
           uncon_pcb = pcb;
@@ -283,31 +380,20 @@ udp_input(struct pbuf *p, struct netif *inp)
           uncon_pcb = pcb;
         }
 #endif /* SO_REUSE */
-      }
 
-      /* compare PCB remote addr+port to UDP source addr+port */
-      if ((pcb->remote_port == src) &&
-          (ip_addr_isany_val(pcb->remote_ip) ||
-           ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()))) {
-        /* the first fully matching PCB */
-        if (prev != NULL) {
-          /* move the pcb to the front of udp_pcbs so that is
-             found faster next time */
-          prev->next = pcb->next;
-          pcb->next = udp_pcbs;
-          udp_pcbs = pcb;
-        } else {
-          UDP_STATS_INC(udp.cachehit);
+        /* compare PCB remote addr+port to UDP source addr+port */
+        if ((pcb->remote_port == src) &&
+            (ip_addr_isany_val(pcb->remote_ip) ||
+             ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()))) {
+          /* the first fully matching PCB */
+          break;
         }
-        break;
       }
     }
-
-    prev = pcb;
-  }
-  /* no fully matching pcb found? then look for an unconnected pcb */
-  if (pcb == NULL) {
-    pcb = uncon_pcb;
+    /* no fully matching pcb found? then take the unconnected pcb */
+    if (pcb == NULL) {
+      pcb = uncon_pcb;
+    }
   }
 
   /* Check checksum if this is a match or if it was directed at us. */
@@ -329,7 +415,7 @@ udp_input(struct pbuf *p, struct netif *inp)
   if (for_us) {
     LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE, ("udp_input: calculating checksum\n"));
 #if CHECKSUM_CHECK_UDP
-    IF__NETIF_CHECKSUM_ENABLED(inp, NETIF_CHECKSUM_CHECK_UDP) {
+    IF__NETIF_CHECKSUM_CHECK_ENABLED(inp, p, NETIF_CHECKSUM_CHECK_UDP) {
 #if LWIP_UDPLITE
       if (ip_current_header_proto() == IP_PROTO_UDPLITE) {
         /* Do the UDP Lite checksum */
@@ -380,18 +466,27 @@ udp_input(struct pbuf *p, struct netif *inp)
         /* pass broadcast- or multicast packets to all multicast pcbs
            if SOF_REUSEADDR is set on the first match */
         struct udp_pcb *mpcb;
-        for (mpcb = udp_pcbs; mpcb != NULL; mpcb = mpcb->next) {
+        for (mpcb = udp_port_pcbs[udp_hash(dest, 0)]; mpcb != NULL; mpcb = mpcb->port_next) {
           if (mpcb != pcb) {
             /* compare PCB local addr+port to UDP destination addr+port */
             if ((mpcb->local_port == dest) &&
                 (udp_input_local_match(mpcb, inp, broadcast) != 0)) {
               /* pass a copy of the packet to all local matches */
               if (mpcb->recv != NULL) {
+#if SO_REUSE_RXTOALL_SHARED
+                /* or the packet itself, read-only, every match frees its reference */
+                void *payload = p->payload;
+                pbuf_ref(p);
+                mpcb->recv(mpcb->recv_arg, mpcb, p, ip_current_src_addr(), src);
+                LWIP_ASSERT("udp_input: shared pbuf modified by recv callback", p->payload == payload);
+                LWIP_UNUSED_ARG(payload); /* in case of LWIP_NOASSERT */
+#else /* SO_REUSE_RXTOALL_SHARED */
                 struct pbuf *q;
                 q = pbuf_clone(PBUF_RAW, PBUF_POOL, p);
                 if (q != NULL) {
                   mpcb->recv(mpcb->recv_arg, mpcb, q, ip_current_src_addr(), src);
                 }
+#endif /* SO_REUSE_RXTOALL_SHARED */
               }
             }
           }
@@ -756,8 +851,9 @@ udp_sendto_if_src_chksum(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *d
   if ((u16_t)(p->tot_len + UDP_HLEN) < p->tot_len) {
     return ERR_MEM;
   }
-  /* not enough space to add an UDP header to first pbuf in given p chain? */
-  if (pbuf_add_header(p, UDP_HLEN)) {
+  /* not enough space to add an UDP header to first pbuf in given p chain,
+     or p is shared (e.g. a received datagram passed to several pcbs)? */
+  if ((p->ref > 1) || pbuf_add_header(p, UDP_HLEN)) {
     /* allocate header in a separate new pbuf */
     q = pbuf_alloc(PBUF_IP, UDP_HLEN, PBUF_RAM);
     /* new header pbuf could not be allocated? */
@@ -888,6 +984,11 @@ udp_sendto_if_src_chksum(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *d
 
   LWIP_DEBUGF(UDP_DEBUG, ("udp_send: UDP checksum 0x%04"X16_F"\n", udphdr->chksum));
   LWIP_DEBUGF(UDP_DEBUG, ("udp_send: ip_output_if (,,,,0x%02"X16_F",)\n", (u16_t)ip_proto));
+#if LWIP_UDP_PRIORITY
+  /* the header pbuf goes first to the netif */
+  q->priority = pcb->priority;
+#endif /* LWIP_UDP_PRIORITY */
+
   /* output to IP */
   NETIF_SET_HINTS(netif, &(pcb->netif_hints));
   err = ip_output_if_src(q, src_ip, dst_ip, ttl, pcb->tos, ip_proto, netif);
@@ -954,15 +1055,8 @@ udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
   ip_addr_debug_print(UDP_DEBUG | LWIP_DBG_TRACE, ipaddr);
   LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE, (", port = %"U16_F")\n", port));
 
-  rebind = 0;
   /* Check for double bind and rebind of the same pcb */
-  for (ipcb = udp_pcbs; ipcb != NULL; ipcb = ipcb->next) {
-    /* is this UDP PCB already on active list? */
-    if (pcb == ipcb) {
-      rebind = 1;
-      break;
-    }
-  }
+  rebind = udp_is_active(pcb);
 
 #if LWIP_IPV6 && LWIP_IPV6_SCOPES
   /* If the given IP address should have a zone but doesn't, assign one now.
@@ -985,7 +1079,7 @@ udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
       return ERR_USE;
     }
   } else {
-    for (ipcb = udp_pcbs; ipcb != NULL; ipcb = ipcb->next) {
+    for (ipcb = udp_port_pcbs[udp_hash(port, 0)]; ipcb != NULL; ipcb = ipcb->port_next) {
       if (pcb != ipcb) {
         /* By default, we don't allow to bind to a port that any other udp
            PCB is already bound to, unless *all* PCBs with that port have tha
@@ -1010,6 +1104,11 @@ udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
     }
   }
 
+  if (rebind != 0) {
+    /* the PCB moves to the buckets of the new port */
+    udp_hash_remove(pcb);
+  }
+
   ip_addr_set_ipaddr(&pcb->local_ip, ipaddr);
 
   pcb->local_port = port;
@@ -1020,6 +1119,7 @@ udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
     pcb->next = udp_pcbs;
     udp_pcbs = pcb;
   }
+  udp_hash_insert(pcb);
   LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("udp_bind: bound to "));
   ip_addr_debug_print_val(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, pcb->local_ip);
   LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, (", port %"U16_F")\n", pcb->local_port));
@@ -1070,7 +1170,7 @@ udp_bind_netif(struct udp_pcb *pcb, const struct netif *netif)
 err_t
 udp_connect(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 {
-  struct udp_pcb *ipcb;
+  u8_t active;
 
   LWIP_ASSERT_CORE_LOCKED();
 
@@ -1084,6 +1184,12 @@ udp_connect(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
     }
   }
 
+  active = udp_is_active(pcb);
+  if (active != 0) {
+    /* the PCB moves to the demultiplexing bucket of the new remote port */
+    udp_hash_remove(pcb);
+  }
+
   ip_addr_set_ipaddr(&pcb->remote_ip, ipaddr);
 #if LWIP_IPV6 && LWIP_IPV6_SCOPES
   /* If the given IP address should have a zone but doesn't, assign one now,
@@ -1102,16 +1208,13 @@ udp_connect(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
                           pcb->remote_ip);
   LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, (", port %"U16_F")\n", pcb->remote_port));
 
+  udp_hash_insert(pcb);
   /* Insert UDP PCB into the list of active UDP PCBs. */
-  for (ipcb = udp_pcbs; ipcb != NULL; ipcb = ipcb->next) {
-    if (pcb == ipcb) {
-      /* already on the list, just return */
-      return ERR_OK;
-    }
+  if (active == 0) {
+    /* PCB not yet on the list, add PCB now */
+    pcb->next = udp_pcbs;
+    udp_pcbs = pcb;
   }
-  /* PCB not yet on the list, add PCB now */
-  pcb->next = udp_pcbs;
-  udp_pcbs = pcb;
   return ERR_OK;
 }
 
@@ -1125,10 +1228,18 @@ udp_connect(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 void
 udp_disconnect(struct udp_pcb *pcb)
 {
+  u8_t active;
+
   LWIP_ASSERT_CORE_LOCKED();
 
   LWIP_ERROR("udp_disconnect: invalid pcb", pcb != NULL, return);
 
+  active = udp_is_active(pcb);
+  if (active != 0) {
+    /* the PCB moves to the demultiplexing bucket of its local port */
+    udp_hash_remove(pcb);
+  }
+
   /* reset remote address association */
 #if LWIP_IPV4 && LWIP_IPV6
   if (IP_IS_ANY_TYPE_VAL(pcb->local_ip)) {
@@ -1143,6 +1254,9 @@ udp_disconnect(struct udp_pcb *pcb)
   pcb->netif_idx = NETIF_NO_INDEX;
   /* mark PCB as unconnected */
   udp_clear_flags(pcb, UDP_FLAGS_CONNECTED);
+  if (active != 0) {
+    udp_hash_insert(pcb);
+  }
 }
 
 /**
@@ -1185,6 +1299,7 @@ udp_remove(struct udp_pcb *pcb)
   LWIP_ERROR("udp_remove: invalid pcb", pcb != NULL, return);
 
   mib2_udp_unbind(pcb);
+  udp_hash_remove(pcb);
   /* pcb to be removed is first in list? */
   if (udp_pcbs == pcb) {
     /* make list start at 2nd pcb */
@@ -70,18 +70,38 @@ extern "C" {
  * There will be a group for the all systems group address but this
  * will not run the state machine as it is used to kick off reports
  * from all the other groups
+ *
+ * The groups of all netifs are also indexed by group address, and the
+ * groups with a running report timer are linked into the timer wheel slot
+ * they expire in, so neither a lookup nor igmp_tmr() walks all groups.
  */
 struct igmp_group {
   /** next link */
   struct igmp_group *next;
+  /** next group in the same hash bucket */
+  struct igmp_group *hash_next;
+  /** next group expiring in the same timer slot */
+  struct igmp_group *timer_next;
+  /** link pointing to this group in its timer slot, NULL if the timer is OFF */
+  struct igmp_group **timer_pprev;
+  /** next group to schedule a report for (allsystems group only, NULL: no query pending) */
+  struct igmp_group *query_next;
+  /** netif the group belongs to */
+  struct netif      *netif;
   /** multicast address */
   ip4_addr_t         group_address;
+  /** number of groups after it in the list (allsystems group only) */
+  u16_t              num_groups;
+  /** groups left for the pending query, at most (allsystems group only) */
+  u16_t              query_left;
   /** signifies we were the last person to report */
   u8_t               last_reporter_flag;
   /** current state of the group */
   u8_t               group_state;
-  /** timer for reporting, negative is OFF */
-  u16_t              timer;
+  /** timer slot the report is due in */
+  u8_t               timer;
+  /** max response time left for the pending query (allsystems group only) */
+  u8_t               query_maxresp;
   /** counter of simultaneous uses */
   u8_t               use;
 };
@@ -105,6 +105,10 @@ extern "C" {
 /** If set, the netif has MLD6 capability.
  * Set by the netif driver in its init function. */
 #define NETIF_FLAG_MLD6         0x40U
+/** If set, the netif cuts TCP segments longer than its mtu into frames
+ * (TCP segmentation offload, see TCP_TSO_MAX_SIZE).
+ * Set by the netif driver in its init function. */
+#define NETIF_FLAG_TSO          0x80U
 
 /**
  * @}
@@ -393,9 +397,13 @@ struct netif {
 #define NETIF_SET_CHECKSUM_CTRL(netif, chksumflags) do { \
   (netif)->chksum_flags = chksumflags; } while(0)
 #define IF__NETIF_CHECKSUM_ENABLED(netif, chksumflag) if (((netif) == NULL) || (((netif)->chksum_flags & (chksumflag)) != 0))
+/* check of a received pbuf p: also skipped when the netif has verified it for p (LWIP_PBUF_CHECKSUM_CHECKED) */
+#define IF__NETIF_CHECKSUM_CHECK_ENABLED(netif, p, chksumflag) \
+  if ((((netif) == NULL) || (((netif)->chksum_flags & (chksumflag)) != 0)) && !LWIP_PBUF_CHECKSUM_CHECKED(p, chksumflag))
 #else /* LWIP_CHECKSUM_CTRL_PER_NETIF */
 #define NETIF_SET_CHECKSUM_CTRL(netif, chksumflags)
 #define IF__NETIF_CHECKSUM_ENABLED(netif, chksumflag)
+#define IF__NETIF_CHECKSUM_CHECK_ENABLED(netif, p, chksumflag) if (!LWIP_PBUF_CHECKSUM_CHECKED(p, chksumflag))
 #endif /* LWIP_CHECKSUM_CTRL_PER_NETIF */
 
 #if LWIP_SINGLE_NETIF
@@ -636,6 +636,15 @@
 #define ARP_TABLE_SIZE                  10
 #endif
 
+/**
+ * ARP_TABLE_HASH_SIZE: Number of buckets (a power of 2) of the hash table
+ * which indexes the ARP table by IP address. About ARP_TABLE_SIZE / 4 keeps
+ * the chains short.
+ */
+#if !defined ARP_TABLE_HASH_SIZE || defined __DOXYGEN__
+#define ARP_TABLE_HASH_SIZE             4
+#endif
+
 /** the time an ARP entry stays valid after its last update,
  *  for ARP_TMR_INTERVAL = 1000, this is
  *  (60 * 5) seconds = 5 minutes.
@@ -1073,6 +1082,25 @@
 #undef LWIP_IGMP
 #define LWIP_IGMP                       0
 #endif
+
+/**
+ * IGMP_GROUP_HASH_SIZE: Number of buckets (a power of 2) of the hash table
+ * which indexes the IGMP groups of all netifs by group address. About
+ * MEMP_NUM_IGMP_GROUP / 4 keeps the chains short.
+ */
+#if !defined IGMP_GROUP_HASH_SIZE || defined __DOXYGEN__
+#define IGMP_GROUP_HASH_SIZE            4
+#endif
+
+/**
+ * IGMP_QUERY_GROUPS_PER_TMR: Least number of groups of a netif igmp_tmr()
+ * schedules a report for per call while answering a general query. More are
+ * taken if the groups left wouldn't be done within the max response time.
+ * The query itself is only recorded in the receive path.
+ */
+#if !defined IGMP_QUERY_GROUPS_PER_TMR || defined __DOXYGEN__
+#define IGMP_QUERY_GROUPS_PER_TMR       16
+#endif
 /**
  * @}
  */
@@ -1200,6 +1228,27 @@
 #if !defined LWIP_NETBUF_RECVINFO || defined __DOXYGEN__
 #define LWIP_NETBUF_RECVINFO            0
 #endif
+
+/**
+ * LWIP_UDP_PRIORITY==1: every udp_pcb gets a priority (0..7, like the socket
+ * option SO_PRIORITY, see udp_set_priority()) which is passed to the netif in
+ * the first pbuf of each datagram sent. The netif may use it to select a
+ * transmit queue. Requires a member 'u8_t priority' in LWIP_PBUF_CUSTOM_DATA.
+ */
+#if !defined LWIP_UDP_PRIORITY || defined __DOXYGEN__
+#define LWIP_UDP_PRIORITY               0
+#endif
+
+/**
+ * UDP_PCB_HASH_SIZE: Number of buckets (a power of 2) of the hash tables
+ * which index the active udp_pcbs by their ports: one by the local port
+ * (bind, port allocation), one by local and remote port of connected pcbs
+ * and by the local port of the others (demultiplexing in udp_input()).
+ * A few buckets less than MEMP_NUM_UDP_PCB keep the chains short.
+ */
+#if !defined UDP_PCB_HASH_SIZE || defined __DOXYGEN__
+#define UDP_PCB_HASH_SIZE               16
+#endif
 /**
  * @}
  */
@@ -1431,6 +1480,16 @@
 #define LWIP_TCP_TIMESTAMPS             0
 #endif
 
+/**
+ * TCP_TSO_MAX_SIZE: maximum size of the segments tcp_write() builds for a
+ * netif which segments TCP by itself (NETIF_FLAG_TSO). Such a segment is a
+ * multiple of the MSS and is cut into frames of netif->mtu by the netif, which
+ * also has to insert the checksums of every frame. 0 disables this.
+ */
+#if !defined TCP_TSO_MAX_SIZE || defined __DOXYGEN__
+#define TCP_TSO_MAX_SIZE                0
+#endif
+
 /**
  * TCP_WND_UPDATE_THRESHOLD: difference in window to trigger an
  * explicit window update
@@ -1480,6 +1539,16 @@
 #define LWIP_TCP_PCB_NUM_EXT_ARGS       0
 #endif
 
+/**
+ * TCP_PCB_HASH_SIZE: Number of buckets (a power of 2) of the hash tables
+ * tcp_input() looks up the pcbs in: the active and the TIME-WAIT pcbs are
+ * hashed by remote address, remote port and local port, the listening pcbs
+ * by local port. A few buckets less than MEMP_NUM_TCP_PCB keep the chains short.
+ */
+#if !defined TCP_PCB_HASH_SIZE || defined __DOXYGEN__
+#define TCP_PCB_HASH_SIZE               16
+#endif
+
 /** LWIP_ALTCP==1: enable the altcp API.
  * altcp is an abstraction layer that prevents applications linking against the
  * tcp.h functions but provides the same functionality. It is used to e.g. add
@@ -1565,6 +1634,35 @@
 #define LWIP_PBUF_CUSTOM_DATA
 #endif
 
+/**
+ * LWIP_PBUF_CUSTOM_DATA_INIT: Initialize private data on pbufs.
+ * e.g. for a timestamp stored by LWIP_PBUF_CUSTOM_DATA, you might define
+ * \#define LWIP_PBUF_CUSTOM_DATA_INIT(p) (p)->ts = 0
+ */
+#if !defined LWIP_PBUF_CUSTOM_DATA_INIT || defined __DOXYGEN__
+#define LWIP_PBUF_CUSTOM_DATA_INIT(p)
+#endif
+
+/**
+ * LWIP_PBUF_CUSTOM_DATA_COPY: Copy private data from one pbuf to another,
+ * used by pbuf_clone() so a copy keeps e.g. the timestamp of the original.
+ * \#define LWIP_PBUF_CUSTOM_DATA_COPY(dst, src) (dst)->ts = (src)->ts
+ */
+#if !defined LWIP_PBUF_CUSTOM_DATA_COPY || defined __DOXYGEN__
+#define LWIP_PBUF_CUSTOM_DATA_COPY(dst, src)
+#endif
+
+/**
+ * LWIP_PBUF_CHECKSUM_CHECKED: Non-zero if the netif has already verified the
+ * checksum chksumflag (one of NETIF_CHECKSUM_CHECK_*) of the received pbuf p,
+ * the stack then skips that check for this pbuf only. The status is kept in
+ * LWIP_PBUF_CUSTOM_DATA, e.g.
+ * \#define LWIP_PBUF_CHECKSUM_CHECKED(p, chksumflag) (((p)->chksum_checked & (chksumflag)) != 0)
+ */
+#if !defined LWIP_PBUF_CHECKSUM_CHECKED || defined __DOXYGEN__
+#define LWIP_PBUF_CHECKSUM_CHECKED(p, chksumflag) 0
+#endif
+
 /**
  * @}
  */
@@ -2059,6 +2157,16 @@
 #define SO_REUSE_RXTOALL                0
 #endif
 
+/**
+ * SO_REUSE_RXTOALL_SHARED==1: With SO_REUSE_RXTOALL, pass the same pbuf to all
+ * local matches instead of a copy, with one reference per pcb. The recv
+ * callbacks must treat it as read-only (including p->payload) and call
+ * pbuf_unshare() to get a pbuf they may modify.
+ */
+#if !defined SO_REUSE_RXTOALL_SHARED || defined __DOXYGEN__
+#define SO_REUSE_RXTOALL_SHARED         0
+#endif
+
 /**
  * LWIP_FIONREAD_LINUXMODE==0 (default): ioctl/FIONREAD returns the amount of
  * pending data in the network buffer. This is the way windows does it. It's
@@ -339,6 +339,17 @@ extern struct tcp_pcb *tcp_active_pcbs;  /* List of all TCP PCBs that are in a
               data. */
 extern struct tcp_pcb *tcp_tw_pcbs;      /* List of all TCP PCBs in TIME-WAIT. */
 
+/* The PCBs of tcp_active_pcbs, tcp_tw_pcbs and tcp_listen_pcbs, hashed by
+   tcp_pcb_hash() (chained by hash_next). TCP_REG and TCP_RMV keep them in
+   sync with the lists. */
+extern struct tcp_pcb *tcp_active_hash[TCP_PCB_HASH_SIZE];
+extern struct tcp_pcb *tcp_tw_hash[TCP_PCB_HASH_SIZE];
+extern struct tcp_pcb *tcp_listen_hash[TCP_PCB_HASH_SIZE];
+
+u16_t tcp_pcb_hash(const ip_addr_t *remote_ip, u16_t local_port, u16_t remote_port);
+void  tcp_pcb_hash_reg(struct tcp_pcb **pcbs, struct tcp_pcb *npcb);
+void  tcp_pcb_hash_rmv(struct tcp_pcb **pcbs, struct tcp_pcb *npcb);
+
 #define NUM_TCP_PCB_LISTS_NO_TIME_WAIT  3
 #define NUM_TCP_PCB_LISTS               4
 extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
@@ -367,6 +378,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
                             (npcb)->next = *(pcbs); \
                             LWIP_ASSERT("TCP_REG: npcb->next != npcb", (npcb)->next != (npcb)); \
                             *(pcbs) = (npcb); \
+                            tcp_pcb_hash_reg(pcbs, npcb); \
                             LWIP_ASSERT("TCP_REG: tcp_pcbs sane", tcp_pcbs_sane()); \
               tcp_timer_needed(); \
                             } while(0)
@@ -383,6 +395,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
                                } \
                             } \
                             (npcb)->next = NULL; \
+                            tcp_pcb_hash_rmv(pcbs, npcb); \
                             LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
                             LWIP_DEBUGF(TCP_DEBUG, ("TCP_RMV: removed %p from %p\n", (void *)(npcb), (void *)(*(pcbs)))); \
                             } while(0)
@@ -393,6 +406,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
   do {                                             \
     (npcb)->next = *pcbs;                          \
     *(pcbs) = (npcb);                              \
+    tcp_pcb_hash_reg(pcbs, npcb);                  \
     tcp_timer_needed();                            \
   } while (0)
 
@@ -413,6 +427,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
       }                                            \
     }                                              \
     (npcb)->next = NULL;                           \
+    tcp_pcb_hash_rmv(pcbs, npcb);                  \
   } while(0)
 
 #endif /* LWIP_DEBUG */
@@ -85,6 +85,10 @@ struct udp_pcb {
 /* Protocol specific PCB members */
 
   struct udp_pcb *next;
+  /** next pcb in the bucket of the local port (UDP_PCB_HASH_SIZE) */
+  struct udp_pcb *port_next;
+  /** next pcb in the demultiplexing bucket (UDP_PCB_HASH_SIZE) */
+  struct udp_pcb *demux_next;
 
   u8_t flags;
   /** ports are in host byte order */
@@ -106,6 +110,11 @@ struct udp_pcb {
   u16_t chksum_len_rx, chksum_len_tx;
 #endif /* LWIP_UDPLITE */
 
+#if LWIP_UDP_PRIORITY
+  /** priority of the datagrams sent, passed to the netif in the pbuf */
+  u8_t priority;
+#endif /* LWIP_UDP_PRIORITY */
+
   /** receive callback function */
   udp_recv_fn recv;
   /** user-supplied argument for the recv callback */
@@ -159,6 +168,13 @@ err_t            udp_sendto_if_src_chksum(struct udp_pcb *pcb, struct pbuf *p,
 #define          udp_clear_flags(pcb, clr_flags)   do { (pcb)->flags = (u8_t)((pcb)->flags & (u8_t)(~(clr_flags) & 0xff)); } while(0)
 #define          udp_is_flag_set(pcb, flag)        (((pcb)->flags & (flag)) != 0)
 
+#if LWIP_UDP_PRIORITY
+/** @ingroup udp_raw
+ * Sets the priority (0..7) of the datagrams sent by a pcb, 0 for new pcbs */
+#define          udp_set_priority(pcb, prio)       ((pcb)->priority = (u8_t)((prio) & 7))
+#define          udp_get_priority(pcb)             ((pcb)->priority)
+#endif /* LWIP_UDP_PRIORITY */
+
 /* The following functions are the lower layer interface to UDP. */
 void             udp_input      (struct pbuf *p, struct netif *inp);
 
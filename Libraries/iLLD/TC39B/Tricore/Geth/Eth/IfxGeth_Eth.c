@@ -58,6 +58,54 @@ IfxGeth_TxDescrList IfxGeth_Eth_txDescrList[IFXGETH_NUM_MODULES][IFXGETH_NUM_TX_
 /*-------------------------Function Implementations---------------------------*/
 /******************************************************************************/
 
+void IfxGeth_Eth_adaptRxCoalescing(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, uint32 numOfFrames)
+{
+    IfxGeth_Eth_RxChannel *rxChannel = &geth->rxChannel[channelId];
+    uint16                 time      = rxChannel->actualWatchdogTime;
+
+    if ((rxChannel->adaptiveCoalescing == FALSE) || (rxChannel->interruptWatchdogTime == 0))
+    {
+        return;
+    }
+
+    if (numOfFrames <= 1)
+    {
+        /* sparse traffic: the watchdog only delays the frame */
+        time = (time > 1) ? (time / 2) : 1;
+    }
+    else if (numOfFrames >= ((rxChannel->interruptFrameCount > 2) ? rxChannel->interruptFrameCount : 2))
+    {
+        /* bursts: collect more frames per interrupt */
+        time = ((uint32)time * 2 < rxChannel->interruptWatchdogTime) ? (uint16)(time * 2) : rxChannel->interruptWatchdogTime;
+    }
+
+    if (time != rxChannel->actualWatchdogTime)
+    {
+        IfxGeth_Eth_setRxInterruptWatchdog(geth, channelId, time);
+    }
+}
+
+
+void IfxGeth_Eth_adjustSystemTime(IfxGeth_Eth *geth, sint64 offset)
+{
+    boolean subtract  = (offset < 0) ? TRUE : FALSE;
+    uint64  magnitude = (uint64)((offset < 0) ? -offset : offset);
+
+    IfxGeth_mac_updateSystemTime(geth->gethSFR, subtract, (uint32)(magnitude / 1000000000U), (uint32)(magnitude % 1000000000U));
+}
+
+
+void IfxGeth_Eth_adjustSystemTimeFrequency(IfxGeth_Eth *geth, sint32 ppb)
+{
+    sint64 addend = (sint64)geth->timestampAddend;
+
+    IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, (ppb > -500000000) && (ppb < 500000000));
+
+    addend += (addend * ppb) / 1000000000;
+    IfxGeth_mac_setTimestampAddend(geth->gethSFR, (uint32)addend);
+}
+
+
 void IfxGeth_Eth_configureDMA(IfxGeth_Eth *geth, IfxGeth_Eth_DmaConfig *dmaConfig)
 {
     uint32 txChannelIndex, rxChannelIndex, channelIndex;
@@ -137,6 +185,11 @@ void IfxGeth_Eth_configureMTL(IfxGeth_Eth *geth, IfxGeth_Eth_MtlConfig *mtlConfi
         IfxGeth_mtl_setTxStoreAndForward(geth->gethSFR, (IfxGeth_TxMtlQueue)txQueueIndex, mtlConfig->txQueue[txQueueIndex].storeAndForward);
         IfxGeth_mtl_enableTxQueue(geth->gethSFR, (IfxGeth_TxMtlQueue)txQueueIndex);
 
+        if (mtlConfig->numOfTxQueues > 1)
+        {
+            IfxGeth_mtl_setTxQueueWeight(geth->gethSFR, (IfxGeth_TxMtlQueue)txQueueIndex, mtlConfig->txQueue[txQueueIndex].weight);
+        }
+
         if (mtlConfig->txQueue[txQueueIndex].txQueueUnderflowInterruptEnabled)
         {
             IfxGeth_mtl_enableInterrupt(geth->gethSFR, (IfxGeth_MtlQueue)txQueueIndex, IfxGeth_MtlInterruptFlag_txQueueUnderflow);
@@ -156,14 +209,16 @@ void IfxGeth_Eth_configureMTL(IfxGeth_Eth *geth, IfxGeth_Eth_MtlConfig *mtlConfi
         IfxGeth_mtl_setRxForwardErrorPacket(geth->gethSFR, (IfxGeth_RxMtlQueue)rxQueueIndex, mtlConfig->rxQueue[rxQueueIndex].forwardErrorPacket);
         IfxGeth_mtl_setRxForwardUndersizedGoodPacket(geth->gethSFR, (IfxGeth_RxMtlQueue)rxQueueIndex, mtlConfig->rxQueue[rxQueueIndex].forwardUndersizedGoodPacket);
 
+        /* with DA based selection the mapped channel still takes the packets which match no DA filter */
+        IfxGeth_mtl_setRxQueueDmaChannelMapping(geth->gethSFR, (IfxGeth_RxMtlQueue)rxQueueIndex, mtlConfig->rxQueue[rxQueueIndex].rxDmaChannelMap);
+
         if (mtlConfig->rxQueue[rxQueueIndex].daBasedDmaChannelEnabled != 0)
         {
             IfxGeth_mtl_setRxQueueForDaBasedDmaChannel(geth->gethSFR, (IfxGeth_RxMtlQueue)rxQueueIndex, TRUE);
         }
-        else
-        {
-            IfxGeth_mtl_setRxQueueDmaChannelMapping(geth->gethSFR, (IfxGeth_RxMtlQueue)rxQueueIndex, mtlConfig->rxQueue[rxQueueIndex].rxDmaChannelMap);
-        }
+
+        /* tagged packets are routed by their user priority */
+        IfxGeth_mac_setVlanPriorityQueueRouting(geth->gethSFR, (IfxGeth_RxDmaChannel)rxQueueIndex, mtlConfig->rxQueue[rxQueueIndex].vlanPriorities);
 
         IfxGeth_mtl_enableRxQueue(geth->gethSFR, (IfxGeth_RxMtlQueue)rxQueueIndex);
 
@@ -173,6 +228,18 @@ void IfxGeth_Eth_configureMTL(IfxGeth_Eth *geth, IfxGeth_Eth_MtlConfig *mtlConfi
         }
     }
 
+    /* Rx queue routing of untagged, multicast and broadcast packets */
+    IfxGeth_mac_setUntaggedPacketQueue(geth->gethSFR, mtlConfig->untaggedPacketQueue);
+
+    if (mtlConfig->multicastBroadcastQueueEnabled != 0)
+    {
+        IfxGeth_mac_enableMulticastBroadcastQueue(geth->gethSFR, mtlConfig->multicastBroadcastQueue);
+    }
+    else
+    {
+        IfxGeth_mac_disableMulticastBroadcastQueue(geth->gethSFR);
+    }
+
     if (mtlConfig->interrupt.priority > 0)
     {
         volatile Ifx_SRC_SRCR *srcSFR;
@@ -194,18 +261,25 @@ void IfxGeth_Eth_configureMacCore(IfxGeth_Eth *geth, IfxGeth_Eth_MacConfig *macC
 
     IfxGeth_mac_setCrcStripping(geth->gethSFR, FALSE, FALSE);
     IfxGeth_mac_setCrcChecking(geth->gethSFR, FALSE);
+    IfxGeth_mac_setRxChecksumOffload(geth->gethSFR, macConfig->rxChecksumOffloadEnabled);
 
     IfxGeth_mac_setLoopbackMode(geth->gethSFR, macConfig->loopbackMode);
 
     /* packet Filter Configuration */
-    IfxGeth_mac_setPromiscuousMode(geth->gethSFR, TRUE);
-    IfxGeth_mac_setAllMulticastPassing(geth->gethSFR, TRUE);
+    IfxGeth_mac_setPromiscuousMode(geth->gethSFR, macConfig->promiscuousMode);
+    IfxGeth_mac_setAllMulticastPassing(geth->gethSFR, macConfig->passAllMulticast);
 
-    /* Set Send Vlan */
-    IfxGeth_mac_writeQueueVlanTag(geth->gethSFR, IfxGeth_MtlQueue_0, 0x0A);
+    /* VLAN tags inserted as the Tx descriptors request it (IfxGeth_Eth_setTxVlanTag()), stripped on reception */
+    IfxGeth_mac_setDescriptorVlanInsertion(geth->gethSFR, macConfig->vlanTagging);
+    IfxGeth_mac_setRxVlanStripping(geth->gethSFR, macConfig->vlanTagging);
 
     /* set MAC Address */
     IfxGeth_mac_setMacAddress(geth->gethSFR, macConfig->macAddress);
+
+    if (macConfig->timestampingEnabled == TRUE)
+    {
+        IfxGeth_Eth_initSystemTime(geth, macConfig->timestampAllPackets);
+    }
 }
 
 
@@ -217,13 +291,41 @@ void IfxGeth_Eth_freeReceiveBuffer(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel chann
     rdes3.U        = 0;
     rdes3.R.BUF1V  = 1; /* buffer 1 valid */
     rdes3.R.BUF2V  = 0; /* buffer 2 not valid */
-    rdes3.R.IOC    = 1; /* interrupt enabled */
+    rdes3.R.IOC    = IfxGeth_Eth_getRxDescriptorIoc(geth, channelId, descr);
     rdes3.R.OWN    = 1; /* owned by DMA */
     descr->RDES3.U = rdes3.U;
     IfxGeth_Eth_shuffleRxDescriptor(geth, channelId);
 }
 
 
+void IfxGeth_Eth_refillReceiveBuffer(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, void *buffer)
+{
+    volatile IfxGeth_RxDescr *descr = IfxGeth_Eth_getActualRxDescriptor(geth, channelId);
+
+    IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, ((uint32)buffer % 4) == 0);
+
+    IfxGeth_RxDescr3          rdes3;
+    descr->RDES0.U = (uint32)buffer;
+    descr->RDES2.U = 0; /* buffer2 not used */
+    rdes3.U        = 0;
+    rdes3.R.BUF1V  = 1; /* buffer 1 valid */
+    rdes3.R.BUF2V  = 0; /* buffer 2 not valid */
+    rdes3.R.IOC    = IfxGeth_Eth_getRxDescriptorIoc(geth, channelId, descr);
+    rdes3.R.OWN    = 1; /* owned by DMA */
+    descr->RDES3.U = rdes3.U;
+    IfxGeth_Eth_shuffleRxDescriptor(geth, channelId);
+}
+
+
+void IfxGeth_Eth_updateRxTailPointer(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId)
+{
+    /* the tail pointer stays behind the last descriptor, the DMA walks the whole ring and stops on the OWN bit */
+    volatile IfxGeth_RxDescr *endDescr = &IfxGeth_Eth_getBaseRxDescriptor(geth, channelId)[geth->rxChannel[channelId].numOfDescriptors];
+
+    IfxGeth_dma_setRxDescriptorTailPointer(geth->gethSFR, channelId, (uint32)endDescr);
+}
+
+
 void *IfxGeth_Eth_getReceiveBuffer(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId)
 {
     void                     *result = 0;
@@ -242,6 +344,43 @@ void *IfxGeth_Eth_getReceiveBuffer(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel chann
 }
 
 
+boolean IfxGeth_Eth_getRxTimestamp(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, IfxGeth_Eth_Timestamp *timestamp)
+{
+    IfxGeth_Eth_RxChannel    *rxChannel = &geth->rxChannel[channelId];
+    volatile IfxGeth_RxDescr *descr     = IfxGeth_Eth_getActualRxDescriptor(geth, channelId);
+    volatile IfxGeth_RxDescr *next      = &descr[1];
+
+    /* RDES1 valid, timestamp available (in the context descriptor) */
+    if ((descr->RDES3.W.RS1V == 0) || (descr->RDES1.W.TSA == 0))
+    {
+        return FALSE;
+    }
+
+    if (next == &IfxGeth_Eth_getBaseRxDescriptor(geth, channelId)[rxChannel->numOfDescriptors])
+    {
+        next = IfxGeth_Eth_getBaseRxDescriptor(geth, channelId);
+    }
+
+    // the DMA writes the context descriptor after the frame, see IfxGeth_Eth_isRxTimestampPending()
+    if ((next->RDES3.C.OWN != 0) || (next->RDES3.C.CTXT == 0) || (next->RDES3.C.DE != 0))
+    {
+        return FALSE;
+    }
+
+    timestamp->nanoseconds = next->RDES0.C.RTSL;
+    timestamp->seconds     = next->RDES1.C.RTSH;
+
+    /* all ones: the timestamp is corrupted */
+    return (timestamp->nanoseconds != 0xFFFFFFFFU) || (timestamp->seconds != 0xFFFFFFFFU);
+}
+
+
+void IfxGeth_Eth_getSystemTime(IfxGeth_Eth *geth, IfxGeth_Eth_Timestamp *time)
+{
+    IfxGeth_mac_getSystemTime(geth->gethSFR, &time->seconds, &time->nanoseconds);
+}
+
+
 void *IfxGeth_Eth_getTransmitBuffer(IfxGeth_Eth *geth, IfxGeth_TxDmaChannel channelId)
 {
     void                     *buffer = NULL_PTR;
@@ -336,6 +475,12 @@ void IfxGeth_Eth_initModuleConfig(IfxGeth_Eth_Config *config, Ifx_GETH *gethSFR)
             .loopbackMode  = IfxGeth_LoopbackMode_disable,
             .maxPacketSize = 1518,
             .macAddress    = {0},
+            .promiscuousMode  = TRUE,
+            .passAllMulticast = TRUE,
+            .rxChecksumOffloadEnabled = FALSE,
+            .vlanTagging      = FALSE,
+            .timestampingEnabled = FALSE,
+            .timestampAllPackets = FALSE,
         },
         .mtl                                          = {
             .numOfTxQueues          = 1,
@@ -348,24 +493,28 @@ void IfxGeth_Eth_initModuleConfig(IfxGeth_Eth_Config *config, Ifx_GETH *gethSFR)
                     .storeAndForward                  = FALSE,
                     .txQueueSize                      = IfxGeth_QueueSize_256Bytes,
                     .txQueueUnderflowInterruptEnabled = FALSE,
+                    .weight                           = 0x10,
                 },
 
                 {
                     .storeAndForward                  = FALSE,
                     .txQueueSize                      = IfxGeth_QueueSize_256Bytes,
                     .txQueueUnderflowInterruptEnabled = FALSE,
+                    .weight                           = 0x10,
                 },
 
                 {
                     .storeAndForward                  = FALSE,
                     .txQueueSize                      = IfxGeth_QueueSize_256Bytes,
                     .txQueueUnderflowInterruptEnabled = FALSE,
+                    .weight                           = 0x10,
                 },
 
                 {
                     .storeAndForward                  = FALSE,
                     .txQueueSize                      = IfxGeth_QueueSize_256Bytes,
                     .txQueueUnderflowInterruptEnabled = FALSE,
+                    .weight                           = 0x10,
                 },
             },
 
@@ -377,6 +526,7 @@ void IfxGeth_Eth_initModuleConfig(IfxGeth_Eth_Config *config, Ifx_GETH *gethSFR)
                     .forwardUndersizedGoodPacket     = FALSE,
                     .daBasedDmaChannelEnabled        = FALSE,
                     .rxDmaChannelMap                 = IfxGeth_RxDmaChannel_0,
+                    .vlanPriorities                  = 0,
                     .rxQueueOverflowInterruptEnabled = FALSE,
                 },
 
@@ -387,6 +537,7 @@ void IfxGeth_Eth_initModuleConfig(IfxGeth_Eth_Config *config, Ifx_GETH *gethSFR)
                     .forwardUndersizedGoodPacket     = FALSE,
                     .daBasedDmaChannelEnabled        = FALSE,
                     .rxDmaChannelMap                 = IfxGeth_RxDmaChannel_1,
+                    .vlanPriorities                  = 0,
                     .rxQueueOverflowInterruptEnabled = FALSE,
                 },
 
@@ -397,6 +548,7 @@ void IfxGeth_Eth_initModuleConfig(IfxGeth_Eth_Config *config, Ifx_GETH *gethSFR)
                     .forwardUndersizedGoodPacket     = FALSE,
                     .daBasedDmaChannelEnabled        = FALSE,
                     .rxDmaChannelMap                 = IfxGeth_RxDmaChannel_2,
+                    .vlanPriorities                  = 0,
                     .rxQueueOverflowInterruptEnabled = FALSE,
                 },
 
@@ -407,9 +559,13 @@ void IfxGeth_Eth_initModuleConfig(IfxGeth_Eth_Config *config, Ifx_GETH *gethSFR)
                     .forwardUndersizedGoodPacket     = FALSE,
                     .daBasedDmaChannelEnabled        = FALSE,
                     .rxDmaChannelMap                 = IfxGeth_RxDmaChannel_3,
+                    .vlanPriorities                  = 0,
                     .rxQueueOverflowInterruptEnabled = FALSE,
                 },
             },
+            .untaggedPacketQueue                      = IfxGeth_RxMtlQueue_0,
+            .multicastBroadcastQueueEnabled           = FALSE,
+            .multicastBroadcastQueue                  = IfxGeth_RxMtlQueue_0,
             .interrupt                                = {
                 .serviceRequest = IfxGeth_ServiceRequest_1,
                 .priority       = 0,
@@ -427,32 +583,40 @@ void IfxGeth_Eth_initModuleConfig(IfxGeth_Eth_Config *config, Ifx_GETH *gethSFR)
                     .channelId             = IfxGeth_TxDmaChannel_0,
                     .maxBurstLength        = IfxGeth_DmaBurstLength_0,
                     .txDescrList           = &IfxGeth_Eth_txDescrList[gethIndex][0],
+                    .numOfDescriptors      = IFXGETH_MAX_TX_DESCRIPTORS,
                     .txBuffer1StartAddress = NULL_PTR,
                     .txBuffer1Size         = 256,
+                    .interruptFrameCount   = 1,
                 },
 
                 {
                     .channelId             = IfxGeth_TxDmaChannel_1,
                     .maxBurstLength        = IfxGeth_DmaBurstLength_0,
                     .txDescrList           = &IfxGeth_Eth_txDescrList[gethIndex][1],
+                    .numOfDescriptors      = IFXGETH_MAX_TX_DESCRIPTORS,
                     .txBuffer1StartAddress = NULL_PTR,
                     .txBuffer1Size         = 256,
+                    .interruptFrameCount   = 1,
                 },
 
                 {
                     .channelId             = IfxGeth_TxDmaChannel_2,
                     .maxBurstLength        = IfxGeth_DmaBurstLength_0,
                     .txDescrList           = &IfxGeth_Eth_txDescrList[gethIndex][2],
+                    .numOfDescriptors      = IFXGETH_MAX_TX_DESCRIPTORS,
                     .txBuffer1StartAddress = NULL_PTR,
                     .txBuffer1Size         = 256,
+                    .interruptFrameCount   = 1,
                 },
 
                 {
                     .channelId             = IfxGeth_TxDmaChannel_3,
                     .maxBurstLength        = IfxGeth_DmaBurstLength_0,
                     .txDescrList           = &IfxGeth_Eth_txDescrList[gethIndex][3],
+                    .numOfDescriptors      = IFXGETH_MAX_TX_DESCRIPTORS,
                     .txBuffer1StartAddress = NULL_PTR,
                     .txBuffer1Size         = 256,
+                    .interruptFrameCount   = 1,
                 },
             },
 
@@ -461,32 +625,48 @@ void IfxGeth_Eth_initModuleConfig(IfxGeth_Eth_Config *config, Ifx_GETH *gethSFR)
                     .channelId             = IfxGeth_RxDmaChannel_0,
                     .maxBurstLength        = IfxGeth_DmaBurstLength_0,
                     .rxDescrList           = &IfxGeth_Eth_rxDescrList[gethIndex][0],
+                    .numOfDescriptors      = IFXGETH_MAX_RX_DESCRIPTORS,
                     .rxBuffer1StartAddress = NULL_PTR,
                     .rxBuffer1Size         = 256,
+                    .interruptWatchdogTime = 0,
+                    .interruptFrameCount   = 1,
+                    .adaptiveCoalescing    = FALSE,
                 },
 
                 {
                     .channelId             = IfxGeth_RxDmaChannel_1,
                     .maxBurstLength        = IfxGeth_DmaBurstLength_0,
                     .rxDescrList           = &IfxGeth_Eth_rxDescrList[gethIndex][1],
+                    .numOfDescriptors      = IFXGETH_MAX_RX_DESCRIPTORS,
                     .rxBuffer1StartAddress = NULL_PTR,
                     .rxBuffer1Size         = 256,
+                    .interruptWatchdogTime = 0,
+                    .interruptFrameCount   = 1,
+                    .adaptiveCoalescing    = FALSE,
                 },
 
                 {
                     .channelId             = IfxGeth_RxDmaChannel_2,
                     .maxBurstLength        = IfxGeth_DmaBurstLength_0,
                     .rxDescrList           = &IfxGeth_Eth_rxDescrList[gethIndex][2],
+                    .numOfDescriptors      = IFXGETH_MAX_RX_DESCRIPTORS,
                     .rxBuffer1StartAddress = NULL_PTR,
                     .rxBuffer1Size         = 256,
+                    .interruptWatchdogTime = 0,
+                    .interruptFrameCount   = 1,
+                    .adaptiveCoalescing    = FALSE,
                 },
 
                 {
                     .channelId             = IfxGeth_RxDmaChannel_3,
                     .maxBurstLength        = IfxGeth_DmaBurstLength_0,
                     .rxDescrList           = &IfxGeth_Eth_rxDescrList[gethIndex][3],
+                    .numOfDescriptors      = IFXGETH_MAX_RX_DESCRIPTORS,
                     .rxBuffer1StartAddress = NULL_PTR,
                     .rxBuffer1Size         = 256,
+                    .interruptWatchdogTime = 0,
+                    .interruptFrameCount   = 1,
+                    .adaptiveCoalescing    = FALSE,
                 },
             },
 
@@ -558,24 +738,29 @@ void IfxGeth_Eth_initReceiveDescriptors(IfxGeth_Eth *geth, IfxGeth_Eth_RxChannel
     uint32                    buffer1StartAddress = (uint32)config->rxBuffer1StartAddress;
 
     IfxGeth_RxDmaChannel      channelId           = config->channelId;
-    geth->rxChannel[channelId].channelId   = channelId;
-    geth->rxChannel[channelId].rxDescrList = config->rxDescrList;
+    geth->rxChannel[channelId].channelId        = channelId;
+    geth->rxChannel[channelId].rxDescrList      = config->rxDescrList;
+    geth->rxChannel[channelId].numOfDescriptors = config->numOfDescriptors;
+    geth->rxChannel[channelId].interruptFrameCount   = config->interruptFrameCount;
+    geth->rxChannel[channelId].adaptiveCoalescing    = config->adaptiveCoalescing;
+    geth->rxChannel[channelId].interruptWatchdogTime = config->interruptWatchdogTime;
 
     volatile IfxGeth_RxDescr *descr = IfxGeth_Eth_getBaseRxDescriptor(geth, channelId);
 
     geth->rxChannel[channelId].rxDescrPtr = descr;
 
     IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, (config->rxBuffer1Size) % 4 == 0);
+    IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, (config->numOfDescriptors > 0) && (config->numOfDescriptors <= 1024)); /* 10 bit ring length */
 
     /* Initialize descriptors in ring mode */
-    for (i = 0; i < IFXGETH_MAX_RX_DESCRIPTORS; i++)
+    for (i = 0; i < config->numOfDescriptors; i++)
     {
         descr->RDES0.U       = (uint32)(config->rxBuffer1Size * i) + buffer1StartAddress;
         descr->RDES2.U       = 0; /* buffer2 not used */
 
         descr->RDES3.R.BUF1V = 1; /* buffer 1 valid */
         descr->RDES3.R.BUF2V = 0; /* buffer 2 not valid */
-        descr->RDES3.R.IOC   = 1; /* interrupt enabled */
+        descr->RDES3.R.IOC   = IfxGeth_Eth_getRxDescriptorIoc(geth, channelId, descr);
         descr->RDES3.R.OWN   = 1; /* owned by DMA */
 
         descr                = &descr[1];
@@ -584,12 +769,34 @@ void IfxGeth_Eth_initReceiveDescriptors(IfxGeth_Eth *geth, IfxGeth_Eth_RxChannel
     /* rest the current pointer to base pointer in the handle */
     geth->rxChannel[channelId].rxDescrPtr = IfxGeth_Eth_getBaseRxDescriptor(geth, channelId);
 
+    /* frames in descriptors without IOC are signalled by the watchdog */
+    IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, (config->interruptFrameCount <= 1) || (config->interruptWatchdogTime != 0));
+    IfxGeth_Eth_setRxInterruptWatchdog(geth, channelId, config->interruptWatchdogTime);
+
     /* set the buffer size */
     IfxGeth_dma_setRxBufferSize(geth->gethSFR, channelId, config->rxBuffer1Size);
 
     IfxGeth_dma_setRxDescriptorListAddress(geth->gethSFR, channelId, (uint32)IfxGeth_Eth_getBaseRxDescriptor(geth, channelId));
-    IfxGeth_dma_setRxDescriptorTailPointer(geth->gethSFR, channelId, (uint32)descr);
-    IfxGeth_dma_setRxDescriptorRingLength(geth->gethSFR, channelId, (IFXGETH_MAX_RX_DESCRIPTORS - 1));
+    IfxGeth_Eth_updateRxTailPointer(geth, channelId);
+    IfxGeth_dma_setRxDescriptorRingLength(geth->gethSFR, channelId, (config->numOfDescriptors - 1));
+}
+
+
+void IfxGeth_Eth_initSystemTime(IfxGeth_Eth *geth, boolean allPackets)
+{
+    uint32 fGeth     = (uint32)IfxScuCcu_getGethFrequency();
+    /* the accumulator overflows at most at fGETH / 2: smallest increment in ns to reach 1 s */
+    uint32 increment = (2000000000U + fGeth - 1) / fGeth;
+
+    IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, increment <= 255);
+
+    /* overflows per second (10^9 / increment) = fGETH * addend / 2^32 */
+    geth->timestampAddend = (uint32)((1000000000ULL << 32) / ((uint64)increment * fGeth));
+
+    IfxGeth_mac_enableTimestamping(geth->gethSFR, allPackets);
+    IfxGeth_mac_setSubSecondIncrement(geth->gethSFR, (uint8)increment);
+    IfxGeth_mac_setTimestampAddend(geth->gethSFR, geth->timestampAddend);
+    IfxGeth_mac_initSystemTime(geth->gethSFR, 0, 0);
 }
 
 
@@ -599,25 +806,32 @@ void IfxGeth_Eth_initTransmitDescriptors(IfxGeth_Eth *geth, IfxGeth_Eth_TxChanne
     uint32               buffer1StartAddress = (uint32)config->txBuffer1StartAddress;
 
     IfxGeth_TxDmaChannel channelId           = config->channelId;
-    geth->txChannel[channelId].channelId   = channelId;
-    geth->txChannel[channelId].txDescrList = config->txDescrList;
-    geth->txChannel[channelId].txBuf1Size  = (uint16)config->txBuffer1Size;
+    geth->txChannel[channelId].channelId        = channelId;
+    geth->txChannel[channelId].txDescrList      = config->txDescrList;
+    geth->txChannel[channelId].txBuf1Size       = (uint16)config->txBuffer1Size;
+    geth->txChannel[channelId].numOfDescriptors = config->numOfDescriptors;
+    geth->txChannel[channelId].interruptFrameCount    = config->interruptFrameCount;
+    geth->txChannel[channelId].framesWithoutInterrupt = 0;
+    geth->txChannel[channelId].vlanTag                = 0;
+    geth->txChannel[channelId].vlanTagValid           = FALSE;
+    geth->txChannel[channelId].vlanTagInsertion       = FALSE;
+    geth->txChannel[channelId].txTimestampRequest     = FALSE;
 
     volatile IfxGeth_TxDescr *descr = IfxGeth_Eth_getBaseTxDescriptor(geth, channelId);
 
     geth->txChannel[channelId].txDescrPtr = descr;
 
     IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, (config->txBuffer1Size) % 4 == 0);
+    IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, (config->numOfDescriptors > 0) && (config->numOfDescriptors <= 1024)); /* 10 bit ring length */
 
     /* Initialize descriptors in ring mode */
-    for (i = 0; i < IFXGETH_MAX_TX_DESCRIPTORS; i++)
+    for (i = 0; i < config->numOfDescriptors; i++)
     {
         descr->TDES0.U           = (uint32)(config->txBuffer1Size * i) + buffer1StartAddress;
         descr->TDES1.U           = 0; /* buffer2 not used */
 
         descr->TDES2.R.B1L       = config->txBuffer1Size;
-        /* Insert a VLAN tag */
-        descr->TDES2.R.VTIR      = 2; 
+        descr->TDES2.R.VTIR      = 0; /* VLAN tag insertion is set per frame */
         descr->TDES2.R.B2L       = 0; /* buffer2 not used */
         descr->TDES2.R.TTSE_TMWD = 0; /* timestamp not used */
         descr->TDES2.R.IOC       = 0; /* interrupt disabled */
@@ -631,19 +845,21 @@ void IfxGeth_Eth_initTransmitDescriptors(IfxGeth_Eth *geth, IfxGeth_Eth_TxChanne
     geth->txChannel[channelId].txDescrPtr = IfxGeth_Eth_getBaseTxDescriptor(geth, channelId);
 
     IfxGeth_dma_setTxDescriptorListAddress(geth->gethSFR, channelId, (uint32)IfxGeth_Eth_getBaseTxDescriptor(geth, channelId));
-    IfxGeth_dma_setTxDescriptorRingLength(geth->gethSFR, channelId, (IFXGETH_MAX_TX_DESCRIPTORS - 1));
+    IfxGeth_dma_setTxDescriptorRingLength(geth->gethSFR, channelId, (config->numOfDescriptors - 1));
 }
 
 
-void IfxGeth_Eth_sendFrame(IfxGeth_Eth *geth, IfxGeth_Eth_FrameConfig *config)
+void IfxGeth_Eth_requestTxTimestamp(IfxGeth_Eth *geth, IfxGeth_TxDmaChannel channelId)
 {
-    IfxGeth_Eth_sendTransmitBuffer(geth, config->packetLength, config->channelId);
+    geth->txChannel[channelId].txTimestampRequest = TRUE;
 }
 
 
-void IfxGeth_Eth_sendTransmitBuffer(IfxGeth_Eth *geth, uint32 packetLength, IfxGeth_TxDmaChannel channelId)
+void IfxGeth_Eth_sendFrame(IfxGeth_Eth *geth, IfxGeth_Eth_FrameConfig *config)
 {
     uint32                    i;
+    uint32                    packetLength     = config->packetLength;
+    IfxGeth_TxDmaChannel      channelId        = config->channelId;
     volatile IfxGeth_TxDescr *firstDescr       = IfxGeth_Eth_getActualTxDescriptor(geth, channelId);
     volatile IfxGeth_TxDescr *descr            = firstDescr;
     volatile IfxGeth_TxDescr *nextDescr        = &firstDescr[1];
@@ -659,9 +875,11 @@ void IfxGeth_Eth_sendTransmitBuffer(IfxGeth_Eth *geth, uint32 packetLength, IfxG
     /* configure the first descriptor */
     firstDescr->TDES3.R.FL_TPL  = packetLength; /* total length of the packet */
     firstDescr->TDES3.R.TSE     = 0;            /* TCP Segmentation Disable */
-    firstDescr->TDES3.R.CIC_TPL = 3;
+    firstDescr->TDES3.R.CIC_TPL = config->checksumInsertion;
     firstDescr->TDES3.R.SAIC    = 0;            /* Source Address insertion disabled */
     firstDescr->TDES3.R.CPC     = 0;            /* CRC and PAD insertion enabled */
+    firstDescr->TDES2.R.VTIR    = geth->txChannel[channelId].vlanTagInsertion ? 2 : 0; /* insert the tag of the last context descriptor */
+    IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, geth->txChannel[channelId].txTimestampRequest == FALSE); /* see IfxGeth_Eth_requestTxTimestamp() */
 
     /* configure every other descriptor including first descriptor for the frame transmission */
     for (i = 0; i < numOfDescriptors; i++)
@@ -669,7 +887,7 @@ void IfxGeth_Eth_sendTransmitBuffer(IfxGeth_Eth *geth, uint32 packetLength, IfxG
         if (i == (numOfDescriptors - 1))
         {
             descr->TDES3.R.LD  = 1;                                              /* last descriptor of the frame */
-            descr->TDES2.R.IOC = 1;                                              /* last descriptor of the frame set IOC */
+            descr->TDES2.R.IOC = IfxGeth_Eth_getTxFrameIoc(geth, channelId);   /* last descriptor of the frame, IOC on every Nth frame */
             descr->TDES3.R.FD  = 0;
             descr->TDES2.R.B1L = packetLength;
         }
@@ -682,6 +900,11 @@ void IfxGeth_Eth_sendTransmitBuffer(IfxGeth_Eth *geth, uint32 packetLength, IfxG
             packetLength      -= bufferLength;
         }
 
+        if (descr != firstDescr)
+        {
+            descr->TDES2.R.VTIR = 0;
+        }
+
         IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, descr->TDES3.R.OWN != 1U);           /* Assert if buffers are not available for transfer */
         descr->TDES3.R.OWN = 1U;                                                 /* release to DMA */
         IfxGeth_Eth_shuffleTxDescriptor(geth, channelId);
@@ -699,6 +922,86 @@ void IfxGeth_Eth_sendTransmitBuffer(IfxGeth_Eth *geth, uint32 packetLength, IfxG
 }
 
 
+void IfxGeth_Eth_sendTransmitBuffer(IfxGeth_Eth *geth, uint32 packetLength, IfxGeth_TxDmaChannel channelId)
+{
+    IfxGeth_Eth_FrameConfig config;
+
+    config.channelId         = channelId;
+    config.packetLength      = packetLength;
+    config.checksumInsertion = IfxGeth_ChecksumInsertion_full;
+    IfxGeth_Eth_sendFrame(geth, &config);
+}
+
+
+void IfxGeth_Eth_sendTransmitSegments(IfxGeth_Eth *geth, const IfxGeth_Eth_TxSegment *segments, uint32 numOfSegments, IfxGeth_TxDmaChannel channelId, IfxGeth_ChecksumInsertion checksumInsertion)
+{
+    uint32                    i;
+    uint32                    packetLength = 0;
+    volatile IfxGeth_TxDescr *firstDescr   = IfxGeth_Eth_getActualTxDescriptor(geth, channelId);
+    volatile IfxGeth_TxDescr *descr        = firstDescr;
+    IfxGeth_TxDescr3          firstTdes3;
+    IfxGeth_TxDescr3          tdes3;
+    uint32                    ioc;
+    uint32                    vtir = geth->txChannel[channelId].vlanTagInsertion ? 2 : 0; /* insert the tag of the last context descriptor */
+    uint32                    ttse = geth->txChannel[channelId].txTimestampRequest ? 1 : 0;
+
+    IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, (numOfSegments > 0) && (numOfSegments < geth->txChannel[channelId].numOfDescriptors));
+
+    ioc = IfxGeth_Eth_getTxFrameIoc(geth, channelId);
+    geth->txChannel[channelId].txTimestampRequest = FALSE;
+
+    for (i = 0; i < numOfSegments; i++)
+    {
+        packetLength += segments[i].length;
+    }
+
+    /* configure the first descriptor, it is released to the DMA after all others */
+    firstTdes3.U         = 0;
+    firstTdes3.R.FL_TPL  = packetLength; /* total length of the packet */
+    firstTdes3.R.TSE     = 0;            /* TCP Segmentation Disable */
+    firstTdes3.R.CIC_TPL = checksumInsertion;
+    firstTdes3.R.SAIC    = 0;            /* Source Address insertion disabled */
+    firstTdes3.R.CPC     = 0;            /* CRC and PAD insertion enabled */
+    firstTdes3.R.FD      = 1;            /* first descriptor of the frame */
+
+    /* one descriptor for every segment, buffer 1 points directly to the segment data */
+    for (i = 0; i < numOfSegments; i++)
+    {
+        IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, descr->TDES3.R.OWN != 1U);           /* Assert if buffers are not available for transfer */
+        descr->TDES0.U     = (uint32)segments[i].buffer;
+        descr->TDES2.R.B1L = segments[i].length;
+        descr->TDES2.R.IOC = (i == (numOfSegments - 1)) ? ioc : 0;               /* interrupt on the last descriptor of the frame only */
+        descr->TDES2.R.VTIR = (i == 0) ? vtir : 0;                                /* only valid in the first descriptor */
+        descr->TDES2.R.TTSE_TMWD = (i == 0) ? ttse : 0;                           /* timestamp the frame */
+
+        tdes3.U            = (i == 0) ? firstTdes3.U : 0;
+        tdes3.R.LD         = (i == (numOfSegments - 1)) ? 1 : 0;                 /* last descriptor of the frame */
+
+        if (i != 0)
+        {
+            tdes3.R.OWN    = 1U;                                                 /* release to DMA */
+            descr->TDES3.U = tdes3.U;
+        }
+        else
+        {
+            firstTdes3.U = tdes3.U;
+        }
+
+        IfxGeth_Eth_shuffleTxDescriptor(geth, channelId);
+        descr = IfxGeth_Eth_getActualTxDescriptor(geth, channelId);              /* update the descr pointer */
+    }
+
+    /* the DMA may start with the frame only once all of its descriptors are prepared */
+    firstTdes3.R.OWN    = 1U;
+    firstDescr->TDES3.U = firstTdes3.U;
+
+    IfxGeth_dma_setTxDescriptorTailPointer(geth->gethSFR, channelId, (uint32)descr);
+    IfxGeth_Eth_wakeupTransmitter(geth, channelId); /* initialte the transfer */
+
+    geth->txChannel[channelId].txCount++;
+}
+
+
 void IfxGeth_Eth_setupMiiInputPins(IfxGeth_Eth *geth, const IfxGeth_Eth_MiiPins *miiPins)
 {
     IfxPort_InputMode mode       = IfxPort_InputMode_noPullDevice;
@@ -992,10 +1295,84 @@ void IfxGeth_Eth_setupRmiiOutputPins(IfxGeth_Eth *geth, const IfxGeth_Eth_RmiiPi
 }
 
 
+void IfxGeth_Eth_setRxInterruptWatchdog(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, uint16 time)
+{
+    uint32 cycles = (uint32)((IfxScuCcu_getGethFrequency() / 1000000.0f) * time);
+    uint32 countUnit;
+    uint32 count  = 0;
+
+    /* the smallest unit (256 << countUnit cycles) which covers the time with an 8 bit count */
+    for (countUnit = 0; countUnit < 4; countUnit++)
+    {
+        uint32 unitCycles = 256U << countUnit;
+
+        count = (cycles + unitCycles - 1) / unitCycles;
+
+        if (count <= 255)
+        {
+            break;
+        }
+    }
+
+    if (countUnit == 4)
+    {
+        countUnit = 3;
+        count     = 255;
+    }
+
+    if ((time != 0) && (count == 0))
+    {
+        count = 1; /* 0 would disable the watchdog */
+    }
+
+    IfxGeth_dma_setRxInterruptWatchdogTimer(geth->gethSFR, channelId, (uint8)count, (uint8)countUnit);
+    geth->rxChannel[channelId].actualWatchdogTime = time;
+}
+
+
+void IfxGeth_Eth_setSystemTime(IfxGeth_Eth *geth, const IfxGeth_Eth_Timestamp *time)
+{
+    IfxGeth_mac_initSystemTime(geth->gethSFR, time->seconds, time->nanoseconds);
+}
+
+
+uint32 IfxGeth_Eth_setTxVlanTag(IfxGeth_Eth *geth, IfxGeth_TxDmaChannel channelId, boolean insert, uint16 vlanTag)
+{
+    IfxGeth_Eth_TxChannel    *txChannel = &geth->txChannel[channelId];
+    volatile IfxGeth_TxDescr *descr;
+    IfxGeth_TxDescr3          tdes3;
+
+    txChannel->vlanTagInsertion = insert;
+
+    if ((insert == FALSE) || ((txChannel->vlanTagValid != FALSE) && (txChannel->vlanTag == vlanTag)))
+    {
+        /* the DMA still has the tag */
+        return 0;
+    }
+
+    /* context descriptor: TDES0..2 (timestamp, MSS, inner tag) are not used */
+    descr = IfxGeth_Eth_getActualTxDescriptor(geth, channelId);
+    IFX_ASSERT(IFX_VERBOSE_LEVEL_ERROR, descr->TDES3.R.OWN != 1U); /* Assert if the descriptor is not available */
+
+    tdes3.U        = 0;
+    tdes3.C.VT     = vlanTag;
+    tdes3.C.VLTV   = 1;
+    tdes3.C.CTXT   = 1;
+    tdes3.C.OWN    = 1U;                                         /* the DMA takes it with the next frame (tail pointer) */
+    descr->TDES3.U = tdes3.U;
+    IfxGeth_Eth_shuffleTxDescriptor(geth, channelId);
+
+    txChannel->vlanTag      = vlanTag;
+    txChannel->vlanTagValid = TRUE;
+
+    return 1;
+}
+
+
 void IfxGeth_Eth_shuffleRxDescriptor(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId)
 {
     volatile IfxGeth_RxDescr *currentDescr = geth->rxChannel[channelId].rxDescrPtr;
-    volatile IfxGeth_RxDescr *lastDescr    = &geth->rxChannel[channelId].rxDescrList->descr[IFXGETH_MAX_RX_DESCRIPTORS - 1];
+    volatile IfxGeth_RxDescr *lastDescr    = &geth->rxChannel[channelId].rxDescrList->descr[geth->rxChannel[channelId].numOfDescriptors - 1];
 
     if (currentDescr == lastDescr)
     {
@@ -1013,7 +1390,7 @@ void IfxGeth_Eth_shuffleRxDescriptor(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel cha
 void IfxGeth_Eth_shuffleTxDescriptor(IfxGeth_Eth *geth, IfxGeth_TxDmaChannel channelId)
 {
     volatile IfxGeth_TxDescr *currentDescr = geth->txChannel[channelId].txDescrPtr;
-    volatile IfxGeth_TxDescr *lastDescr    = &geth->txChannel[channelId].txDescrList->descr[IFXGETH_MAX_TX_DESCRIPTORS - 1];
+    volatile IfxGeth_TxDescr *lastDescr    = &geth->txChannel[channelId].txDescrList->descr[geth->txChannel[channelId].numOfDescriptors - 1];
 
     if (currentDescr == lastDescr)
     {
@@ -252,6 +252,7 @@
 #include "_PinMap/IfxGeth_PinMap.h"
 #include "IfxPort_reg.h"
 #include "IfxPort_bf.h"
+#include "Scu/Std/IfxScuCcu.h"
 
 /******************************************************************************/
 /*-----------------------------Data Structures--------------------------------*/
@@ -344,8 +345,12 @@ typedef struct
     IfxGeth_RxDmaChannel   channelId;                   /**< \brief Rx DMA channel Index */
     IfxGeth_DmaBurstLength maxBurstLength;              /**< \brief Maximum burst length of the channel */
     IfxGeth_RxDescrList   *rxDescrList;                 /**< \brief pointer to RX descriptors RAM */
+    uint16                 numOfDescriptors;            /**< \brief Number of descriptors in the ring (rxDescrList has to hold them, max. 1024) */
     uint32                *rxBuffer1StartAddress;       /**< \brief Start address of Rx Buffer 1 */
     uint16                 rxBuffer1Size;               /**< \brief Size of Rx Buffer 1 */
+    uint16                 interruptWatchdogTime;       /**< \brief Rx interrupt watchdog in us: a frame without IOC raises the Rx interrupt this long after its reception, 0: disabled */
+    uint16                 interruptFrameCount;         /**< \brief IOC on every Nth descriptor only (needs the watchdog), 0 or 1: on every descriptor */
+    boolean                adaptiveCoalescing;          /**< \brief Shorten the watchdog while the traffic is sparse, see IfxGeth_Eth_adaptRxCoalescing() */
 } IfxGeth_Eth_RxChannelConfig;
 
 /** \brief Rx Queue Configuration
@@ -357,7 +362,8 @@ typedef struct
     boolean              forwardErrorPacket;                    /**< \brief Error Packet Forwarding Enable/Disable */
     boolean              forwardUndersizedGoodPacket;           /**< \brief Undersized Good Packet Forwarding Enable/Disable */
     boolean              daBasedDmaChannelEnabled;              /**< \brief DA-based DMA Channel Selection Enable/Disable */
-    IfxGeth_RxDmaChannel rxDmaChannelMap;                       /**< \brief Mapped DMA Channel of Rx Queue */
+    IfxGeth_RxDmaChannel rxDmaChannelMap;                       /**< \brief Mapped DMA Channel of Rx Queue (DMA channel of the packets not matching a DA filter if daBasedDmaChannelEnabled) */
+    uint8                vlanPriorities;                        /**< \brief VLAN user priorities routed to this queue (bit n: PCP n), 0: none */
     boolean              rxQueueOverflowInterruptEnabled;       /**< \brief Enable/Disable Rx Queue Overflow Interrupt */
 } IfxGeth_Eth_RxQueueConfig;
 
@@ -368,8 +374,10 @@ typedef struct
     IfxGeth_TxDmaChannel   channelId;                   /**< \brief Tx DMA channel Index */
     IfxGeth_DmaBurstLength maxBurstLength;              /**< \brief Maximum burst length of the channel */
     IfxGeth_TxDescrList   *txDescrList;                 /**< \brief pointer to TX descriptors RAM */
+    uint16                 numOfDescriptors;            /**< \brief Number of descriptors in the ring (txDescrList has to hold them, max. 1024) */
     uint32                *txBuffer1StartAddress;       /**< \brief Start address of Tx Buffer 1 */
     uint16                 txBuffer1Size;               /**< \brief Size of Tx Buffer 1 */
+    uint16                 interruptFrameCount;         /**< \brief IOC on the last descriptor of every Nth frame only, 0 or 1: on every frame */
 } IfxGeth_Eth_TxChannelConfig;
 
 /** \brief Tx Queue Configuration
@@ -379,6 +387,7 @@ typedef struct
     boolean           storeAndForward;                        /**< \brief Transmit Store and Forward Enable/Disable */
     IfxGeth_QueueSize txQueueSize;                            /**< \brief Tx Queue size */
     boolean           txQueueUnderflowInterruptEnabled;       /**< \brief Enable/Disable Tx Queue Underflow Interrupt */
+    uint32            weight;                                 /**< \brief Weight of the queue for the WRR scheduling (when no of queues are more than 1) */
 } IfxGeth_Eth_TxQueueConfig;
 
 /** \} */
@@ -409,6 +418,12 @@ typedef struct
     IfxGeth_LoopbackMode loopbackMode;        /**< \brief Loopback mode enable/disable */
     uint8                macAddress[6];       /**< \brief MAC address for the ethernet, should be unique in the network */
     uint16               maxPacketSize;       /**< \brief Maximum size of the ethernet packet */
+    boolean              promiscuousMode;     /**< \brief Pass all packets regardless of their destination address */
+    boolean              passAllMulticast;    /**< \brief Pass all multicast packets, otherwise only those matching an address filter */
+    boolean              rxChecksumOffloadEnabled; /**< \brief Verify the IPv4 header and TCP/UDP/ICMP checksums of received packets (result in RDES1) */
+    boolean              vlanTagging;         /**< \brief Insert the VLAN tag into the packets set by IfxGeth_Eth_setTxVlanTag(), strip it from received packets (reported in RDES0) */
+    boolean              timestampingEnabled; /**< \brief Run the system time and timestamp received packets (in a context descriptor behind the packet), see IfxGeth_Eth_initSystemTime() */
+    boolean              timestampAllPackets; /**< \brief Timestamp all received packets, otherwise only the PTP event messages */
 } IfxGeth_Eth_MacConfig;
 
 /** \brief Configuration Structure for the MTL initialisation
@@ -421,6 +436,9 @@ typedef struct
     IfxGeth_RxArbitrationAlgorithm rxArbitrationAlgorithm;               /**< \brief Rx Arbitration Algorithm for Rx queues when no of queues are more than 1 */
     IfxGeth_Eth_TxQueueConfig      txQueue[IFXGETH_NUM_TX_QUEUES];       /**< \brief Tx queue configurations of selected queues */
     IfxGeth_Eth_RxQueueConfig      rxQueue[IFXGETH_NUM_RX_QUEUES];       /**< \brief Rx queue configurations of selected queues */
+    IfxGeth_RxMtlQueue             untaggedPacketQueue;                  /**< \brief Rx queue of the untagged packets */
+    boolean                        multicastBroadcastQueueEnabled;       /**< \brief Enable/Disable routing of multicast and broadcast packets to multicastBroadcastQueue */
+    IfxGeth_RxMtlQueue             multicastBroadcastQueue;              /**< \brief Rx queue of the multicast and broadcast packets */
     IfxGeth_Eth_MtlInterruptConfig interrupt;                            /**< \brief Interrupt configuration structure for MTL block */
 } IfxGeth_Eth_MtlConfig;
 
@@ -437,21 +455,33 @@ typedef struct
  */
 typedef struct
 {
-    IfxGeth_RxDmaChannel      channelId;         /**< \brief Rx DMA channel Index */
-    IfxGeth_RxDescrList      *rxDescrList;       /**< \brief pointer to RX descriptors RAM */
-    volatile IfxGeth_RxDescr *rxDescrPtr;        /**< \brief Pointer to Rx Descriptor (current descriptor) */
-    uint32                    rxCount;           /**< \brief Number of frames received */
+    IfxGeth_RxDmaChannel      channelId;              /**< \brief Rx DMA channel Index */
+    IfxGeth_RxDescrList      *rxDescrList;            /**< \brief pointer to RX descriptors RAM */
+    volatile IfxGeth_RxDescr *rxDescrPtr;             /**< \brief Pointer to Rx Descriptor (current descriptor) */
+    uint32                    rxCount;                /**< \brief Number of frames received */
+    uint16                    numOfDescriptors;       /**< \brief Number of descriptors in the ring */
+    uint16                    interruptFrameCount;    /**< \brief IOC on every Nth descriptor */
+    uint16                    interruptWatchdogTime;  /**< \brief configured Rx interrupt watchdog in us (upper limit of the adaptive mode) */
+    uint16                    actualWatchdogTime;     /**< \brief Rx interrupt watchdog in us as currently programmed */
+    boolean                   adaptiveCoalescing;     /**< \brief watchdog adapted by IfxGeth_Eth_adaptRxCoalescing() */
 } IfxGeth_Eth_RxChannel;
 
 /** \brief handle sturcture for DMA tx channel
  */
 typedef struct
 {
-    IfxGeth_TxDmaChannel      channelId;         /**< \brief Tx DMA channel Index */
-    IfxGeth_TxDescrList      *txDescrList;       /**< \brief pointer to TX descriptors RAM */
-    volatile IfxGeth_TxDescr *txDescrPtr;        /**< \brief Pointer to Tx Descriptor (current descriptor) */
-    uint32                    txCount;           /**< \brief Number of frames transmitted */
-    uint16                    txBuf1Size;        /**< \brief configured tx buffer 1 size */
+    IfxGeth_TxDmaChannel      channelId;              /**< \brief Tx DMA channel Index */
+    IfxGeth_TxDescrList      *txDescrList;            /**< \brief pointer to TX descriptors RAM */
+    volatile IfxGeth_TxDescr *txDescrPtr;             /**< \brief Pointer to Tx Descriptor (current descriptor) */
+    uint32                    txCount;                /**< \brief Number of frames transmitted */
+    uint16                    txBuf1Size;             /**< \brief configured tx buffer 1 size */
+    uint16                    numOfDescriptors;       /**< \brief Number of descriptors in the ring */
+    uint16                    interruptFrameCount;    /**< \brief IOC on every Nth frame */
+    uint16                    framesWithoutInterrupt; /**< \brief frames sent since the last one with IOC */
+    uint16                    vlanTag;                /**< \brief VLAN tag of the last context descriptor */
+    boolean                   vlanTagValid;           /**< \brief vlanTag has been set by a context descriptor */
+    boolean                   vlanTagInsertion;       /**< \brief the next frames get vlanTag inserted, see IfxGeth_Eth_setTxVlanTag() */
+    boolean                   txTimestampRequest;     /**< \brief the next frame is timestamped, see IfxGeth_Eth_requestTxTimestamp() */
 } IfxGeth_Eth_TxChannel;
 
 /** \} */
@@ -467,6 +497,7 @@ typedef struct
     uint32                numOfRxChannels;                          /**< \brief Number of Rx Dma channels */
     IfxGeth_Eth_TxChannel txChannel[IFXGETH_NUM_TX_CHANNELS];       /**< \brief Tx Channels handle of selected Channels */
     IfxGeth_Eth_RxChannel rxChannel[IFXGETH_NUM_RX_CHANNELS];       /**< \brief Rx Channels handle of selected Channels */
+    uint32                timestampAddend;                          /**< \brief timestamp addend of the nominal system time frequency */
 } IfxGeth_Eth;
 
 /** \brief Configuration Structure for the Module initialisation
@@ -487,10 +518,27 @@ typedef struct
  */
 typedef struct
 {
-    IfxGeth_TxDmaChannel channelId;          /**< \brief Tx DMA channel Index */
-    uint32               packetLength;       /**< \brief the length of the packet to be transmitted in bytes */
+    IfxGeth_TxDmaChannel      channelId;         /**< \brief Tx DMA channel Index */
+    uint32                    packetLength;      /**< \brief the length of the packet to be transmitted in bytes */
+    IfxGeth_ChecksumInsertion checksumInsertion; /**< \brief checksum insertion done by the MAC for this frame */
 } IfxGeth_Eth_FrameConfig;
 
+/** \brief Segment of a frame for scatter-gather transmission
+ */
+typedef struct
+{
+    const void *buffer;       /**< \brief Start address of the segment data (any byte alignment) */
+    uint16      length;       /**< \brief Length of the segment in bytes */
+} IfxGeth_Eth_TxSegment;
+
+/** \brief System time or timestamp of a packet
+ */
+typedef struct
+{
+    uint32 seconds;          /**< \brief Seconds */
+    uint32 nanoseconds;      /**< \brief Nanoseconds, 0 .. 999999999 */
+} IfxGeth_Eth_Timestamp;
+
 /** \addtogroup IfxLld_Geth_Eth_MAC_Functions
  * \{ */
 
@@ -518,6 +566,50 @@ typedef struct
  */
 IFX_EXTERN void IfxGeth_Eth_configureMacCore(IfxGeth_Eth *geth, IfxGeth_Eth_MacConfig *macConfig);
 
+/** \brief Starts the system time at 0 and enables the timestamping (called by IfxGeth_Eth_configureMacCore() if timestampingEnabled)\n
+ * The addend accumulator overflows at fGETH / 2, every overflow adds the sub-second increment (ns), so the
+ * nominal frequency can be trimmed by IfxGeth_Eth_adjustSystemTimeFrequency() in steps below 1 ppb.
+ * \param geth GETH driver Handle
+ * \param allPackets TRUE: timestamps all received packets, FALSE: only the PTP event messages
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_Eth_initSystemTime(IfxGeth_Eth *geth, boolean allPackets);
+
+/** \brief Reads the system time
+ * \param geth GETH driver Handle
+ * \param time the system time
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_Eth_getSystemTime(IfxGeth_Eth *geth, IfxGeth_Eth_Timestamp *time);
+
+/** \brief Sets the system time
+ * \param geth GETH driver Handle
+ * \param time the new system time
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_Eth_setSystemTime(IfxGeth_Eth *geth, const IfxGeth_Eth_Timestamp *time);
+
+/** \brief Steps the system time by an offset, without stopping it
+ * \param geth GETH driver Handle
+ * \param offset offset in ns, negative values set the time back
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_Eth_adjustSystemTime(IfxGeth_Eth *geth, sint64 offset);
+
+/** \brief Sets the frequency of the system time relative to its nominal frequency
+ * \param geth GETH driver Handle
+ * \param ppb frequency adjustment in parts per billion, positive values make the time run faster
+ * \return None
+ *
+ * \code
+ * // IfxGeth_Eth geth; // assumed to be defined globally
+ *
+ * IfxGeth_Eth_adjustSystemTimeFrequency(&geth, -1500); // the local clock is 1.5 ppm fast
+ * \endcode
+ *
+ */
+IFX_EXTERN void IfxGeth_Eth_adjustSystemTimeFrequency(IfxGeth_Eth *geth, sint32 ppb);
+
 /** \} */
 
 /** \addtogroup IfxLld_Geth_Eth_Module_Functions
@@ -761,10 +853,61 @@ IFX_INLINE volatile IfxGeth_TxDescr *IfxGeth_Eth_getActualTxDescriptor(IfxGeth_E
  */
 IFX_INLINE boolean IfxGeth_Eth_isRxDataAvailable(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId);
 
+/** \brief Checks whether the current RX descriptor is a context descriptor, which holds the timestamp of the
+ * frame before it. Such a descriptor is handed back like the descriptor of an errored frame.
+ * \param geth GETH driver Handle
+ * \param channelId Rx channel Id
+ * \return TRUE: the DMA has written a context descriptor
+ * FALSE: no descriptor or a frame descriptor
+ */
+IFX_INLINE boolean IfxGeth_Eth_isRxContextDescriptor(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId);
+
+/** \brief Checks whether the timestamp of a received frame is still to come: the frame has been timestamped,
+ * but the DMA hasn't written the context descriptor after it yet.
+ * \param geth GETH driver Handle
+ * \param channelId Rx channel Id
+ * \param descr last descriptor of the frame
+ * \return TRUE: the context descriptor is still owned by the DMA
+ * FALSE: the timestamp can be read (or the frame has none)
+ */
+IFX_INLINE boolean IfxGeth_Eth_isRxTimestampPending(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, volatile IfxGeth_RxDescr *descr);
+
+/** \brief Reads the timestamp of a transmitted frame (IfxGeth_Eth_requestTxTimestamp())
+ * \param descr the last descriptor of the frame, released by the DMA
+ * \param timestamp the time the frame has left the MAC
+ * \return TRUE if the descriptor holds a timestamp
+ */
+IFX_INLINE boolean IfxGeth_Eth_getTxTimestamp(volatile IfxGeth_TxDescr *descr, IfxGeth_Eth_Timestamp *timestamp);
+
 /******************************************************************************/
 /*-------------------------Global Function Prototypes-------------------------*/
 /******************************************************************************/
 
+/** \brief Adapts the Rx interrupt watchdog of a channel to the traffic (adaptiveCoalescing)\n
+ * Called after the frames of an Rx interrupt have been handled: the watchdog is halved while the
+ * interrupts bring single frames and doubled up to the configured interruptWatchdogTime when they bring batches.
+ * \param geth GETH driver Handle
+ * \param channelId Rx channel Id
+ * \param numOfFrames number of frames handled for the last interrupt
+ * \return None
+ *
+ * \code
+ * // IfxGeth_Eth geth; // assumed to be defined globally
+ *
+ * uint32 numOfFrames = 0;
+ * while (IfxGeth_Eth_isRxDataAvailable(&geth, IfxGeth_RxDmaChannel_0))
+ * {
+ *     // process the frame
+ *     IfxGeth_Eth_freeReceiveBuffer(&geth, IfxGeth_RxDmaChannel_0);
+ *     numOfFrames++;
+ * }
+ *
+ * IfxGeth_Eth_adaptRxCoalescing(&geth, IfxGeth_RxDmaChannel_0, numOfFrames);
+ * \endcode
+ *
+ */
+IFX_EXTERN void IfxGeth_Eth_adaptRxCoalescing(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, uint32 numOfFrames);
+
 /** \brief Configures the DMA
  * \param geth GETH driver Handle
  * \param dmaConfig Configuration Structure for the DMA initialisation
@@ -828,6 +971,7 @@ IFX_EXTERN void IfxGeth_Eth_initTransmitDescriptors(IfxGeth_Eth *geth, IfxGeth_E
  * IfxGeth_FrameConfig frameConfig;
  * frameConfig.channelId = IfxGeth_TxDmaChannel_0;
  * frameConfig.packetLength = packetLength;
+ * frameConfig.checksumInsertion = IfxGeth_ChecksumInsertion_full;
  *
  * // get free buffer
  * uint8 *pTxBuf = (uint8*) IfxGeth_Eth_waitTransmitBuffer(&geth, IfxGeth_TxDmaChannel_0);
@@ -848,7 +992,8 @@ IFX_EXTERN void IfxGeth_Eth_initTransmitDescriptors(IfxGeth_Eth *geth, IfxGeth_E
  */
 IFX_EXTERN void IfxGeth_Eth_sendFrame(IfxGeth_Eth *geth, IfxGeth_Eth_FrameConfig *config);
 
-/** \brief Transmits a frame from a single channel
+/** \brief Transmits a frame from a single channel\n
+ * The MAC inserts all checksums (IfxGeth_ChecksumInsertion_full), use IfxGeth_Eth_sendFrame() to select another mode.
  * \param geth GETH driver Handle
  * \param packetLength Length of the packet to be transmitted in bytes
  * \param channelId Tx channel Id
@@ -880,6 +1025,72 @@ IFX_EXTERN void IfxGeth_Eth_sendFrame(IfxGeth_Eth *geth, IfxGeth_Eth_FrameConfig
  */
 IFX_EXTERN void IfxGeth_Eth_sendTransmitBuffer(IfxGeth_Eth *geth, uint32 packetLength, IfxGeth_TxDmaChannel channelId);
 
+/** \brief Transmits a frame which is scattered over several buffers, one Tx descriptor per segment\n
+ * The segment buffers are not copied, they have to stay valid until the DMA has released the descriptors (OWN cleared).
+ * The caller has to make sure that numOfSegments descriptors are free, starting at the actual descriptor.
+ * \param geth GETH driver Handle
+ * \param segments segments of the frame, in transmission order
+ * \param numOfSegments number of segments (less than the number of descriptors in the ring)
+ * \param channelId Tx channel Id
+ * \param checksumInsertion checksum insertion done by the MAC for this frame. The TCP/UDP/ICMP checksum fields have to be
+ * zero for IfxGeth_ChecksumInsertion_full, a frame which already carries its checksums is sent with IfxGeth_ChecksumInsertion_disabled
+ * \return None
+ *
+ * \code
+ * // IfxGeth_Eth geth; // assumed to be defined globally
+ *
+ * IfxGeth_Eth_TxSegment segments[2];
+ * segments[0].buffer = &header[0];
+ * segments[0].length = IFXGETH_HEADER_LENGTH;
+ * segments[1].buffer = &payload[0];
+ * segments[1].length = payloadLength;
+ *
+ * IfxGeth_Eth_sendTransmitSegments(&geth, segments, 2, IfxGeth_TxDmaChannel_0, IfxGeth_ChecksumInsertion_full);
+ * \endcode
+ *
+ */
+IFX_EXTERN void IfxGeth_Eth_sendTransmitSegments(IfxGeth_Eth *geth, const IfxGeth_Eth_TxSegment *segments, uint32 numOfSegments, IfxGeth_TxDmaChannel channelId, IfxGeth_ChecksumInsertion checksumInsertion);
+
+/** \brief Selects the VLAN tag the MAC inserts into the frames which are sent next on a channel (MacConfig.vlanTagging).\n
+ * A new tag is passed to the DMA by a context descriptor at the actual descriptor, the frames of the channel keep
+ * it until the next change. The caller has to make sure that this descriptor is free as well.
+ * \param geth GETH driver Handle
+ * \param channelId Tx channel Id
+ * \param insert TRUE: insert vlanTag, FALSE: send the next frames as they are
+ * \param vlanTag tag control information: priority (bits 15..13), DEI (bit 12) and VLAN ID (bits 11..0)
+ * \return number of descriptors used, 1 if a context descriptor has been written, otherwise 0
+ *
+ * \code
+ * // IfxGeth_Eth geth; // assumed to be defined globally
+ *
+ * IfxGeth_Eth_setTxVlanTag(&geth, IfxGeth_TxDmaChannel_0, TRUE, (5 << 13) | 10); // VLAN 10, priority 5
+ * IfxGeth_Eth_sendTransmitSegments(&geth, segments, 2, IfxGeth_TxDmaChannel_0, IfxGeth_ChecksumInsertion_full);
+ * \endcode
+ *
+ */
+IFX_EXTERN uint32 IfxGeth_Eth_setTxVlanTag(IfxGeth_Eth *geth, IfxGeth_TxDmaChannel channelId, boolean insert, uint16 vlanTag);
+
+/** \brief Requests the timestamp of the next frame sent on a channel by IfxGeth_Eth_sendTransmitSegments()\n
+ * The frame raises the Tx interrupt regardless of the coalescing. When the DMA has released its last descriptor,
+ * the timestamp is read by IfxGeth_Eth_getTxTimestamp(); the write-back replaces the buffer address in TDES0/TDES1,
+ * so IfxGeth_Eth_sendFrame() does not support timestamps.
+ * \param geth GETH driver Handle
+ * \param channelId Tx channel Id
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_Eth_requestTxTimestamp(IfxGeth_Eth *geth, IfxGeth_TxDmaChannel channelId);
+
+/** \brief Reads the timestamp of the frame in the current RX descriptor (timestampingEnabled)\n
+ * The DMA writes it into the next descriptor (a context descriptor) right after the frame, which is not waited
+ * for: a frame is read once IfxGeth_Eth_isRxTimestampPending() is FALSE for its last descriptor. The context
+ * descriptor is left to the caller, see IfxGeth_Eth_isRxContextDescriptor().
+ * \param geth GETH driver Handle
+ * \param channelId Rx channel Id
+ * \param timestamp the time the frame has been received
+ * \return TRUE if the frame has been timestamped
+ */
+IFX_EXTERN boolean IfxGeth_Eth_getRxTimestamp(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, IfxGeth_Eth_Timestamp *timestamp);
+
 /** \brief Updates the current Rx descriptor pointer in the handle to next Rx descriptor
  * \param geth GETH driver Handle
  * \param channelId Rx channel Id
@@ -1040,10 +1251,34 @@ IFX_INLINE volatile IfxGeth_RxDescr *IfxGeth_Eth_getBaseRxDescriptor(IfxGeth_Eth
  */
 IFX_INLINE volatile IfxGeth_TxDescr *IfxGeth_Eth_getBaseTxDescriptor(IfxGeth_Eth *geth, IfxGeth_TxDmaChannel channelId);
 
+/** \brief Returns the IOC bit for an Rx descriptor handed to the DMA: set on every interruptFrameCount-th descriptor of the ring
+ * \param geth GETH driver Handle
+ * \param channelId Rx channel Id
+ * \param descr the descriptor
+ * \return 1 if the descriptor raises the Rx interrupt, 0 if it is left to the watchdog
+ */
+IFX_INLINE uint32 IfxGeth_Eth_getRxDescriptorIoc(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, volatile IfxGeth_RxDescr *descr);
+
+/** \brief Counts a frame to be sent and returns the IOC bit for its last descriptor: set on every interruptFrameCount-th frame
+ * and on the frames whose timestamp has been requested
+ * \param geth GETH driver Handle
+ * \param channelId Tx channel Id
+ * \return 1 if the frame raises the Tx interrupt, 0 otherwise
+ */
+IFX_INLINE uint32 IfxGeth_Eth_getTxFrameIoc(IfxGeth_Eth *geth, IfxGeth_TxDmaChannel channelId);
+
 /******************************************************************************/
 /*-------------------------Global Function Prototypes-------------------------*/
 /******************************************************************************/
 
+/** \brief Programs the Rx interrupt watchdog of a channel
+ * \param geth GETH driver Handle
+ * \param channelId Rx channel Id
+ * \param time watchdog in us (rounded up to the timer resolution, limited to 2048 * 255 fGETH cycles), 0: disabled
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_Eth_setRxInterruptWatchdog(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, uint16 time);
+
 /** \brief Free the receive buffer, enabling it for the further reception
  * \param geth GETH driver Handle
  * \param channelId Rx channel Id
@@ -1057,6 +1292,44 @@ IFX_INLINE volatile IfxGeth_TxDescr *IfxGeth_Eth_getBaseTxDescriptor(IfxGeth_Eth
  *
  */
 IFX_EXTERN void IfxGeth_Eth_freeReceiveBuffer(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId);
+
+/** \brief Hands the current receive descriptor back to the DMA with a new buffer\n
+ * Used instead of IfxGeth_Eth_freeReceiveBuffer() when the received buffer is kept by the application (zero-copy).
+ * \param geth GETH driver Handle
+ * \param channelId Rx channel Id
+ * \param buffer new receive buffer (word aligned, at least the configured Rx buffer 1 size)
+ * \return None
+ *
+ * \code
+ * // IfxGeth_Eth geth; // assumed to be defined globally
+ *
+ * IfxGeth_Eth_refillReceiveBuffer(&geth, IfxGeth_RxDmaChannel_0, &spareBuffer[0]);
+ * \endcode
+ *
+ */
+IFX_EXTERN void IfxGeth_Eth_refillReceiveBuffer(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, void *buffer);
+
+/** \brief Writes the Rx descriptor tail pointer, which resumes a DMA that ran out of descriptors\n
+ * IfxGeth_Eth_freeReceiveBuffer() and IfxGeth_Eth_refillReceiveBuffer() only hand the descriptors back (OWN bit),
+ * so the tail pointer is written once after a batch of descriptors has been refilled.
+ * \param geth GETH driver Handle
+ * \param channelId Rx channel Id
+ * \return None
+ *
+ * \code
+ * // IfxGeth_Eth geth; // assumed to be defined globally
+ *
+ * while (IfxGeth_Eth_isRxDataAvailable(&geth, IfxGeth_RxDmaChannel_0))
+ * {
+ *     // process the frame
+ *     IfxGeth_Eth_freeReceiveBuffer(&geth, IfxGeth_RxDmaChannel_0);
+ * }
+ *
+ * IfxGeth_Eth_updateRxTailPointer(&geth, IfxGeth_RxDmaChannel_0);
+ * \endcode
+ *
+ */
+IFX_EXTERN void IfxGeth_Eth_updateRxTailPointer(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId);
 /** \addtogroup IfxLld_Geth_Eth_Variables
  * \{ */
 
@@ -1102,12 +1375,67 @@ IFX_INLINE volatile IfxGeth_TxDescr *IfxGeth_Eth_getBaseTxDescriptor(IfxGeth_Eth
 }
 
 
+IFX_INLINE uint32 IfxGeth_Eth_getRxDescriptorIoc(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, volatile IfxGeth_RxDescr *descr)
+{
+    uint32 frameCount = geth->rxChannel[channelId].interruptFrameCount;
+    uint32 index      = (uint32)(descr - IfxGeth_Eth_getBaseRxDescriptor(geth, channelId));
+
+    return ((frameCount <= 1) || (((index + 1) % frameCount) == 0)) ? 1 : 0;
+}
+
+
+IFX_INLINE uint32 IfxGeth_Eth_getTxFrameIoc(IfxGeth_Eth *geth, IfxGeth_TxDmaChannel channelId)
+{
+    IfxGeth_Eth_TxChannel *txChannel = &geth->txChannel[channelId];
+
+    txChannel->framesWithoutInterrupt++;
+
+    if ((txChannel->framesWithoutInterrupt < txChannel->interruptFrameCount) && (txChannel->txTimestampRequest == FALSE))
+    {
+        return 0;
+    }
+
+    txChannel->framesWithoutInterrupt = 0;
+    return 1;
+}
+
+
 IFX_INLINE boolean IfxGeth_Eth_isRxDataAvailable(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId)
 {
     return IfxGeth_Eth_getActualRxDescriptor(geth, channelId)->RDES3.R.OWN == 0;
 }
 
 
+IFX_INLINE boolean IfxGeth_Eth_isRxContextDescriptor(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId)
+{
+    volatile IfxGeth_RxDescr *descr = IfxGeth_Eth_getActualRxDescriptor(geth, channelId);
+
+    return (descr->RDES3.C.OWN == 0) && (descr->RDES3.C.CTXT != 0);
+}
+
+
+IFX_INLINE boolean IfxGeth_Eth_isRxTimestampPending(IfxGeth_Eth *geth, IfxGeth_RxDmaChannel channelId, volatile IfxGeth_RxDescr *descr)
+{
+    volatile IfxGeth_RxDescr *base = IfxGeth_Eth_getBaseRxDescriptor(geth, channelId);
+    volatile IfxGeth_RxDescr *next = (descr == &base[geth->rxChannel[channelId].numOfDescriptors - 1]) ? base : &descr[1];
+
+    return (descr->RDES3.W.RS1V != 0) && (descr->RDES1.W.TSA != 0) && (next->RDES3.C.OWN != 0);
+}
+
+
+IFX_INLINE boolean IfxGeth_Eth_getTxTimestamp(volatile IfxGeth_TxDescr *descr, IfxGeth_Eth_Timestamp *timestamp)
+{
+    if ((descr->TDES3.W.OWN != 0) || (descr->TDES3.W.LD == 0) || (descr->TDES3.W.TTSS == 0))
+    {
+        return FALSE;
+    }
+
+    timestamp->nanoseconds = descr->TDES0.W.TTSL;
+    timestamp->seconds     = descr->TDES1.W.TTSH;
+    return TRUE;
+}
+
+
 IFX_INLINE void *IfxGeth_Eth_waitTransmitBuffer(IfxGeth_Eth *geth, IfxGeth_TxDmaChannel channelId)
 {
     void *tx;
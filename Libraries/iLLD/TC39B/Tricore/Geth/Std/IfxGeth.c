@@ -29,6 +29,18 @@
 
 #include "IfxGeth.h"
 
+/******************************************************************************/
+/*------------------------Private Function Prototypes-------------------------*/
+/******************************************************************************/
+
+/** \brief Writes a VLAN tag filter by the indirect access of MAC_VLAN_TAG_CTRL
+ * \param gethSFR Pointer to GETH register base address
+ * \param index Filter index
+ * \param data value of MAC_VLAN_TAG_FILTER(index)
+ * \return None
+ */
+static void IfxGeth_mac_writeVlanFilter(Ifx_GETH *gethSFR, uint32 index, uint32 data);
+
 /******************************************************************************/
 /*-------------------------Function Implementations---------------------------*/
 /******************************************************************************/
@@ -105,6 +117,35 @@ void IfxGeth_mac_setMacAddress(Ifx_GETH *gethSFR, uint8 *macAddress)
 }
 
 
+void IfxGeth_mac_setAddressFilter(Ifx_GETH *gethSFR, uint32 index, const uint8 *macAddress, IfxGeth_RxDmaChannel channel)
+{
+    /* MAC_ADDRESS_HIGHn and MAC_ADDRESS_LOWn follow each other from MAC_ADDRESS_HIGH1 on */
+    volatile Ifx_UReg_32Bit *addressHigh = &gethSFR->MAC_ADDRESS_HIGH1.U + (2 * (index - 1));
+
+    /* the filter takes the new address when the low register is written */
+    addressHigh[0] = 0
+                     | ((uint32)macAddress[4] << 0U)
+                     | ((uint32)macAddress[5] << 8U)
+                     | ((uint32)channel << 16U)
+                     | 0x80000000U;
+
+    addressHigh[1] = 0
+                     | ((uint32)macAddress[0] << 0U)
+                     | ((uint32)macAddress[1] << 8U)
+                     | ((uint32)macAddress[2] << 16U)
+                     | ((uint32)macAddress[3] << 24U);
+}
+
+
+void IfxGeth_mac_disableAddressFilter(Ifx_GETH *gethSFR, uint32 index)
+{
+    volatile Ifx_UReg_32Bit *addressHigh = &gethSFR->MAC_ADDRESS_HIGH1.U + (2 * (index - 1));
+
+    addressHigh[0] = 0;
+    addressHigh[1] = 0xFFFFFFFFU;
+}
+
+
 void IfxGeth_mtl_clearAllInterruptFlags(Ifx_GETH *gethSFR, IfxGeth_MtlQueue queueId)
 {
     uint32 value = (1 << IfxGeth_MtlInterruptFlag_txQueueUnderflow) | (1 << IfxGeth_MtlInterruptFlag_averageBitsPerSlot) | (1 << IfxGeth_MtlInterruptFlag_rxQueueOverflow);
@@ -342,6 +383,55 @@ void IfxGeth_mtl_setTxQueueSize(Ifx_GETH *gethSFR, IfxGeth_TxMtlQueue queueId, I
 }
 
 
+void IfxGeth_mtl_setTxQueueWeight(Ifx_GETH *gethSFR, IfxGeth_TxMtlQueue queueId, uint32 weight)
+{
+    switch (queueId)
+    {
+    case IfxGeth_TxMtlQueue_0:
+        gethSFR->MTL_TXQ0.QUANTUM_WEIGHT.B.ISCQW = weight;
+        break;
+    case IfxGeth_TxMtlQueue_1:
+        gethSFR->MTL_TXQ1.QUANTUM_WEIGHT.B.ISCQW = weight;
+        break;
+    case IfxGeth_TxMtlQueue_2:
+        gethSFR->MTL_TXQ2.QUANTUM_WEIGHT.B.ISCQW = weight;
+        break;
+    case IfxGeth_TxMtlQueue_3:
+        gethSFR->MTL_TXQ3.QUANTUM_WEIGHT.B.ISCQW = weight;
+        break;
+    }
+}
+
+
+void IfxGeth_mtl_setTxQueueCreditBasedShaper(Ifx_GETH *gethSFR, IfxGeth_TxMtlQueue queueId, uint32 idleSlope, uint32 sendSlope, uint32 hiCredit, sint32 loCredit)
+{
+    Ifx_GETH_MTL_TXQ *txQueue;
+
+    switch (queueId)
+    {
+    case IfxGeth_TxMtlQueue_1:
+        txQueue = &gethSFR->MTL_TXQ1;
+        break;
+    case IfxGeth_TxMtlQueue_2:
+        txQueue = &gethSFR->MTL_TXQ2;
+        break;
+    case IfxGeth_TxMtlQueue_3:
+        txQueue = &gethSFR->MTL_TXQ3;
+        break;
+    default:
+        return; /* queue 0 has no shaper */
+    }
+
+    txQueue->ETS_CONTROL.B.AVALG     = 1;   /* credit-based shaper */
+    txQueue->ETS_CONTROL.B.CC        = 0;   /* a positive credit is cleared while the queue is empty */
+    txQueue->QUANTUM_WEIGHT.B.ISCQW  = idleSlope;
+    txQueue->SENDSLOPECREDIT.B.SSC   = sendSlope;
+    txQueue->HICREDIT.B.HC           = hiCredit;
+    txQueue->LOCREDIT.B.LC           = (uint32)loCredit & 0x1FFFFFFFU; /* two's complement, 29 bits */
+    txQueue->OPERATION_MODE.B.TXQEN  = 1;   /* enabled in AV mode */
+}
+
+
 void IfxGeth_mtl_setTxStoreAndForward(Ifx_GETH *gethSFR, IfxGeth_TxMtlQueue queueId, boolean enabled)
 {
     switch (queueId)
@@ -561,3 +651,130 @@ boolean IfxGeth_mac_readQueueVlanTag(Ifx_GETH *gethSFR, IfxGeth_MtlQueue queueId
 
     return TRUE;
 }
+
+
+void IfxGeth_mac_setVlanFilter(Ifx_GETH *gethSFR, uint32 index, uint16 vlanId)
+{
+    Ifx_GETH_MAC_VLAN_TAG_FILTER filter;
+
+    filter.U       = 0;
+    filter.B.VID   = vlanId & 0x0FFFU;
+    filter.B.VEN   = 1; /* enabled */
+    filter.B.ETV   = 1; /* 12 bit VLAN ID comparison */
+
+    IfxGeth_mac_writeVlanFilter(gethSFR, index, filter.U);
+}
+
+
+void IfxGeth_mac_disableVlanFilter(Ifx_GETH *gethSFR, uint32 index)
+{
+    IfxGeth_mac_writeVlanFilter(gethSFR, index, 0);
+}
+
+
+void IfxGeth_mac_enableTimestamping(Ifx_GETH *gethSFR, boolean allPackets)
+{
+    Ifx_GETH_MAC_TIMESTAMP_CONTROL timestampControl;
+
+    timestampControl.U               = 0;
+    timestampControl.B.TSENA         = 1;
+    timestampControl.B.TSCFUPDT      = 1; /* fine update, the addend sets the frequency */
+    timestampControl.B.TSCTRLSSR     = 1; /* nanoseconds roll over at 999999999 */
+    timestampControl.B.TSENALL       = ((allPackets == 1) ? 1 : 0);
+    timestampControl.B.TSVER2ENA     = 1;
+    timestampControl.B.TSIPENA       = 1;
+    timestampControl.B.TSIPV4ENA     = 1;
+    timestampControl.B.TSEVNTENA     = 1;
+    timestampControl.B.SNAPTYPSEL    = 1; /* Sync, Pdelay_Req, Pdelay_Resp */
+    gethSFR->MAC_TIMESTAMP_CONTROL.U = timestampControl.U;
+}
+
+
+void IfxGeth_mac_setTimestampAddend(Ifx_GETH *gethSFR, uint32 addend)
+{
+    // Wait until a previous update is finished
+    while (gethSFR->MAC_TIMESTAMP_CONTROL.B.TSADDREG)
+    {}
+
+    gethSFR->MAC_TIMESTAMP_ADDEND.U           = addend;
+    gethSFR->MAC_TIMESTAMP_CONTROL.B.TSADDREG = 1;
+}
+
+
+void IfxGeth_mac_initSystemTime(Ifx_GETH *gethSFR, uint32 seconds, uint32 nanoseconds)
+{
+    // Wait until a previous update is finished
+    while (gethSFR->MAC_TIMESTAMP_CONTROL.B.TSINIT || gethSFR->MAC_TIMESTAMP_CONTROL.B.TSUPDT)
+    {}
+
+    gethSFR->MAC_SYSTEM_TIME_SECONDS_UPDATE.U     = seconds;
+    gethSFR->MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.U = nanoseconds;
+    gethSFR->MAC_TIMESTAMP_CONTROL.B.TSINIT       = 1;
+}
+
+
+void IfxGeth_mac_updateSystemTime(Ifx_GETH *gethSFR, boolean subtract, uint32 seconds, uint32 nanoseconds)
+{
+    Ifx_GETH_MAC_SYSTEM_TIME_NANOSECONDS_UPDATE nanosecondsUpdate;
+
+    // Wait until a previous update is finished
+    while (gethSFR->MAC_TIMESTAMP_CONTROL.B.TSINIT || gethSFR->MAC_TIMESTAMP_CONTROL.B.TSUPDT)
+    {}
+
+    nanosecondsUpdate.U = 0;
+
+    if (subtract == 1)
+    {
+        /* the seconds are subtracted as their two's complement, with digital rollover
+         * the nanoseconds as 10^9 - value (10^9 for 0) */
+        seconds                    = 0U - seconds;
+        nanosecondsUpdate.B.TSSS   = 1000000000U - nanoseconds;
+        nanosecondsUpdate.B.ADDSUB = 1;
+    }
+    else
+    {
+        nanosecondsUpdate.B.TSSS = nanoseconds;
+    }
+
+    gethSFR->MAC_SYSTEM_TIME_SECONDS_UPDATE.U     = seconds;
+    gethSFR->MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.U = nanosecondsUpdate.U;
+    gethSFR->MAC_TIMESTAMP_CONTROL.B.TSUPDT       = 1;
+}
+
+
+void IfxGeth_mac_getSystemTime(Ifx_GETH *gethSFR, uint32 *seconds, uint32 *nanoseconds)
+{
+    uint32 s, ns;
+
+    /* read the seconds again if the nanoseconds rolled over in between */
+    do
+    {
+        s  = gethSFR->MAC_SYSTEM_TIME_SECONDS.U;
+        ns = gethSFR->MAC_SYSTEM_TIME_NANOSECONDS.B.TSSS;
+    } while (s != gethSFR->MAC_SYSTEM_TIME_SECONDS.U);
+
+    *seconds     = s;
+    *nanoseconds = ns;
+}
+
+
+static void IfxGeth_mac_writeVlanFilter(Ifx_GETH *gethSFR, uint32 index, uint32 data)
+{
+    Ifx_GETH_MAC_VLAN_TAG_CTRL vlanTagCtrl;
+
+    // Wait until a previous operation is finished
+    while (gethSFR->MAC_VLAN_TAG_CTRL.B.OB)
+    {}
+
+    gethSFR->MAC_VLAN_TAG_DATA.U = data;
+
+    vlanTagCtrl.U                = gethSFR->MAC_VLAN_TAG_CTRL.U;
+    vlanTagCtrl.B.OFS            = index;
+    vlanTagCtrl.B.CT             = 0; /* write */
+    vlanTagCtrl.B.OB             = 1; /* start */
+    gethSFR->MAC_VLAN_TAG_CTRL.U = vlanTagCtrl.U;
+
+    // Wait until operation is finished
+    while (gethSFR->MAC_VLAN_TAG_CTRL.B.OB)
+    {}
+}
@@ -79,6 +79,17 @@
 
 /** \addtogroup IfxLld_Geth_Std_Enumerations
  * \{ */
+/** \brief Checksum insertion control of a transmitted frame\n
+ * Definition in TDES3.CIC (read format)
+ */
+typedef enum
+{
+    IfxGeth_ChecksumInsertion_disabled           = 0, /**< \brief no checksum insertion, the frame is sent as it is */
+    IfxGeth_ChecksumInsertion_ipHeader           = 1, /**< \brief only the IPv4 header checksum is inserted */
+    IfxGeth_ChecksumInsertion_ipHeaderAndPayload = 2, /**< \brief IPv4 header and TCP/UDP/ICMP checksum, the checksum field has to hold the pseudo-header checksum */
+    IfxGeth_ChecksumInsertion_full               = 3  /**< \brief IPv4 header and TCP/UDP/ICMP checksum including the pseudo-header */
+} IfxGeth_ChecksumInsertion;
+
 /** \brief Programmable burst length of DMA channels\n
  * Definition in DMA_CHi_TX_CONTROL.B.PBL and DMA_CHi_RX_CONTROL.B.PBL
  */
@@ -742,6 +753,14 @@ IFX_INLINE void IfxGeth_mac_setAllMulticastPassing(Ifx_GETH *gethSFR, boolean en
  */
 IFX_INLINE void IfxGeth_mac_setCrcChecking(Ifx_GETH *gethSFR, boolean enabled);
 
+/** \brief Enables / Disables the Rx Checksum Offload engine (IPv4 header and TCP/UDP/ICMP checksums)
+ * The result is reported in RDES1 of the received packets.
+ * \param gethSFR Pointer to GETH register base address
+ * \param enabled Rx Checksum Offload enable / disable
+ * \return None
+ */
+IFX_INLINE void IfxGeth_mac_setRxChecksumOffload(Ifx_GETH *gethSFR, boolean enabled);
+
 /** \brief Enables/Disables the Automatic Pad or CRC Stripping for frames less than 1536 bytes and \n
  *     CRC stripping for Type packets
  * \param gethSFR Pointer to GETH register base address
@@ -772,6 +791,14 @@ IFX_INLINE void IfxGeth_mac_setPreambleLength(Ifx_GETH *gethSFR, IfxGeth_Preambl
  */
 IFX_INLINE void IfxGeth_mac_setPromiscuousMode(Ifx_GETH *gethSFR, boolean enabled);
 
+/** \brief Enables / Disables the interrupt on a change of the RGMII link status (MAC_PHYIF_CONTROL_STATUS),
+ * reading MAC_PHYIF_CONTROL_STATUS clears it. The interrupt is signalled on service request SR0.
+ * \param gethSFR Pointer to GETH register base address
+ * \param enabled link status interrupt enable / disable
+ * \return None
+ */
+IFX_INLINE void IfxGeth_mac_setRgmiiLinkInterrupt(Ifx_GETH *gethSFR, boolean enabled);
+
 /** \brief Set the priorities for Rx queues for mapping tagged packets
  * \param gethSFR Pointer to GETH register base address
  * \param channel Rx DMA channel
@@ -780,6 +807,32 @@ IFX_INLINE void IfxGeth_mac_setPromiscuousMode(Ifx_GETH *gethSFR, boolean enable
  */
 IFX_INLINE void IfxGeth_mac_setVlanPriorityQueueRouting(Ifx_GETH *gethSFR, IfxGeth_RxDmaChannel channel, uint8 priorities);
 
+/** \brief Sets the Rx queue for untagged packets
+ * \param gethSFR Pointer to GETH register base address
+ * \param queueId Rx Queue Index
+ * \return None
+ */
+IFX_INLINE void IfxGeth_mac_setUntaggedPacketQueue(Ifx_GETH *gethSFR, IfxGeth_RxMtlQueue queueId);
+
+/** \brief Enables the routing of multicast and broadcast packets to the selected Rx queue
+ * \param gethSFR Pointer to GETH register base address
+ * \param queueId Rx Queue Index
+ * \return None
+ */
+IFX_INLINE void IfxGeth_mac_enableMulticastBroadcastQueue(Ifx_GETH *gethSFR, IfxGeth_RxMtlQueue queueId);
+
+/** \brief Disables the routing of multicast and broadcast packets to a separate Rx queue
+ * \param gethSFR Pointer to GETH register base address
+ * \return None
+ */
+IFX_INLINE void IfxGeth_mac_disableMulticastBroadcastQueue(Ifx_GETH *gethSFR);
+
+/** \brief Returns the number of additional MAC address filters (MAC Address 1..n)
+ * \param gethSFR Pointer to GETH register base address
+ * \return Number of address filters besides MAC Address 0
+ */
+IFX_INLINE uint32 IfxGeth_mac_getNumOfAddressFilters(Ifx_GETH *gethSFR);
+
 /** \brief Enable / Disable Queue Insertion
  * \param gethSFR Pointer to GETH register base address
  * \param enable config parameter TRUE: enabled/ FALSE: disabled
@@ -787,6 +840,44 @@ IFX_INLINE void IfxGeth_mac_setVlanPriorityQueueRouting(Ifx_GETH *gethSFR, IfxGe
  */
 IFX_INLINE void IfxGeth_mac_setQueueVlanInsertion(Ifx_GETH *gethSFR, boolean enable);
 
+/** \brief Enables / Disables the VLAN tag insertion controlled by the Tx descriptors (VLTI): a frame gets the
+ * tag of the last context descriptor of its channel as TDES2.VTIR of its first descriptor requests it.
+ * The tag insertion by MAC_VLAN_INCL itself is switched off.
+ * \param gethSFR Pointer to GETH register base address
+ * \param enable config parameter TRUE: enabled/ FALSE: disabled
+ * \return None
+ */
+IFX_INLINE void IfxGeth_mac_setDescriptorVlanInsertion(Ifx_GETH *gethSFR, boolean enable);
+
+/** \brief Enables / Disables the stripping of the VLAN tag of received packets, the stripped tag is
+ * reported in RDES0 (OVT, valid with RDES3.RS0V)
+ * \param gethSFR Pointer to GETH register base address
+ * \param enabled VLAN tag stripping enable / disable
+ * \return None
+ */
+IFX_INLINE void IfxGeth_mac_setRxVlanStripping(Ifx_GETH *gethSFR, boolean enabled);
+
+/** \brief Enables / Disables the VLAN tag filter: tagged packets pass only if their VLAN ID matches one of
+ * the filters set by IfxGeth_mac_setVlanFilter(), untagged packets are not affected
+ * \param gethSFR Pointer to GETH register base address
+ * \param enabled VLAN tag filter enable / disable
+ * \return None
+ */
+IFX_INLINE void IfxGeth_mac_setVlanFiltering(Ifx_GETH *gethSFR, boolean enabled);
+
+/** \brief Returns the number of VLAN tag filters
+ * \param gethSFR Pointer to GETH register base address
+ * \return Number of VLAN tag filters, 0 if the VLAN ID can't be filtered
+ */
+IFX_INLINE uint32 IfxGeth_mac_getNumOfVlanFilters(Ifx_GETH *gethSFR);
+
+/** \brief Sets the sub-second increment, the value added to the system time on every overflow of the addend accumulator
+ * \param gethSFR Pointer to GETH register base address
+ * \param increment Increment in ns (digital rollover)
+ * \return None
+ */
+IFX_INLINE void IfxGeth_mac_setSubSecondIncrement(Ifx_GETH *gethSFR, uint8 increment);
+
 /******************************************************************************/
 /*-------------------------Global Function Prototypes-------------------------*/
 /******************************************************************************/
@@ -805,6 +896,22 @@ IFX_EXTERN void IfxGeth_mac_setLineSpeed(Ifx_GETH *gethSFR, IfxGeth_LineSpeed sp
  */
 IFX_EXTERN void IfxGeth_mac_setMacAddress(Ifx_GETH *gethSFR, uint8 *macAddress);
 
+/** \brief Sets and enables an additional destination address filter (perfect filter)
+ * \param gethSFR Pointer to GETH register base address
+ * \param index Filter index, 1 .. IfxGeth_mac_getNumOfAddressFilters()
+ * \param macAddress MAC Address to be passed
+ * \param channel Rx DMA channel of the matching packets (used with DA based DMA channel selection)
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mac_setAddressFilter(Ifx_GETH *gethSFR, uint32 index, const uint8 *macAddress, IfxGeth_RxDmaChannel channel);
+
+/** \brief Disables an additional destination address filter
+ * \param gethSFR Pointer to GETH register base address
+ * \param index Filter index, 1 .. IfxGeth_mac_getNumOfAddressFilters()
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mac_disableAddressFilter(Ifx_GETH *gethSFR, uint32 index);
+
 /** \brief Writes to Queue Vlan tag
  * \param gethSFR Pointer to GETH register base address
  * \param queueId Queue Index
@@ -821,6 +928,61 @@ IFX_EXTERN boolean IfxGeth_mac_writeQueueVlanTag(Ifx_GETH *gethSFR, IfxGeth_MtlQ
  */
 IFX_EXTERN boolean IfxGeth_mac_readQueueVlanTag(Ifx_GETH *gethSFR, IfxGeth_MtlQueue queueId, uint16 *const vLanTag);
 
+/** \brief Sets and enables a VLAN tag filter, the 12 bit VLAN ID of the packets is compared
+ * \param gethSFR Pointer to GETH register base address
+ * \param index Filter index, 0 .. IfxGeth_mac_getNumOfVlanFilters() - 1
+ * \param vlanId VLAN ID to be passed
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mac_setVlanFilter(Ifx_GETH *gethSFR, uint32 index, uint16 vlanId);
+
+/** \brief Disables a VLAN tag filter
+ * \param gethSFR Pointer to GETH register base address
+ * \param index Filter index, 0 .. IfxGeth_mac_getNumOfVlanFilters() - 1
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mac_disableVlanFilter(Ifx_GETH *gethSFR, uint32 index);
+
+/** \brief Enables the system time (fine update, digital rollover) and the timestamping of PTP v2 packets
+ * (over Ethernet and over IPv4-UDP)
+ * \param gethSFR Pointer to GETH register base address
+ * \param allPackets TRUE: timestamps all received packets, FALSE: only the PTP event messages of a peer-to-peer clock
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mac_enableTimestamping(Ifx_GETH *gethSFR, boolean allPackets);
+
+/** \brief Sets the timestamp addend, the frequency of the system time update in fine update mode
+ * \param gethSFR Pointer to GETH register base address
+ * \param addend Addend, the update frequency is fGETH * addend / 2^32
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mac_setTimestampAddend(Ifx_GETH *gethSFR, uint32 addend);
+
+/** \brief Initializes the system time
+ * \param gethSFR Pointer to GETH register base address
+ * \param seconds Seconds
+ * \param nanoseconds Nanoseconds, 0 .. 999999999
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mac_initSystemTime(Ifx_GETH *gethSFR, uint32 seconds, uint32 nanoseconds);
+
+/** \brief Adds an offset to / subtracts an offset from the system time
+ * \param gethSFR Pointer to GETH register base address
+ * \param subtract TRUE: the offset is subtracted, FALSE: the offset is added
+ * \param seconds Seconds of the offset
+ * \param nanoseconds Nanoseconds of the offset, 0 .. 999999999
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mac_updateSystemTime(Ifx_GETH *gethSFR, boolean subtract, uint32 seconds, uint32 nanoseconds);
+
+/** \brief Reads the system time consistently
+ * \param gethSFR Pointer to GETH register base address
+ * \param seconds Seconds
+ * \param nanoseconds Nanoseconds
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mac_getSystemTime(Ifx_GETH *gethSFR, uint32 *seconds, uint32 *nanoseconds);
+
 /** \} */
 
 /** \addtogroup IfxLld_Geth_Std_Module_Functions
@@ -932,6 +1094,18 @@ IFX_INLINE void IfxGeth_mtl_setRxQueueForDaBasedDmaChannel(Ifx_GETH *gethSFR, If
  */
 IFX_INLINE void IfxGeth_mtl_setTxSchedulingAlgorithm(Ifx_GETH *gethSFR, IfxGeth_TxSchedulingAlgorithm schedulingAlgorithm);
 
+/** \brief Returns the size of the receive FIFO, which is shared by the Rx queues
+ * \param gethSFR Pointer to GETH register base address
+ * \return Rx FIFO size in bytes
+ */
+IFX_INLINE uint32 IfxGeth_mtl_getRxFifoSize(Ifx_GETH *gethSFR);
+
+/** \brief Returns the size of the transmit FIFO, which is shared by the Tx queues
+ * \param gethSFR Pointer to GETH register base address
+ * \return Tx FIFO size in bytes
+ */
+IFX_INLINE uint32 IfxGeth_mtl_getTxFifoSize(Ifx_GETH *gethSFR);
+
 /** \brief Enable and set queue ID to route packets failing unicast filter
  * \param gethSFR Pointer to GETH register base address
  * \param queueId Rx MTL Queue ID
@@ -1062,6 +1236,27 @@ IFX_EXTERN void IfxGeth_mtl_setRxStoreAndForward(Ifx_GETH *gethSFR, IfxGeth_RxMt
  */
 IFX_EXTERN void IfxGeth_mtl_setTxQueueSize(Ifx_GETH *gethSFR, IfxGeth_TxMtlQueue queueId, IfxGeth_QueueSize queueSize);
 
+/** \brief Sets the weight of the selected TX Queue for the WRR scheduling
+ * \param gethSFR Pointer to GETH register base address
+ * \param queueId Tx Queue Index
+ * \param weight Tx Queue weight
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mtl_setTxQueueWeight(Ifx_GETH *gethSFR, IfxGeth_TxMtlQueue queueId, uint32 weight);
+
+/** \brief Sets the credit-based shaper (IEEE 802.1Qav) of the selected TX Queue and enables the queue in AV mode\n
+ * Queue 0 has no shaper. The slopes are given in bits per cycle of the MII (4 bits at 10 and 100 Mbps) or GMII
+ * (8 bits at 1000 Mbps) scaled by 1024, the credits in bits scaled by 1024.
+ * \param gethSFR Pointer to GETH register base address
+ * \param queueId Tx Queue Index (1..3)
+ * \param idleSlope idleSlopeCredit, credit gained per cycle while the queue waits
+ * \param sendSlope sendSlopeCredit, credit spent per cycle while the queue sends (absolute value)
+ * \param hiCredit upper limit of the credit
+ * \param loCredit lower limit of the credit (negative)
+ * \return None
+ */
+IFX_EXTERN void IfxGeth_mtl_setTxQueueCreditBasedShaper(Ifx_GETH *gethSFR, IfxGeth_TxMtlQueue queueId, uint32 idleSlope, uint32 sendSlope, uint32 hiCredit, sint32 loCredit);
+
 /** \brief Sets the Transmit Store And Forward for teh selected TX Queue
  * \param gethSFR Pointer to GETH register base address
  * \param queueId Tx Queue Index
@@ -1191,6 +1386,16 @@ IFX_INLINE void IfxGeth_dma_setRxDescriptorTailPointer(Ifx_GETH *gethSFR, IfxGet
  */
 IFX_INLINE void IfxGeth_dma_setRxMaxBurstLength(Ifx_GETH *gethSFR, IfxGeth_RxDmaChannel channel, IfxGeth_DmaBurstLength length);
 
+/** \brief sets the Rx interrupt watchdog timer of selected Rx channel of DMA\n
+ * A frame received into a descriptor without IOC raises the Rx interrupt when the watchdog expires.
+ * \param gethSFR Pointer to GETH register base address
+ * \param channel Rx channel Id
+ * \param count watchdog count, 0 disables the watchdog
+ * \param countUnit unit of count: 0..3 for 256, 512, 1024 or 2048 fGETH clock cycles
+ * \return None
+ */
+IFX_INLINE void IfxGeth_dma_setRxInterruptWatchdogTimer(Ifx_GETH *gethSFR, IfxGeth_RxDmaChannel channel, uint8 count, uint8 countUnit);
+
 /** \brief sets the base address of the first descriptor in the Transmit descriptor list
  * \param gethSFR Pointer to GETH register base address
  * \param channel Tx channel Id
@@ -1401,6 +1606,17 @@ IFX_INLINE void IfxGeth_dma_setRxMaxBurstLength(Ifx_GETH *gethSFR, IfxGeth_RxDma
 }
 
 
+IFX_INLINE void IfxGeth_dma_setRxInterruptWatchdogTimer(Ifx_GETH *gethSFR, IfxGeth_RxDmaChannel channel, uint8 count, uint8 countUnit)
+{
+    Ifx_GETH_DMA_CH_RX_INTERRUPT_WATCHDOG_TIMER watchdog;
+
+    watchdog.U      = 0;
+    watchdog.B.RWT  = count;
+    watchdog.B.RWTU = countUnit;
+    gethSFR->DMA_CH[channel].RX_INTERRUPT_WATCHDOG_TIMER.U = watchdog.U;
+}
+
+
 IFX_INLINE void IfxGeth_dma_setTxDescriptorListAddress(Ifx_GETH *gethSFR, IfxGeth_TxDmaChannel channel, uint32 address)
 {
     gethSFR->DMA_CH[channel].TXDESC_LIST_ADDRESS.U = address;
@@ -1488,6 +1704,12 @@ IFX_INLINE void IfxGeth_mac_setCrcChecking(Ifx_GETH *gethSFR, boolean enabled)
 }
 
 
+IFX_INLINE void IfxGeth_mac_setRxChecksumOffload(Ifx_GETH *gethSFR, boolean enabled)
+{
+    gethSFR->MAC_CONFIGURATION.B.IPC = ((enabled == 1) ? 1 : 0);
+}
+
+
 IFX_INLINE void IfxGeth_mac_setCrcStripping(Ifx_GETH *gethSFR, boolean acsEnabled, boolean cstEnabled)
 {
     gethSFR->MAC_CONFIGURATION.B.ACS = ((acsEnabled == 1) ? 1 : 0);
@@ -1519,6 +1741,12 @@ IFX_INLINE void IfxGeth_mac_setPromiscuousMode(Ifx_GETH *gethSFR, boolean enable
 }
 
 
+IFX_INLINE void IfxGeth_mac_setRgmiiLinkInterrupt(Ifx_GETH *gethSFR, boolean enabled)
+{
+    gethSFR->MAC_INTERRUPT_ENABLE.B.RGSMIIIE = ((enabled == 1) ? 1 : 0);
+}
+
+
 IFX_INLINE void IfxGeth_mtl_enableRxQueue(Ifx_GETH *gethSFR, IfxGeth_RxMtlQueue queueId)
 {
     gethSFR->MAC_RXQ_CTRL0.U |= (2 << (queueId * 2));
@@ -1549,6 +1777,18 @@ IFX_INLINE void IfxGeth_mtl_setTxSchedulingAlgorithm(Ifx_GETH *gethSFR, IfxGeth_
 }
 
 
+IFX_INLINE uint32 IfxGeth_mtl_getRxFifoSize(Ifx_GETH *gethSFR)
+{
+    return 128U << gethSFR->MAC_HW_FEATURE1.B.RXFIFOSIZE;
+}
+
+
+IFX_INLINE uint32 IfxGeth_mtl_getTxFifoSize(Ifx_GETH *gethSFR)
+{
+    return 128U << gethSFR->MAC_HW_FEATURE1.B.TXFIFOSIZE;
+}
+
+
 IFX_INLINE void IfxGeth_setPhyInterfaceMode(Ifx_GETH *gethSFR, IfxGeth_PhyInterfaceMode mode)
 {
     gethSFR->GPCTL.B.EPR = mode;
@@ -1561,6 +1801,31 @@ IFX_INLINE void IfxGeth_mac_setVlanPriorityQueueRouting(Ifx_GETH *gethSFR, IfxGe
 }
 
 
+IFX_INLINE void IfxGeth_mac_setUntaggedPacketQueue(Ifx_GETH *gethSFR, IfxGeth_RxMtlQueue queueId)
+{
+    gethSFR->MAC_RXQ_CTRL1.B.UPQ = queueId;
+}
+
+
+IFX_INLINE void IfxGeth_mac_enableMulticastBroadcastQueue(Ifx_GETH *gethSFR, IfxGeth_RxMtlQueue queueId)
+{
+    gethSFR->MAC_RXQ_CTRL1.B.MCBCQ   = queueId;
+    gethSFR->MAC_RXQ_CTRL1.B.MCBCQEN = TRUE;
+}
+
+
+IFX_INLINE void IfxGeth_mac_disableMulticastBroadcastQueue(Ifx_GETH *gethSFR)
+{
+    gethSFR->MAC_RXQ_CTRL1.B.MCBCQEN = FALSE;
+}
+
+
+IFX_INLINE uint32 IfxGeth_mac_getNumOfAddressFilters(Ifx_GETH *gethSFR)
+{
+    return gethSFR->MAC_HW_FEATURE0.B.ADDMACADRSEL;
+}
+
+
 IFX_INLINE void IfxGeth_mtl_enableUnicastFilterFailQueuing(Ifx_GETH *gethSFR, IfxGeth_RxMtlQueue queueId)
 {
     gethSFR->MAC_RXQ_CTRL4.B.UFFQ  = queueId;
@@ -1606,4 +1871,51 @@ IFX_INLINE void IfxGeth_mac_setQueueVlanInsertion(Ifx_GETH *gethSFR, boolean ena
 }
 
 
+IFX_INLINE void IfxGeth_mac_setDescriptorVlanInsertion(Ifx_GETH *gethSFR, boolean enable)
+{
+    Ifx_GETH_MAC_VLAN_INCL vlanIncl;
+
+    vlanIncl.U               = 0;
+    vlanIncl.B.VLTI          = ((enable == 1) ? 1 : 0);
+    gethSFR->MAC_VLAN_INCL.U = vlanIncl.U; /* VLC = 0, CBTI = 0: no insertion by the register itself */
+}
+
+
+IFX_INLINE void IfxGeth_mac_setRxVlanStripping(Ifx_GETH *gethSFR, boolean enabled)
+{
+    Ifx_GETH_MAC_VLAN_TAG_CTRL vlanTagCtrl;
+
+    vlanTagCtrl.U                = gethSFR->MAC_VLAN_TAG_CTRL.U;
+    vlanTagCtrl.B.OB             = 0;                        /* no indirect access to the filters */
+    vlanTagCtrl.B.EVLS           = ((enabled == 1) ? 3 : 0); /* always strip */
+    vlanTagCtrl.B.EVLRXS         = ((enabled == 1) ? 1 : 0);
+    gethSFR->MAC_VLAN_TAG_CTRL.U = vlanTagCtrl.U;
+}
+
+
+IFX_INLINE void IfxGeth_mac_setVlanFiltering(Ifx_GETH *gethSFR, boolean enabled)
+{
+    gethSFR->MAC_PACKET_FILTER.B.VTFE = ((enabled == 1) ? 1 : 0);
+}
+
+
+IFX_INLINE uint32 IfxGeth_mac_getNumOfVlanFilters(Ifx_GETH *gethSFR)
+{
+    uint32 nrvf = gethSFR->MAC_HW_FEATURE3.B.NRVF;
+
+    /* 0: none, 1: 4, 2: 8, 3: 16, 4: 24, 5: 32 filters */
+    return (nrvf <= 3) ? ((nrvf == 0) ? 0 : (2U << nrvf)) : ((nrvf - 1) * 8U);
+}
+
+
+IFX_INLINE void IfxGeth_mac_setSubSecondIncrement(Ifx_GETH *gethSFR, uint8 increment)
+{
+    Ifx_GETH_MAC_SUB_SECOND_INCREMENT subSecondIncrement;
+
+    subSecondIncrement.U                = 0;
+    subSecondIncrement.B.SSINC          = increment;
+    gethSFR->MAC_SUB_SECOND_INCREMENT.U = subSecondIncrement.U;
+}
+
+
 #endif /* IFXGET_H */
@@ -0,0 +1,11 @@
+/* host build of the lwIP core: the standard types and a failing assert */
+#ifndef IFX_LWIP_CC_H
+#define IFX_LWIP_CC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LWIP_PLATFORM_DIAG(msg)   do { printf msg; } while (0)
+#define LWIP_PLATFORM_ASSERT(msg) do { printf("Assertion \"%s\" failed at line %d in %s\n", msg, __LINE__, __FILE__); abort(); } while (0)
+
+#endif /* IFX_LWIP_CC_H */
@@ -0,0 +1,29 @@
+/* host build of the lwIP core: IPv4 output on a netif without link layer, the TSO settings of Configurations/lwipopts.h */
+#ifndef LWIPOPTS_H
+#define LWIPOPTS_H
+
+#define NO_SYS                       1
+#define SYS_LIGHTWEIGHT_PROT         0
+#define LWIP_TIMERS                  0
+#define LWIP_NETCONN                 0
+#define LWIP_SOCKET                  0
+#define LWIP_IPV4                    1
+#define LWIP_IPV6                    0
+#define LWIP_ARP                     0
+#define LWIP_ICMP                    0
+#define LWIP_RAW                     0
+#define LWIP_UDP                     0
+#define LWIP_TCP                     0
+#define LWIP_IGMP                    0
+#define LWIP_DHCP                    0
+#define LWIP_STATS                   0
+#define LWIP_HAVE_LOOPIF             0
+#define LWIP_NETIF_LOOPBACK          0
+#define IP_REASSEMBLY                0
+#define IP_FRAG                      1
+#define LWIP_CHECKSUM_CTRL_PER_NETIF 1
+#define MEM_SIZE                     (64 * 1024)
+#define TCP_MSS                      1460
+#define TCP_TSO_MAX_SIZE             (4 * TCP_MSS)
+
+#endif /* LWIPOPTS_H */
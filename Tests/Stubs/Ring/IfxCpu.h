@@ -0,0 +1,41 @@
+/* host build of Ifx_PbufRing.h: the TriCore intrinsics it uses, on the GCC __atomic builtins */
+#ifndef IFXCPU_H
+#define IFXCPU_H
+
+#include <sched.h>
+#include "Ifx_Types.h"
+
+/* DSYNC: all memory accesses before are done before any after it */
+static inline void __dsync(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/* CMPSWAP.W: writes value if *address equals compare, returns the old *address. Every few calls
+ * the thread gives up the CPU first, so that the producers race for the same slots even on a
+ * host with a single CPU */
+static inline unsigned int __cmpAndSwap(unsigned int *address, unsigned int value, unsigned int compare)
+{
+    static __thread unsigned int calls;
+
+    if ((++calls % 16U) == 0)
+    {
+        sched_yield();
+    }
+
+    __atomic_compare_exchange_n(address, &compare, value, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return compare;
+}
+
+/* the host threads aren't interrupted */
+static inline boolean IfxCpu_disableInterrupts(void)
+{
+    return TRUE;
+}
+
+static inline void IfxCpu_restoreInterrupts(boolean enabled)
+{
+    (void)enabled;
+}
+
+#endif /* IFXCPU_H */
@@ -0,0 +1,17 @@
+/* host build of Ifx_PbufRing.h: the types and macros it takes from the iLLD */
+#ifndef IFX_TYPES_H
+#define IFX_TYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t      uint32;
+typedef unsigned char boolean;
+
+#define TRUE                         1
+#define FALSE                        0
+#define IFX_INLINE                   static inline
+#define IFX_ALIGN(n)                 __attribute__((aligned(n)))
+#define IFX_ASSERT(level, expr)      ((void)0)
+
+#endif /* IFX_TYPES_H */
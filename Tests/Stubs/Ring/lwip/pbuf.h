@@ -0,0 +1,11 @@
+/* host build of Ifx_PbufRing.h: the ring only passes pbuf pointers */
+#ifndef LWIP_HDR_PBUF_H
+#define LWIP_HDR_PBUF_H
+
+struct pbuf
+{
+    unsigned int producer;
+    unsigned int sequence;
+};
+
+#endif /* LWIP_HDR_PBUF_H */
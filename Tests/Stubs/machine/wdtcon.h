@@ -0,0 +1 @@
+/* host build: the TriCore compiler header is not needed, the intrinsics using it are not called */
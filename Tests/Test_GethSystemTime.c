@@ -0,0 +1,62 @@
+/**
+ * \file Test_GethSystemTime.c
+ * \brief Host test of the register values written by IfxGeth_mac_updateSystemTime()
+ *
+ * The function is linked from the iLLD and writes into a GETH register block in RAM.
+ */
+
+#include <stdio.h>
+#include "Geth/Std/IfxGeth.h"
+
+static Ifx_GETH geth;
+static int      failures = 0;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static void update(boolean subtract, uint32 seconds, uint32 nanoseconds)
+{
+    geth.MAC_TIMESTAMP_CONTROL.U              = 0;
+    geth.MAC_SYSTEM_TIME_SECONDS_UPDATE.U     = 0x5A5A5A5AU;
+    geth.MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.U = 0x5A5A5A5AU;
+    IfxGeth_mac_updateSystemTime(&geth, subtract, seconds, nanoseconds);
+    CHECK(geth.MAC_TIMESTAMP_CONTROL.B.TSUPDT == 1);
+}
+
+int main(void)
+{
+    /* add: the values as they are */
+    update(FALSE, 1, 500);
+    CHECK(geth.MAC_SYSTEM_TIME_SECONDS_UPDATE.U == 1);
+    CHECK(geth.MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.B.TSSS == 500);
+    CHECK(geth.MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.B.ADDSUB == 0);
+
+    /* subtract: two's complement of the seconds, 10^9 - nanoseconds */
+    update(TRUE, 2, 300);
+    CHECK(geth.MAC_SYSTEM_TIME_SECONDS_UPDATE.U == 0xFFFFFFFEU);
+    CHECK(geth.MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.B.TSSS == 999999700U);
+    CHECK(geth.MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.B.ADDSUB == 1);
+
+    /* subtract below a second, as the servo steps by -offset */
+    update(TRUE, 0, 250);
+    CHECK(geth.MAC_SYSTEM_TIME_SECONDS_UPDATE.U == 0);
+    CHECK(geth.MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.B.TSSS == 999999750U);
+    CHECK(geth.MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.B.ADDSUB == 1);
+
+    /* subtract whole seconds: 10^9 nanoseconds subtract nothing */
+    update(TRUE, 1, 0);
+    CHECK(geth.MAC_SYSTEM_TIME_SECONDS_UPDATE.U == 0xFFFFFFFFU);
+    CHECK(geth.MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.B.TSSS == 1000000000U);
+    CHECK(geth.MAC_SYSTEM_TIME_NANOSECONDS_UPDATE.B.ADDSUB == 1);
+
+    printf("Test_GethSystemTime: %s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}
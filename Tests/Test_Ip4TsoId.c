@@ -0,0 +1,160 @@
+/**
+ * \file Test_Ip4TsoId.c
+ * \brief Host test of the IP identifications of TCP segments a TSO netif cuts into frames
+ *
+ * ip4_output_if() is linked from the lwIP core. The netif numbers the frames of a segment
+ * from the ID in its header on, like tx_segment_tcp() of the port does.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "lwip/init.h"
+#include "lwip/ip4.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/prot/ip.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/tcp.h"
+
+#define MTU        1500U
+#define MAX_FRAMES 64U
+
+static struct netif testif;
+static u16_t        ids[MAX_FRAMES];    /* IDs of the frames on the wire, in sending order */
+static u32_t        numOfIds = 0;
+static int          failures = 0;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+/* records the IDs of the frames the datagram or TCP segment p goes out as */
+static err_t test_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *dest)
+{
+    const struct ip_hdr *iphdr  = (const struct ip_hdr *)p->payload;
+    u16_t                id     = lwip_ntohs(IPH_ID(iphdr));
+    u32_t                frames = 1;
+
+    LWIP_UNUSED_ARG(dest);
+
+    if ((p->tot_len > netif->mtu) && (IPH_PROTO(iphdr) == IP_PROTO_TCP))
+    {
+        /* one frame per MSS, numbered on from the ID in the header */
+        const struct tcp_hdr *tcphdr  = (const struct tcp_hdr *)((const u8_t *)iphdr + IPH_HL_BYTES(iphdr));
+        u16_t                 headers = (u16_t)(IPH_HL_BYTES(iphdr) + TCPH_HDRLEN_BYTES(tcphdr));
+        u16_t                 mss     = (u16_t)(netif->mtu - headers);
+
+        frames = (u32_t)(p->tot_len - headers + mss - 1) / mss;
+    }
+    else
+    {
+        CHECK(p->tot_len <= netif->mtu);
+    }
+
+    while ((frames-- > 0) && (numOfIds < MAX_FRAMES))
+    {
+        ids[numOfIds++] = id++;
+    }
+
+    return ERR_OK;
+}
+
+static err_t test_netif_init(struct netif *netif)
+{
+    netif->mtu    = MTU;
+    netif->flags  = NETIF_FLAG_TSO;
+    netif->output = test_output;
+    return ERR_OK;
+}
+
+/* sends a TCP segment with payload bytes behind a header of optlen option bytes */
+static void send_tcp(u16_t payload, u16_t optlen)
+{
+    struct pbuf    *p = pbuf_alloc(PBUF_IP, (u16_t)(TCP_HLEN + optlen + payload), PBUF_RAM);
+    struct tcp_hdr *tcphdr;
+    ip4_addr_t      src, dest;
+
+    CHECK(p != NULL);
+    memset(p->payload, 0, p->len);
+    tcphdr = (struct tcp_hdr *)p->payload;
+    TCPH_HDRLEN_FLAGS_SET(tcphdr, (TCP_HLEN + optlen) / 4, TCP_ACK);
+
+    IP4_ADDR(&src, 192, 168, 0, 1);
+    IP4_ADDR(&dest, 192, 168, 0, 2);
+    CHECK(ip4_output_if(p, &src, &dest, 64, 0, IP_PROTO_TCP, &testif) == ERR_OK);
+    pbuf_free(p);
+}
+
+/* sends a datagram of another protocol, fragmented by lwIP: all fragments share one ID */
+static void send_other(u16_t payload)
+{
+    struct pbuf *p = pbuf_alloc(PBUF_IP, payload, PBUF_RAM);
+    ip4_addr_t   src, dest;
+
+    CHECK(p != NULL);
+    memset(p->payload, 0, p->len);
+
+    IP4_ADDR(&src, 192, 168, 0, 1);
+    IP4_ADDR(&dest, 192, 168, 0, 2);
+    CHECK(ip4_output_if(p, &src, &dest, 64, 0, 253, &testif) == ERR_OK);
+    pbuf_free(p);
+}
+
+/* the frames sent since first count frames and have consecutive IDs */
+static void check_ids(u32_t first, u32_t count)
+{
+    u32_t i;
+
+    CHECK(numOfIds == (first + count));
+
+    for (i = first + 1; i < numOfIds; i++)
+    {
+        CHECK(ids[i] == (u16_t)(ids[first] + (i - first)));
+    }
+}
+
+int main(void)
+{
+    ip4_addr_t addr, netmask, gw;
+    u32_t      first;
+
+    lwip_init();
+    IP4_ADDR(&addr, 192, 168, 0, 1);
+    IP4_ADDR(&netmask, 255, 255, 255, 0);
+    IP4_ADDR(&gw, 0, 0, 0, 0);
+    CHECK(netif_add(&testif, &addr, &netmask, &gw, NULL, test_netif_init, netif_input) != NULL);
+    netif_set_up(&testif);
+
+    /* two super-segments of 4 MSS each back to back: 8 frames with 8 different IDs */
+    send_tcp(4 * 1460, 0);
+    send_tcp(4 * 1460, 0);
+    check_ids(0, 8);
+
+    /* a short last frame and a segment with options, whose MSS is smaller */
+    first = numOfIds;
+    send_tcp((3 * 1460) + 100, 0);
+    send_tcp(4 * 1460, 12);                 /* 1448 byte frames: 5 of them */
+    send_tcp(1000, 0);                      /* fits into one frame */
+    check_ids(first, 4 + 5 + 1);
+
+    /* a fragmented datagram takes a single ID (ip4_frag() sends its fragments via
+     * test_output(), each counted on its own): the next segment follows right after */
+    first = numOfIds;
+    send_other(3000);
+    CHECK(numOfIds == (first + 3));
+    CHECK((ids[first + 1] == ids[first]) && (ids[first + 2] == ids[first]));
+    send_tcp(2 * 1460, 0);
+    CHECK(numOfIds == (first + 5));
+    CHECK(ids[first + 3] == (u16_t)(ids[first] + 1));
+    CHECK(ids[first + 4] == (u16_t)(ids[first] + 2));
+
+    printf("Test_Ip4TsoId: %s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/**
+ * \file Test_PbufRing.c
+ * \brief Host test of the lock-free pbuf rings (Ifx_PbufRing.h)
+ *
+ * The cores are host threads, CMPSWAP and DSYNC are the GCC __atomic builtins (Stubs/Ring).
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "Ifx_PbufRing.h"
+
+#define NUM_OF_SLOTS     64U
+#define NUM_OF_FRAMES    1000000U   /* per producer */
+#define NUM_OF_PRODUCERS 4U
+#define MAX_BATCH        8U
+
+static Ifx_PbufRing ring IFX_PBUFRING_ALIGN;
+static struct pbuf *slots[NUM_OF_SLOTS] IFX_PBUFRING_ALIGN;
+static struct pbuf  frames[NUM_OF_PRODUCERS][NUM_OF_FRAMES];
+static int          failures = 0;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+/* small generator for the batch sizes, one state per thread */
+static uint32 next_random(uint32 *state)
+{
+    *state = (*state * 1103515245U) + 12345U;
+    return *state >> 16;
+}
+
+static void test_full_empty(void)
+{
+    struct pbuf *p[NUM_OF_SLOTS + 1];
+    uint32       i;
+
+    Ifx_PbufRing_init(&ring, slots, NUM_OF_SLOTS);
+    CHECK(Ifx_PbufRing_isEmpty(&ring));
+    CHECK(Ifx_PbufRing_get(&ring) == NULL);
+    CHECK(Ifx_PbufRing_getBatch(&ring, p, 4) == 0);
+
+    for (i = 0; i < NUM_OF_SLOTS; i++)
+    {
+        CHECK(Ifx_PbufRing_put(&ring, &frames[0][i]));
+    }
+
+    CHECK(Ifx_PbufRing_getCount(&ring) == NUM_OF_SLOTS);
+    CHECK(!Ifx_PbufRing_put(&ring, &frames[0][NUM_OF_SLOTS]));
+
+    /* a batch takes what is there */
+    CHECK(Ifx_PbufRing_getBatch(&ring, p, NUM_OF_SLOTS + 1) == NUM_OF_SLOTS);
+
+    for (i = 0; i < NUM_OF_SLOTS; i++)
+    {
+        CHECK(p[i] == &frames[0][i]);
+    }
+
+    CHECK(Ifx_PbufRing_isEmpty(&ring));
+
+    /* a batch is cut to the space left */
+    for (i = 0; i < NUM_OF_SLOTS + 1; i++)
+    {
+        p[i] = &frames[0][i];
+    }
+
+    CHECK(Ifx_PbufRing_putBatch(&ring, p, 10) == 10);
+    CHECK(Ifx_PbufRing_putBatch(&ring, &p[10], NUM_OF_SLOTS) == NUM_OF_SLOTS - 10);
+    CHECK(Ifx_PbufRing_putBatch(&ring, p, 1) == 0);
+    CHECK(Ifx_PbufRing_getCount(&ring) == NUM_OF_SLOTS);
+
+    /* and so is a multi-producer batch */
+    Ifx_PbufRing_init(&ring, slots, NUM_OF_SLOTS);
+    CHECK(Ifx_PbufRing_putBatchMp(&ring, p, NUM_OF_SLOTS - 3) == NUM_OF_SLOTS - 3);
+    CHECK(Ifx_PbufRing_putBatchMp(&ring, p, 10) == 3);
+    CHECK(Ifx_PbufRing_putBatchMp(&ring, p, 1) == 0);
+    CHECK(Ifx_PbufRing_getCount(&ring) == NUM_OF_SLOTS);
+}
+
+/* the indices run freely and are masked into the slots, also across the 32 bit overflow */
+static void test_wrap_around(boolean multiProducer)
+{
+    static struct pbuf *small[4] IFX_PBUFRING_ALIGN;
+    struct pbuf        *p[3];
+    uint32              sequence = 0;
+    uint32              expected = 0;
+    uint32              round;
+    uint32              i;
+
+    Ifx_PbufRing_init(&ring, small, 4);
+    ring.head    = 0xFFFFFFF0U;
+    ring.tail    = 0xFFFFFFF0U;
+    ring.reserve = 0xFFFFFFF0U;
+
+    for (round = 0; round < 100; round++)
+    {
+        for (i = 0; i < 3; i++)
+        {
+            p[i] = &frames[0][sequence++];
+        }
+
+        if (multiProducer)
+        {
+            CHECK(Ifx_PbufRing_putBatchMp(&ring, p, 3) == 3);
+        }
+        else
+        {
+            CHECK(Ifx_PbufRing_putBatch(&ring, p, 3) == 3);
+        }
+
+        CHECK(Ifx_PbufRing_getCount(&ring) == 3);
+        CHECK(Ifx_PbufRing_get(&ring) == &frames[0][expected++]);
+        CHECK(Ifx_PbufRing_getBatch(&ring, p, 3) == 2);
+        CHECK((p[0] == &frames[0][expected]) && (p[1] == &frames[0][expected + 1]));
+        expected += 2;
+        CHECK(Ifx_PbufRing_isEmpty(&ring));
+    }
+
+    CHECK(ring.head == (0xFFFFFFF0U + 300U));
+}
+
+typedef struct
+{
+    uint32  producer;
+    boolean multiProducer;
+} Producer;
+
+static void *producer_thread(void *arg)
+{
+    const Producer *producer = arg;
+    struct pbuf    *p[MAX_BATCH];
+    uint32          state    = producer->producer + 1;
+    uint32          sent     = 0;
+
+    while (sent < NUM_OF_FRAMES)
+    {
+        uint32 count = (next_random(&state) % MAX_BATCH) + 1;
+        uint32 i;
+
+        if (count > (NUM_OF_FRAMES - sent))
+        {
+            count = NUM_OF_FRAMES - sent;
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            p[i] = &frames[producer->producer][sent + i];
+        }
+
+        if (count == 1)
+        {
+            boolean put = producer->multiProducer ? Ifx_PbufRing_putMp(&ring, p[0]) : Ifx_PbufRing_put(&ring, p[0]);
+            count = put ? 1 : 0;
+        }
+        else
+        {
+            count = producer->multiProducer ? Ifx_PbufRing_putBatchMp(&ring, p, count) : Ifx_PbufRing_putBatch(&ring, p, count);
+        }
+
+        if (count == 0)
+        {
+            /* full: let the consumer run, the host may have fewer CPUs than threads */
+            sched_yield();
+        }
+
+        sent += count;
+    }
+
+    return NULL;
+}
+
+/* every frame arrives once and the frames of each producer arrive in order */
+static void test_stress(uint32 numOfProducers, boolean multiProducer)
+{
+    pthread_t    threads[NUM_OF_PRODUCERS];
+    Producer     producers[NUM_OF_PRODUCERS];
+    uint32       next[NUM_OF_PRODUCERS] = {0};
+    uint32       received               = 0;
+    uint32       state                  = 99;
+    struct pbuf *p[MAX_BATCH];
+    uint32       i;
+
+    Ifx_PbufRing_init(&ring, slots, NUM_OF_SLOTS);
+
+    for (i = 0; i < numOfProducers; i++)
+    {
+        uint32 n;
+
+        for (n = 0; n < NUM_OF_FRAMES; n++)
+        {
+            frames[i][n].producer = i;
+            frames[i][n].sequence = n;
+        }
+
+        producers[i].producer      = i;
+        producers[i].multiProducer = multiProducer;
+        pthread_create(&threads[i], NULL, producer_thread, &producers[i]);
+    }
+
+    while (received < (numOfProducers * NUM_OF_FRAMES))
+    {
+        uint32 count = Ifx_PbufRing_getBatch(&ring, p, (next_random(&state) % MAX_BATCH) + 1);
+
+        if (count == 0)
+        {
+            sched_yield();
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            uint32 producer = p[i]->producer;
+
+            if ((producer >= numOfProducers) || (p[i]->sequence != next[producer]))
+            {
+                CHECK(p[i]->sequence == next[producer]);
+                break;
+            }
+
+            next[producer]++;
+        }
+
+        if (i < count)
+        {
+            break;
+        }
+
+        received += count;
+    }
+
+    for (i = 0; i < numOfProducers; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    CHECK(received == (numOfProducers * NUM_OF_FRAMES));
+    CHECK(Ifx_PbufRing_isEmpty(&ring));
+}
+
+int main(void)
+{
+    /* a lost or doubled claim leaves the producers waiting for each other: end with SIGALRM */
+    alarm(60);
+
+    test_full_empty();
+    test_wrap_around(FALSE);
+    test_wrap_around(TRUE);
+    test_stress(1, FALSE);
+    test_stress(1, TRUE);
+    test_stress(NUM_OF_PRODUCERS, TRUE);
+
+    printf("Test_PbufRing: %s\n", (failures == 0) ? "passed" : "FAILED");
+
+    return (failures == 0) ? 0 : 1;
+}